@@ -144,6 +144,9 @@ Cell_ = {
 			local s = self.neighborhoods[name]
 			if type(s) == "function" then
 				return s(self)
+			elseif getmetatable(s) == metaTableNeighborhoodIndex_ then
+				s = s:get(self)
+				self.neighborhoods[name] = s
 			end
 
 			return s
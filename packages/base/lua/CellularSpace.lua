@@ -26,6 +26,75 @@ local gis = getPackage("gis")
 
 TeCoord.type_ = "Coord" -- We now use Coord only internally, but it is necessary to set its type.
 
+-- Return the Cell in (x, y) without checking the arguments. Regular CellularSpaces
+-- keep their cells in a dense grid (x-major, as they are created), which gives the
+-- position of the Cell directly in the array of cells. Other CellularSpaces use a
+-- lazily built index.
+local function cellAt(self, x, y)
+	local grid = self.grid_
+	if grid then
+		local col = x - grid.xMin
+		local lin = y - grid.yMin
+
+		if col >= 0 and col < grid.xdim and lin >= 0 and lin < grid.ydim then
+			local cell = self.cells[col * grid.ydim + lin + 1]
+
+			if cell and cell.x == x and cell.y == y then
+				return cell
+			end
+		end
+	end
+
+	if not self.index_xy_ then
+		local index_xy = {}
+
+		forEachCell(self, function(cell)
+			if not index_xy[cell.x] then
+				index_xy[cell.x] = {}
+			end
+
+			index_xy[cell.x][cell.y] = cell
+		end)
+
+		self.index_xy_ = index_xy
+	end
+
+	if self.index_xy_[x] then
+		return self.index_xy_[x][y]
+	end
+end
+
+-- Return the past of the Cell in a given position when the CellularSpace is synchronized
+-- in columns. It does not store any value, but reads and writes the position of the Cell
+-- in the column of each attribute.
+local function columnarPast(columns, position)
+	return setmetatable({}, {
+		__index = function(_, idx)
+			local column = columns[idx]
+			if column then return column[position] end
+		end,
+		__newindex = function(_, idx, value)
+			local column = columns[idx]
+			if not column then
+				column = {}
+				columns[idx] = column
+			end
+
+			column[position] = value
+		end,
+		__pairs = function(past)
+			return function(_, idx)
+				local name, column = next(columns, idx)
+				while name ~= nil and column[position] == nil do
+					name, column = next(columns, name)
+				end
+
+				if name ~= nil then return name, column[position] end
+			end, past, nil
+		end
+	})
+end
+
 local function separatorCheck(data)
 	local header1 = File(tostring(data.file))
 	local header2 = File(tostring(data.file))
@@ -43,6 +112,39 @@ local function separatorCheck(data)
 	header3:close()
 end
 
+-- Load the Neighborhoods of a file natively, building or mapping its binary cache, and
+-- share them among all the Cells. It returns false when the file must be loaded by the
+-- Lua loaders below, which report the errors found in the file.
+local function loadNeighborhoodIndex(self, data, format, values)
+	local cells = self.cells
+	local ids = {}
+
+	for i = 1, #cells do
+		ids[i] = cells[i]:getId()
+	end
+
+	local first, neighbors, weights = cpp_neighborhoodload(tostring(data.file), format, values or 1, ids)
+
+	if not first then return false end
+
+	local index = {
+		cells = cells,
+		first = first,
+		neighbors = neighbors,
+		weights = weights,
+		edgeWeights = true
+	}
+
+	setmetatable(index, metaTableNeighborhoodIndex_)
+
+	forEachCell(self, function(cell)
+		cell.neighborhoods[data.name] = index
+	end)
+
+	data.file:close()
+	return true
+end
+
 local function loadNeighborhoodGAL(self, data)
 	local file = data.file
 	local lineTest = file:readLine(" ")
@@ -62,6 +164,8 @@ local function loadNeighborhoodGAL(self, data)
 		end
 	end
 
+	if loadNeighborhoodIndex(self, data, "gal") then return end
+
 	forEachCell(self, function(cell)
 		cell:addNeighborhood(Neighborhood{}, data.name)
 	end)
@@ -128,6 +232,8 @@ local function loadNeighborhoodGPM(self, data)
 		values = 1
 	end
 
+	if loadNeighborhoodIndex(self, data, "gpm", values) then return end
+
 	forEachCell(self, function(cell)
 		cell:addNeighborhood(Neighborhood{}, data.name)
 	end)
@@ -188,6 +294,8 @@ local function loadNeighborhoodGWT(self, data)
 		end
 	end
 
+	if loadNeighborhoodIndex(self, data, "gwt") then return end
+
 	forEachCell(self, function(cell)
 		cell:addNeighborhood(Neighborhood{}, data.name)
 	end)
@@ -230,6 +338,70 @@ local function getCoordCoupling(_, data)
 	end
 end
 
+-- Return the offsets {dx1, dy1, dx2, dy2, ...} of the strategies that depend only on
+-- the relative position of the Cells, in the same order the Lua strategies visit them,
+-- and whether the weights are averaged by the number of neighbors.
+local function getStencil(data)
+	local offsets = {}
+	local average = true
+
+	local function add(col, lin)
+		table.insert(offsets, col)
+		table.insert(offsets, lin)
+	end
+
+	if data.strategy == "mxn" then
+		local m = math.floor(data.m / 2)
+		local n = math.floor(data.n / 2)
+
+		for lin = -n, n do
+			for col = -m, m do
+				add(col, lin)
+			end
+		end
+
+		average = false
+	else
+		for lin = -1, 1 do
+			for col = -1, 1 do
+				local center = lin == 0 and col == 0
+
+				if (data.strategy == "moore" and (data.self or not center))
+				or (data.strategy == "vonneumann" and (((lin == 0 or col == 0) and not center) or (data.self and center)))
+				or (data.strategy == "diagonal" and ((lin ~= 0 and col ~= 0) or (data.self and center))) then
+					add(col, lin)
+				end
+			end
+		end
+	end
+
+	return offsets, average
+end
+
+-- Build the Neighborhoods of all the Cells of a regular CellularSpace natively. It returns
+-- nil when the CellularSpace is not a complete grid.
+local function getNeighborhoodIndex(cs, data)
+	local grid = cs.grid_
+
+	if not grid or #cs.cells ~= grid.xdim * grid.ydim then return end
+
+	local offsets, average = getStencil(data)
+	local first, neighbors, weights = cs.cObj_:createStencilNeighborhood(offsets, data.wrap, average)
+
+	if not first then return end
+
+	local index = {
+		cells = cs.cells,
+		grid = grid,
+		first = first,
+		neighbors = neighbors,
+		weights = weights
+	}
+
+	setmetatable(index, metaTableNeighborhoodIndex_)
+	return index
+end
+
 local function getDiagonalNeighborhood(cs, data)
 	return function(cell)
 		local neigh = Neighborhood()
@@ -241,11 +413,11 @@ local function getDiagonalNeighborhood(cs, data)
 				if (lin ~= 0 and col ~= 0) or (data.self and lin == 0 and col == 0) then
 					local index
 					if data.wrap then
-						index = cs:get(
+						index = cellAt(cs,
 							((cell.x + col) - cs.xMin) % (cs.xMax - cs.xMin + 1) + cs.xMin,
 							((cell.y + lin) - cs.yMin) % (cs.yMax - cs.yMin + 1) + cs.yMin)
 					else
-						index = cs:get(cell.x + col, cell.y + lin)
+						index = cellAt(cs, cell.x + col, cell.y + lin)
 					end
 					if index ~= nil then
 						table.insert(indexes, index)
@@ -293,11 +465,11 @@ local function getMooreNeighborhood(cs, data)
 				if data.self or (lin ~= col or col ~= 0) then
 					local index
 					if data.wrap then
-						index = cs:get(
+						index = cellAt(cs,
 							((cell.x + col) - cs.xMin) % (cs.xMax - cs.xMin + 1) + cs.xMin,
 							((cell.y + lin) - cs.yMin) % (cs.yMax - cs.yMin + 1) + cs.yMin)
 					else
-						index = cs:get(cell.x + col, cell.y + lin)
+						index = cellAt(cs, cell.x + col, cell.y + lin)
 					end
 					if index ~= nil then
 						table.insert(indexes, index)
@@ -332,11 +504,11 @@ local function getMxNNeighborhood(_, data)
 				local neighCell
 
 				if data.wrap then
-					neighCell = cs:get(
+					neighCell = cellAt(cs,
 						((cell.x + col) - cs.xMin) % (cs.xMax - cs.xMin + 1) + cs.xMin,
 						((cell.y + lin) - cs.yMin) % (cs.yMax - cs.yMin + 1) + cs.yMin)
 				else
-					neighCell = cs:get(cell.x + col, cell.y + lin)
+					neighCell = cellAt(cs, cell.x + col, cell.y + lin)
 				end
 
 				if neighCell then
@@ -362,11 +534,11 @@ local function getVonNeumannNeighborhood(cs, data)
 				if ((lin == 0 or col == 0) and lin ~= col) or (data.self and lin == 0 and col == 0) then
 					local index
 					if data.wrap then
-						index = cs:get(
+						index = cellAt(cs,
 							((cell.x + col) - cs.xMin) % (cs.xMax - cs.xMin + 1) + cs.xMin,
 							((cell.y + lin) - cs.yMin) % (cs.yMax - cs.yMin + 1) + cs.yMin)
 					else
-						index = cs:get(cell.x + col, cell.y + lin)
+						index = cellAt(cs, cell.x + col, cell.y + lin)
 					end
 
 					if index ~= nil then
@@ -394,6 +566,10 @@ local function checkCsv(self)
 	defaultTableValue(self, "sep", ",")
 end
 
+local function checkColumnar(self)
+	optionalTableArgument(self, "time", "number")
+end
+
 local function checkPGM(self)
 	defaultTableValue(self, "sep", " ")
 	local _, name = self.file:split()
@@ -459,6 +635,30 @@ local function checkProject(self)
 	end
 end
 
+-- Add a Cell read from a file. It does the same as CellularSpace:add(), but
+-- duplicated (x, y) are checked using positions instead of CellularSpace:get(),
+-- which would rebuild the index of the CellularSpace for each new Cell.
+local function addFileCell(self, cell, positions)
+	local column = positions[cell.x]
+
+	if not column then
+		column = {}
+		positions[cell.x] = column
+	end
+
+	verify(not column[cell.y], "Cell ("..cell.x..", "..cell.y..") already belongs to the CellularSpace.")
+	column[cell.y] = true
+
+	cell.parent = self
+	self.cObj_:addCell(cell.x, cell.y, cell.cObj_)
+	self.cells[#self.cells + 1] = cell
+
+	if cell.x < self.xMin then self.xMin = cell.x end
+	if cell.x > self.xMax then self.xMax = cell.x end
+	if cell.y < self.yMin then self.yMin = cell.y end
+	if cell.y > self.yMax then self.yMax = cell.y end
+end
+
 local function loadCsv(self)
 	self.yMin = math.huge
 	self.xMin = math.huge
@@ -466,25 +666,77 @@ local function loadCsv(self)
 	self.yMax = -math.huge
 
 	self.cells = {}
+	self.index_id_ = nil
+	self.index_xy_ = nil
 	self.cObj_:clear()
-	local file = self.file
-	local data = file:read(self.sep)
-	local columns = data:columns()
+
+	local data = self.file:read(self.sep)
+	local names = {}
+	local columns = {}
+
+	for idx, values in pairs(data.data_) do
+		table.insert(names, idx)
+		table.insert(columns, values)
+	end
+
+	local positions = {}
 
 	for i = 1, #data do
 		local attributes = {id = tostring(i)}
-		local row = data[i]
 
-		forEachElement(columns, function(idx)
-			attributes[idx] = row[idx]
-		end)
+		for j = 1, #names do
+			attributes[names[j]] = columns[j][i]
+		end
 
-		local cell = Cell(attributes)
-		self:add(cell)
-		self.cObj_:addCell(cell.x, cell.y, cell.cObj_)
+		addFileCell(self, Cell(attributes), positions)
 	end
 end
 
+local function loadColumnar(self)
+	local data, merror = cpp_columnarload(tostring(self.file), self.time)
+	if not data then customError(merror) end
+
+	self.yMin = math.huge
+	self.xMin = math.huge
+	self.xMax = -math.huge
+	self.yMax = -math.huge
+
+	self.cells = {}
+	self.index_id_ = nil
+	self.index_xy_ = nil
+	self.cObj_:clear()
+
+	local positions = {}
+
+	for i = 1, #data.id do
+		local attributes = {
+			id = data.id[i],
+			x = math.tointeger(data.x[i]) or data.x[i],
+			y = math.tointeger(data.y[i]) or data.y[i]
+		}
+
+		for idx, values in pairs(data.columns) do
+			attributes[idx] = values[i]
+		end
+
+		addFileCell(self, Cell(attributes), positions)
+	end
+end
+
+local function columnarAttributes(self)
+	local attributes = {}
+
+	forEachOrderedElement(self.cells[1], function(idx, _, mtype)
+		if not belong(mtype, {"number", "string", "boolean"}) then return end
+
+		if not belong(idx, {"x", "y", "id"}) and string.sub(idx, -1, -1) ~= "_" then
+			table.insert(attributes, idx)
+		end
+	end)
+
+	return attributes
+end
+
 local function loadPGM(self)
 	local i = 0
 	local j = 0
@@ -762,7 +1014,10 @@ local function loadVirtual(self)
 	self.yMax = self.ydim - 1
 
 	self.cells = {}
+	self.index_xy_ = nil
+	self.grid_ = {xMin = 0, yMin = 0, xdim = self.xdim, ydim = self.ydim}
 	self.cObj_:clear()
+	self.cObj_:setGrid(0, 0, self.xdim, self.ydim)
 	local cellIdCounter = 1
 	for row = 1, self.xdim do
 		for col = 1, self.ydim do
@@ -822,6 +1077,13 @@ registerCellularSpaceDriver{
 	check = checkPGM
 }
 
+registerCellularSpaceDriver{
+	source = "tmc",
+	optional = "time",
+	load = loadColumnar,
+	check = checkColumnar
+}
+
 registerCellularSpaceDriver{
 	source = "proj",
 	extension = false,
@@ -999,6 +1261,8 @@ CellularSpace_ = {
 		defaultTableValue(data, "strategy", "moore")
 		defaultTableValue(data, "inmemory", true)
 
+		local stencil = true
+
 		switch(data, "strategy"):caseof{
 			diagonal = function()
 				verifyUnnecessaryArguments(data, {"self", "wrap", "name", "strategy", "inmemory"})
@@ -1014,6 +1278,7 @@ CellularSpace_ = {
 				mandatoryTableArgument(data, "filter", "function")
 				defaultTableValue(data, "weight", function() return 1 end)
 
+				stencil = false
 				data.func = getFunctionNeighborhood
 			end,
 			moore = function()
@@ -1027,6 +1292,9 @@ CellularSpace_ = {
 			mxn = function()
 				verifyUnnecessaryArguments(data, {"filter", "weight", "wrap", "name", "strategy", "m", "n", "target", "inmemory"})
 
+				-- user-defined filters and weights and other targets need the Lua strategy
+				stencil = data.filter == nil and data.weight == nil and (data.target == nil or data.target == self)
+
 				defaultTableValue(data, "filter", function() return true end)
 				defaultTableValue(data, "weight", function() return 1 end)
 				defaultTableValue(data, "target", self)
@@ -1062,13 +1330,19 @@ CellularSpace_ = {
 
 				mandatoryTableArgument(data, "target", "CellularSpace")
 
+				stencil = false
 				data.func = getCoordCoupling
 			end
 		}
 
 		local func = data.func(self, data)
+		local index = stencil and data.inmemory and getNeighborhoodIndex(self, data)
 
-		if data.inmemory then
+		if index then
+			forEachCell(self, function(cell)
+				cell.neighborhoods[data.name] = index
+			end)
+		elseif data.inmemory then
 			forEachCell(self, function(cell)
 				cell:addNeighborhood(func(cell), data.name)
 			end)
@@ -1174,23 +1448,7 @@ CellularSpace_ = {
 		mandatoryArgument(2, "number", yIndex)
 		integerArgument(2, yIndex)
 
-		if not self.index_xy_ then
-			local index_xy = {}
-
-			forEachCell(self, function(cell)
-				if not index_xy[cell.x] then
-					index_xy[cell.x] = {}
-				end
-
-				index_xy[cell.x][cell.y] = cell
-			end)
-
-			self.index_xy_ = index_xy
-		end
-
-		if self.index_xy_[xIndex] then
-			return self.index_xy_[xIndex][yIndex]
-		end
+		return cellAt(self, xIndex, yIndex)
 	end,
 	--- Load the CellularSpace from the database. TerraME automatically executes this function when
 	-- the CellularSpace is created, but one can execute this to load the attributes again, erasing
@@ -1201,7 +1459,9 @@ CellularSpace_ = {
 		customError("Load function was not implemented.")
 	end,
 	--- Load a Neighborhood stored in an external source. Each Cell receives its own set of
-	-- neighbors.
+	-- neighbors. The first time a file is loaded, its Neighborhoods are stored in a binary
+	-- cache in the user's cache directory. Later loads of the same file for the same Cells
+	-- map this cache into memory instead of parsing the file again.
 	-- @arg data.file A File or a string with the location of the Neighborhood
 	-- file to be loaded.
 	-- @arg data.check A boolean value indicating whether this function should match the
@@ -1311,8 +1571,13 @@ CellularSpace_ = {
 	sample = function(self)
 		return self.cells[Random():integer(1, #self)]
 	end,
-	--- Save the attributes of a CellularSpace into gis::Project or a tif file.
+	--- Save the attributes of a CellularSpace into gis::Project, a tif file, or a columnar
+	-- time series file.
 	-- @arg newLayerNameOrFile Name of the gis::Layer or a tif file to store the saved attributes.
+	-- It can also be a file with extension '.tmc', which works with any CellularSpace. The
+	-- ids and coordinates of the Cells are stored only in the first call, and each call appends
+	-- the selected attributes as compressed columns. Such files can be loaded by CellularSpace
+	-- and DataFrame using argument time.
 	-- If the original data comes from a shapefile layer, it will create another shapefile using
 	-- the name of the new layer as file name and will save it in the same directory where the
 	-- original shapefile is stored. If the data comes from a PostGIS database, it
@@ -1326,6 +1591,10 @@ CellularSpace_ = {
 	-- The attribute value saved will have the same type of the loaded tif files, it means, if
 	-- the tif is 8 bits the new tif will be 8 bits as well.
 	-- When saving a single attribute, you can use a string "attribute" instead of a table {"attribute"}.
+	-- When saving a '.tmc' file, the default value is all the number, string, and boolean
+	-- attributes of the Cells.
+	-- @arg time The time of the saved values. It is only used by '.tmc' files. The default value
+	-- is the number of times already stored in the file plus one.
 	-- @usage -- DONTRUN
 	-- import("gis")
 	--
@@ -1345,7 +1614,11 @@ CellularSpace_ = {
 	-- end)
 	--
 	-- cs:save("myamazonia", "distweight")
-	save = function(self, newLayerNameOrFile, attrNames)
+	save = function(self, newLayerNameOrFile, attrNames, time)
+		if type(newLayerNameOrFile) == "string" and string.endswith(newLayerNameOrFile, ".tmc") then
+			newLayerNameOrFile = File(newLayerNameOrFile)
+		end
+
 		if (attrNames ~= nil) and (attrNames ~= "") then
 			if type(attrNames) == "string" then
 				attrNames = {attrNames}
@@ -1360,7 +1633,17 @@ CellularSpace_ = {
 			end
 		end
 
-		if self.project then
+		if type(newLayerNameOrFile) == "File" and newLayerNameOrFile:extension() == "tmc" then
+			optionalArgument(3, "number", time)
+			verify(#self > 0, "It is not possible to save a CellularSpace without Cells.")
+
+			if (attrNames == nil) or (attrNames == "") then
+				attrNames = columnarAttributes(self)
+			end
+
+			local result, merror = cpp_columnarsave(tostring(newLayerNameOrFile), self.cells, attrNames, time)
+			if not result then customError(merror) end
+		elseif self.project then
 			local newLayerName = newLayerNameOrFile
 			mandatoryArgument(1, "string", newLayerName)
 
@@ -1497,6 +1780,11 @@ CellularSpace_ = {
 	-- empty, TerraME synchronizes every attribute of the Cells but the (x, y) coordinates.
 	-- If the CellularSpace has an instance and it implements Cell:on_synchronize() then it
 	-- will be called for each Cell.
+	-- @arg columnar A boolean value indicating whether the past values should be stored in
+	-- one column per attribute instead of one new table per Cell. The columns are allocated
+	-- only once and reused in the next synchronizations, and the past of each Cell reads its
+	-- position in them. It is recommended for large CellularSpaces synchronized at every
+	-- time step. The default value is false.
 	-- @usage cell = Cell{
 	--     forest = Random{min = 0, max = 1}
 	-- }
@@ -1510,7 +1798,10 @@ CellularSpace_ = {
 	-- c = cs:sample()
 	-- print(c.forest)
 	-- print(c.past.forest)
-	synchronize = function(self, values)
+	--
+	-- cs:synchronize("forest", true)
+	-- print(c.past.forest)
+	synchronize = function(self, values, columnar)
 		if values == nil then
 			values = {}
 			local cell = self.cells[1]
@@ -1527,6 +1818,54 @@ CellularSpace_ = {
 			incompatibleTypeError(1, "string, table or nil", values)
 		end
 
+		optionalArgument(2, "boolean", columnar)
+
+		if columnar then
+			local synchronized = {}
+
+			for _, v in pairs(values) do
+				if type(v) == "string" then
+					synchronized[v] = true
+				else
+					customError("Argument 'values' should contain only strings.")
+				end
+			end
+
+			local past = self.past_
+			if not past then
+				past = {columns = {}, cells = {}}
+				self.past_ = past
+			end
+
+			local columns = past.columns
+			for name in pairs(columns) do
+				if not synchronized[name] then
+					columns[name] = nil
+				end
+			end
+
+			self.cObj_:synchronizeColumns(self.cells, values, columns)
+
+			local pastCells = past.cells
+			forEachCell(self, function(cell, i)
+				local cellPast = pastCells[i]
+				if not cellPast then
+					cellPast = columnarPast(columns, i)
+					pastCells[i] = cellPast
+				end
+
+				if rawget(cell, "past") ~= cellPast then
+					cell.past = cellPast
+				end
+
+				if type(cell.on_synchronize) == "function" then
+					cell:on_synchronize()
+				end
+			end)
+
+			return
+		end
+
 		local s = "return function(cell)\n"
 		s = s.."cell.past = {"
 
@@ -1616,6 +1955,8 @@ metaTableCellularSpace_ = {
 -- load from a database. The default value is equal to xdim.
 -- @arg data.file A string with a file name (if it is stored in the current directory), or the complete
 -- path to a given file.
+-- @arg data.time A number with the time to be loaded from a '.tmc' file created by
+-- CellularSpace:save(). The default value is the last saved time.
 -- @arg data.directory A directory. It opens a set of tif files using the file names as attribute names.
 -- The directory must contains at least two tif files and they must have the same number of columns and rows.
 -- @arg data.source A string with the name of the data source. It tries to infer the data source
@@ -1639,6 +1980,8 @@ metaTableCellularSpace_ = {
 -- to the attributes (row, col) from the shapefile. & file & source, as, xy, missing, zero, geometry, ... \
 -- "tif" & Load a tif file. The name of the attributes will be b0, b1, etc., according to the number of
 -- bands in the file. & file & as, ... \
+-- "tmc" & Load a columnar time series file created by CellularSpace:save(). The Cells will have
+-- the attributes saved in the selected time. & file & time, as, ... \
 -- "virtual" & Create a rectangular CellularSpace from scratch. Cells will be instantiated with
 -- only two attributes, x and y, starting from (0, 0). & xdim & ydim, as, geometry, ...
 -- @output cells A vector of Cells pointed by the CellularSpace.
@@ -57,6 +57,32 @@ local colors = {
 	darkPurple   = { 85,  26, 139}
 }
 
+-- times of the rows kept by Charts with capacity
+local updatedTimes = setmetatable({}, {__mode = "k"})
+
+local function discardOldValues(self, modelTime)
+	local times = updatedTimes[self]
+
+	if not times then
+		times = {first = 1, last = 0}
+		updatedTimes[self] = times
+	end
+
+	times.last = times.last + 1
+	times[times.last] = modelTime
+
+	while times.last - times.first >= self.capacity do
+		local old = times[times.first]
+		times[times.first] = nil
+		times.first = times.first + 1
+
+		self.values.rows_[old] = nil
+		forEachElement(self.values.data_, function(_, column)
+			column[old] = nil
+		end)
+	end
+end
+
 local function chartFromData(attrTab)
 	local columns = attrTab.target:columns()
 	local rows = attrTab.target:rows()
@@ -177,8 +203,13 @@ Chart_ = {
 			values[key] = self.target[key]
 		end)
 
+		local newTime = not self.values:rows()[modelTime]
 		self.values[modelTime] = values
 
+		if self.capacity > 0 and newTime then
+			discardOldValues(self, modelTime)
+		end
+
 		self.target:notify(modelTime)
 	end,
 	--- Clear the Chart.
@@ -262,6 +293,12 @@ metaTableChart_ = {__index = Chart_}
 -- "lines", "dots", "none", "steps", and "sticks". The default value is "lines" for all lines.
 -- @arg attrTab.xAxis Name of the attribute to be used as x axis (instead of time). In this case,
 -- notify() will not need its single argument for plotting Charts.
+-- @arg attrTab.capacity The maximum number of values of each line kept in memory. When the
+-- Chart receives more values, it draws only the most recent ones and discards the oldest.
+-- The default value is zero, meaning that all the values are kept.
+-- @arg attrTab.resolution The maximum number of points drawn for each line when the x axis is
+-- time. When there are more values, only the minimum and the maximum values of consecutive
+-- intervals are drawn, keeping the peaks of the lines. The default value is 2000.
 -- @usage cs = CellularSpace{
 --     xdim = 10,
 --     value1 = 5,
@@ -338,7 +375,7 @@ function Chart(attrTab)
 	verifyUnnecessaryArguments(attrTab, {
 		"target", "select", "yLabel", "xLabel",
 		"title", "label", "pen", "color", "xAxis", "value",
-		"width", "symbol", "style", "size"
+		"width", "symbol", "style", "size", "capacity", "resolution"
 	})
 
 	if type(attrTab.target) == "Map" then
@@ -374,6 +411,12 @@ function Chart(attrTab)
 	end
 
 	defaultTableValue(attrTab, "yLabel", "")
+	defaultTableValue(attrTab, "capacity", 0)
+	integerTableArgument(attrTab, "capacity")
+	positiveTableArgument(attrTab, "capacity", true)
+	defaultTableValue(attrTab, "resolution", 2000)
+	integerTableArgument(attrTab, "resolution")
+	positiveTableArgument(attrTab, "resolution")
 
 	if isModel(attrTab.title) then
 		attrTab.title = attrTab.title:title()
@@ -856,6 +899,7 @@ function Chart(attrTab)
 
 	local chart = TeChart()
 	chart:setObserver(obs)
+	chart:setBuffer(attrTab.capacity, attrTab.resolution)
 
 	attrTab.cObj_ = chart
 	attrTab.id = id
@@ -22,6 +22,41 @@
 --
 -------------------------------------------------------------------------------------------
 
+-- Columns whose rows go from one to n and whose values are all numbers, integers,
+-- booleans, or strings are stored natively, in contiguous typed arrays. The other
+-- columns are Lua tables.
+local function isNative(values)
+	return type(values) == "userdata"
+end
+
+local function nativeColumn(values)
+	if isNative(values) then return values end
+
+	return cpp_dataframecolumn(values) or values
+end
+
+local function toTable(values)
+	if isNative(values) then
+		return values:totable()
+	end
+
+	return values
+end
+
+-- store a value, converting the native column into a Lua table when it cannot keep the value
+local function setValue(data, column, row, value)
+	local values = data[column]
+
+	if isNative(values) then
+		if values:set(row, value) then return end
+
+		values = values:totable()
+		data[column] = values
+	end
+
+	values[row] = value
+end
+
 local metaTableDataFrameRow_ = {
 	__newindex = function(self, idx, value)
 		if idx == nil then
@@ -31,7 +66,7 @@ local metaTableDataFrameRow_ = {
 			self.parent_.columns_[idx] = true
 		end
 
-		self.data_[idx][self.pos_] = value
+		setValue(self.data_, idx, self.pos_, value)
 	end,
 	__index = function(self, idx)
 		if not self.data_[idx] then
@@ -57,16 +92,19 @@ local metaTableDataFrameRow_ = {
 local metaTableDataFrameColumn_ = {
 	__newindex = function(self, idx, value)
 		self.parent_.rows_[idx] = true
-		self.data_[self.pos_][idx] = value
+		setValue(self.data_, self.pos_, idx, value)
 	end,
 	__index = function(self, idx)
 		return self.data_[self.pos_][idx]
 	end,
 	__tostring = function(self)
-		return vardump(self.data_[self.pos_])
+		return vardump(toTable(self.data_[self.pos_]))
 	end,
 	__len = function(self)
-		return getn(self.data_[self.pos_])
+		local values = self.data_[self.pos_]
+		if isNative(values) then return #values end
+
+		return getn(values)
 	end
 }
 
@@ -93,7 +131,7 @@ local function add(self, row, idx)
 				self.data_[midx] = {}
 			end
 
-			self.data_[midx][idx] = value
+			setValue(self.data_, midx, idx, value)
 		end)
 	else
 		self.rows_[idx] = true
@@ -103,7 +141,7 @@ local function add(self, row, idx)
 				self.data_[midx] = {}
 			end
 
-			self.data_[midx][idx] = value
+			setValue(self.data_, midx, idx, value)
 		end)
 	end
 end
@@ -126,7 +164,11 @@ end
 local function remove(self, idx)
 	self.rows_[idx] = nil
 	forEachElement(self.data_, function(_, value)
-		table.remove(value, idx)
+		if not isNative(value) then
+			table.remove(value, idx)
+		elseif idx <= #value then
+			value:remove(idx)
+		end
 	end)
 end
 
@@ -150,7 +192,12 @@ local function save(self, filename)
 	if ext == "csv" then
 		filename:write(self)
 	elseif ext == "lua" then
-		local stbl = "return"..vardump(self.data_)
+		local data = {}
+		forEachElement(self.data_, function(idx, value)
+			data[idx] = toTable(value)
+		end)
+
+		local stbl = "return"..vardump(data)
 		filename:writeLine(stbl)
 		filename:close()
 	else
@@ -174,12 +221,183 @@ local function rows(self)
 	return self.rows_
 end
 
+local function getColumn(self, column, position)
+	mandatoryArgument(position, "string", column)
+
+	local values = self.data_[column]
+	if values == nil then
+		customError("Column '"..column.."' does not exist in the DataFrame.")
+	end
+
+	return values
+end
+
+-- return the sum and the quantity of values of a column, or two tables with
+-- the sum and the quantity of values of each group
+local function aggregate(self, column, by)
+	local values = getColumn(self, column, 1)
+	local groups
+
+	if by ~= nil then
+		groups = getColumn(self, by, 2)
+	end
+
+	if isNative(values) and belong(values:type(), {"number", "integer"}) then
+		if groups == nil then
+			return values:sum(), #values
+		elseif isNative(groups) and #groups == #values then
+			return values:sum(groups)
+		end
+	end
+
+	local sums = 0
+	local counts = 0
+
+	if groups then
+		sums = {}
+		counts = {}
+	end
+
+	for row, value in pairs(toTable(values)) do
+		if type(value) ~= "number" then
+			customError("Column '"..column.."' should contain only numbers, got "..type(value)..".")
+		end
+
+		if groups then
+			local group = groups[row]
+			if group ~= nil then
+				sums[group] = (sums[group] or 0) + value
+				counts[group] = (counts[group] or 0) + 1
+			end
+		else
+			sums = sums + value
+			counts = counts + 1
+		end
+	end
+
+	return sums, counts
+end
+
+--- Return the sum of the values of a column. Columns stored natively are summed in C++.
+-- @arg column A string with the name of the column.
+-- @arg by An optional string with the name of another column. When used, this function
+-- returns a named table with the sum of each of its values.
+-- @usage df = DataFrame{
+--     cover = {"forest", "forest", "pasture"},
+--     area = {10, 20, 5}
+-- }
+--
+-- print(df:sum("area")) -- 35
+-- print(df:sum("area", "cover").forest) -- 30
+local function sum(self, column, by)
+	optionalArgument(2, "string", by)
+
+	local sums = aggregate(self, column, by)
+	return sums
+end
+
+--- Return the mean of the values of a column. Columns stored natively are summed in C++.
+-- @arg column A string with the name of the column.
+-- @arg by An optional string with the name of another column. When used, this function
+-- returns a named table with the mean of each of its values.
+-- @usage df = DataFrame{
+--     cover = {"forest", "forest", "pasture"},
+--     area = {10, 20, 5}
+-- }
+--
+-- print(df:mean("area")) -- 11.666666666667
+-- print(df:mean("area", "cover").forest) -- 15
+local function mean(self, column, by)
+	optionalArgument(2, "string", by)
+
+	local sums, counts = aggregate(self, column, by)
+
+	if by == nil then
+		return sums / counts
+	end
+
+	local result = {}
+	forEachElement(sums, function(group, value)
+		result[group] = value / counts[group]
+	end)
+
+	return result
+end
+
+--- Return a new DataFrame with the rows whose values of a column are equal to a given value.
+-- The rows of the new DataFrame are numbered from one, in the same order of the original one.
+-- @arg column A string with the name of the column.
+-- @arg value The value to be selected. It can also be a function that gets the value of the
+-- column and returns whether the row should be selected.
+-- @usage df = DataFrame{
+--     cover = {"forest", "forest", "pasture"},
+--     area = {10, 20, 5}
+-- }
+--
+-- forest = df:filter("cover", "forest")
+-- print(#forest) -- 2
+--
+-- large = df:filter("area", function(value) return value > 8 end)
+-- print(#large) -- 2
+local function filter(self, column, value)
+	local values = getColumn(self, column, 1)
+
+	if value == nil then
+		mandatoryArgumentError(2)
+	end
+
+	local positions
+
+	if isNative(values) and type(value) ~= "function" then
+		positions = values:find(value)
+	else
+		local select = value
+
+		if type(value) ~= "function" then
+			select = function(mvalue) return mvalue == value end
+		end
+
+		positions = {}
+		forEachOrderedElement(self.rows_, function(row)
+			if select(values[row]) then
+				table.insert(positions, row)
+			end
+		end)
+	end
+
+	local result = DataFrame{instance = self.instance_}
+
+	forEachElement(self.data_, function(idx, mvalues)
+		if isNative(mvalues) and (#positions == 0 or positions[#positions] <= #mvalues) then
+			result.data_[idx] = mvalues:gather(positions)
+		else
+			local selected = {}
+			for i = 1, #positions do
+				selected[i] = mvalues[positions[i]]
+			end
+
+			result.data_[idx] = nativeColumn(selected)
+		end
+
+		result.columns_[idx] = true
+	end)
+
+	for i = 1, #positions do
+		result.rows_[i] = true
+	end
+
+	return result
+end
+
 local DataFrameIndex = {
 	add = add,
 	remove = remove,
 	save = save,
 	rows = rows,
 	columns = columns,
+	sum = sum,
+	mean = mean,
+	filter = filter,
 	type_ = "DataFrame"
 }
 
@@ -224,10 +442,12 @@ metaTableDataFrame_ = {
 		end
 	end,
 	__newindex = function(self, idx, value)
-		mandatoryArgument(2, "table", value)
+		if not isNative(value) then
+			mandatoryArgument(2, "table", value)
+		end
 
 		if type(idx) == "string" then
-			self.data_[idx] = value
+			self.data_[idx] = nativeColumn(value)
 			self.columns_[idx] = true
 		elseif type(idx) == "number" then
 			self:add(value, idx)
@@ -285,7 +505,14 @@ metaTableDataFrame_ = {
 }
 
 --- A two dimensional table. DataFrames can be accessed by row or by column, independently on the way it was created.
--- @arg data.file A string or a File. It must have extension '.lua'.
+-- Columns whose rows go from one to the number of rows and whose values are all numbers, all integers,
+-- all booleans, or all strings are stored in contiguous arrays in C++, which use much less memory
+-- than Lua tables. Such column goes back to a Lua table when it gets a value of another type.
+-- @arg data.file A string or a File. It must have extension '.lua' or '.tmc'. Files '.tmc'
+-- are created by CellularSpace:save(). Their DataFrame has one row for each Cell, with
+-- columns id, x, y, and the attributes saved in the selected time.
+-- @arg data.time A number with the time to be loaded from a '.tmc' file. The default value
+-- is the last saved time.
 -- @arg data.first A number with the first index.
 -- @arg data.step A number with the interval between two indexes.
 -- @arg data.last A number with the last index. This argument is optional.
@@ -324,7 +551,27 @@ function DataFrame(data)
 
 		mandatoryTableArgument(data, "file", "File")
 
-		verify(data.file:extension() == "lua", "File '"..data.file:name().."' does not have '.lua' extension.")
+		if data.file:extension() == "tmc" then
+			verify(data.file:exists(), resourceNotFoundMsg("file", data.file:name(true)))
+			optionalTableArgument(data, "time", "number")
+
+			local tbl, merror = cpp_columnarload(tostring(data.file), data.time)
+			if not tbl then customError(merror) end
+
+			local columns = tbl.columns
+			columns.id = tbl.id
+			columns.x = {}
+			columns.y = {}
+
+			for i = 1, #tbl.id do
+				columns.x[i] = math.tointeger(tbl.x[i]) or tbl.x[i]
+				columns.y[i] = math.tointeger(tbl.y[i]) or tbl.y[i]
+			end
+
+			return DataFrame(columns)
+		end
+
+		verify(data.file:extension() == "lua", "File '"..data.file:name().."' does not have '.lua' or '.tmc' extension.")
 		verify(data.file:exists(), resourceNotFoundMsg("file", data.file:name(true)))
 
 		local tbl
@@ -397,6 +644,12 @@ function DataFrame(data)
 		if last and position ~= last then
 			customError("Rows should range until position "..last..", got "..position..".")
 		end
+
+		if first == 1 and step == 1 then
+			forEachElement(mcolumns, function(idx)
+				df[idx] = nativeColumn(df[idx])
+			end)
+		end
 	elseif getn(data) > 0 then
 		local length
 		local lastColumn
@@ -430,7 +683,7 @@ function DataFrame(data)
 					customError("Argument '"..idx.."' should range until position "..last..", got "..position..".")
 				end
 			else
-				df[idx] = value
+				df[idx] = nativeColumn(value)
 
 				forEachElement(value, function(i)
 					mrows[i] = true
@@ -375,7 +375,7 @@ Environment_ = {
 					process(value)
 				elseif mtype == "Timer" then
 					table.insert(timers, value)
-					forEachElement(value.events, function(_, ev)
+					forEachElement(value:getEvents(), function(_, ev)
 						timer:add(ev)
 					end)
 				elseif isModel(value) and idx ~= "parent" then
@@ -74,6 +74,38 @@ local function parseLine(line, sep, cline)
 	return res
 end
 
+-- rows formatted at once by File:write()
+local CSV_BLOCK = 10000
+
+-- read the whole file natively, with the same output of the Lua parser
+local function readCsv(self, sep)
+	self.line = 1
+	self.file = self:open("r")
+
+	local csv, merror = cpp_csvread(self.filename, sep)
+	if not csv then customError(merror) end
+
+	local data = DataFrame{}
+
+	forEachElement(csv.names, function(_, name)
+		data[name] = csv.columns[name]
+	end)
+
+	local rows = data:rows()
+	for i = 1, csv.rows do
+		rows[i] = true
+	end
+
+	forEachElement(csv.invalid, function(_, invalid)
+		customWarning("Line "..invalid.line.." ('"..invalid.text.."') should contain "..#csv.names.." attributes but has "..invalid.size..".")
+	end)
+
+	self.line = csv.lines
+	self:close()
+
+	return data
+end
+
 local function checkInvalidChars(filename)
 	local invalidChars = string.gsub(filename, "[^\34\42\47\58\60\62\63\92\124]", "")
 	if #invalidChars ~= 0 then
@@ -366,7 +398,9 @@ File_ = {
 	--- Read a file. It returns a vector (whose indexes are line numbers)
 	-- containing named tables (whose indexes are attribute names).
 	-- The first line of the file list the attribute names. This function
-	-- automatically closes the file.
+	-- automatically closes the file. When the file is not opened and the separator has a single
+	-- character, the file is mapped into memory and parsed in parallel in C++, and its columns
+	-- with numbers or strings are stored natively in the DataFrame.
 	-- @arg sep A string with the separator. The default value is ','.
 	-- @usage file = filePath("agents.csv", "base")
 	-- csv = file:read()
@@ -375,6 +409,12 @@ File_ = {
 		optionalArgument(1, "string", sep)
 		sep = sep or ','
 
+		-- separators that are not Lua pattern characters are parsed natively
+		if not self.mode and #sep == 1 and not string.find(sep, "[%^%$%(%)%%%.%[%]%*%+%-%?]")
+		   and (self:attributes("size") or 0) > 0 then
+			return readCsv(self, sep)
+		end
+
 		if not self.mode then
 			self.line = 1
 			self.file = self:open("r")
@@ -507,21 +547,18 @@ File_ = {
 		self.file:write(table.concat(header, sep))
 		self.file:write("\n")
 
-		for i = 1, #data do
-			local line = {}
-
-			for j = 1, #header do
-				local value = data[header[j]][i]
-				local t = type(value)
-				if t ~= "number" then
-					value = "\""..tostring(value) .."\""
-				end
+		local values = {}
+		for j = 1, #header do
+			values[j] = data.data_[header[j]]
+		end
 
-				table.insert(line, value)
-			end
+		local quantity = #data
+		local first = 1
 
-			self.file:write(table.concat(line, sep))
-			self.file:write("\n")
+		while first <= quantity do
+			local last = math.min(first + CSV_BLOCK - 1, quantity)
+			self.file:write(cpp_csvformat(values, first, last, sep))
+			first = last + 1
 		end
 
 		self:close()
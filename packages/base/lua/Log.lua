@@ -41,6 +41,26 @@ Log_ = {
 	-- File("agent.csv"):delete()
 	update = function(self)
 		self.target:notify()
+	end,
+	--- Write the lines kept in memory into the file. It is only necessary when
+	-- the Log uses argument flush and the file needs to be read before the end
+	-- of the simulation.
+	-- @usage agent = Agent{
+	--     age = 3
+	-- }
+	--
+	-- log = Log{
+	--     target = agent,
+	--     file = "agent.csv",
+	--     flush = 100
+	-- }
+	--
+	-- log:update()
+	-- log:flush()
+	--
+	-- File("agent.csv"):delete()
+	flush = function(self)
+		self.cObj_:flush()
 	end
 }
 
@@ -54,6 +74,12 @@ metaTableLog_ = {__index = Log_}
 -- @arg data.separator A string with the separator. The default value is ",".
 -- @arg data.overwrite A boolean value indicating whether the file should be overwritten.
 -- The default value is true.
+-- @arg data.flush A positive integer with the number of lines kept in memory before
+-- writing them into the file. The lines are also written when the Log is updated more
+-- than one second after the last write, when the Log is removed, and at the end of the
+-- simulation. Using large values avoids accessing the disk each time the Log is updated,
+-- but then the file stays open until the Log is removed or the simulation ends. The
+-- default value is 1, which closes the file after each update.
 -- @arg data.select A vector of strings with the name of the attributes to be observed.
 -- If it is only a single value then it can also be described as a string.
 -- As default, it selects all the user-defined attributes of an object.
@@ -70,12 +96,15 @@ metaTableLog_ = {__index = Log_}
 -- }
 function Log(data)
 	verifyNamedTable(data)
-	verifyUnnecessaryArguments(data, {"target", "select", "file", "separator", "overwrite"})
+	verifyUnnecessaryArguments(data, {"target", "select", "file", "separator", "overwrite", "flush"})
 
 	mandatoryTableArgument(data, "target")
 	defaultTableValue(data, "separator", ",")
 	defaultTableValue(data, "file", "result.csv")
 	defaultTableValue(data, "overwrite", true)
+	defaultTableValue(data, "flush", 1)
+	integerTableArgument(data, "flush")
+	positiveTableArgument(data, "flush")
 
 	if type(data.select) == "string" then data.select = {data.select} end
 
@@ -181,6 +210,7 @@ function Log(data)
 	table.insert(observerParams, data.file)
 	table.insert(observerParams, data.separator)
 	table.insert(observerParams, data.mode)
+	table.insert(observerParams, string.format("%d", data.flush))
 
 	if type(target) == "CellularSpace" then
 		id, obs = target.cObj_:createObserver(observerType, {}, data.select, observerParams, target.cells)
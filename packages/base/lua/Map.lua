@@ -1459,9 +1459,33 @@ forEachElement(brewerRGB, function(idx, value)
 	end
 end)
 
+local function createMapObserver(data, observerType)
+	local tbDimensions = {data.target.xMax - data.target.xMin + 1, data.target.yMax - data.target.yMin + 1}
+	local idObs, obs = data.target.cObj_:createObserver(observerType, tbDimensions, {data.select}, data.observerParams_, data.target.cells)
+
+	data.cObj_:setObserver(obs, observerType)
+	data.cObj_:setProtocolFormat(1) -- columnar binary state
+
+	if data.grid then
+		data.cObj_:setGridVisible(1)
+	end
+
+	if data.title then
+		data.cObj_:setTitle(data.title)
+	end
+
+	data.id = idObs
+	data.observerType_ = observerType
+end
+
 Map_ = {
 	type_ = "Map",
 	--- Save a Map into a file. Supported extensions are bmp, jpg, png, and tiff.
+	-- The extension mjpeg appends the Map as a new frame of a single Motion JPEG
+	-- video that is closed when the simulation ends. Images are written in the
+	-- background, so saving does not stop the simulation. The file is complete
+	-- when it is checked with isFile() or File:exists(). When TerraME runs with
+	-- -headless, Maps of CellularSpaces are drawn only into images, without any window.
 	-- @arg file A string with the file name.
 	-- @usage cs = CellularSpace{
 	--     xdim = 10
@@ -1481,7 +1505,7 @@ Map_ = {
 	save = function(self, file)
 		local _, extension = string.match(file, "(.-)([^%.]+)$")
 
-		local availableExtensions = {bmp = true, jpg = true, png = true, tiff = true}
+		local availableExtensions = {bmp = true, jpg = true, png = true, tiff = true, mjpeg = true}
 
 		if not availableExtensions[extension] then
 			invalidFileExtensionError(1, extension)
@@ -2161,6 +2185,11 @@ function Map(data)
 
 	local observerType = 6
 
+	-- without a graphical interface, CellularSpaces are drawn only into images
+	if sessionInfo().headless and type(data.target) == "CellularSpace" then
+		observerType = 9 -- SKIP
+	end
+
 	local observerParams = {}
 	local colorBar = {}
 
@@ -2200,14 +2229,18 @@ function Map(data)
 	}
 
 	if type(data.target) == "Society" then
+		-- images cannot draw agents, the background is drawn by a Map observer
+		if data.background.observerType_ == 9 then
+			data.background.target.cObj_:kill(data.background.id) -- SKIP
+			createMapObserver(data.background, 6) -- SKIP
+		end
+
 		table.insert(observerParams, data.background.target)
 		table.insert(observerParams, data.background.id)
 	end
 
 	table.insert(observerParams, legend)
 
-	local idObs, obs
-
 	if type(data.target) == "Society" then
 		forEachAgent(data.target, function(ag)
 			verify(ag.cObj_, "It is simple agent and it can not be observable.")
@@ -2217,24 +2250,11 @@ function Map(data)
 		data.background.target:notify()
 		data.background.target:notify()
 		return data.background
-	else
-		local tbDimensions = {data.target.xMax - data.target.xMin + 1, data.target.yMax - data.target.yMin + 1}
-		idObs, obs = data.target.cObj_:createObserver(observerType, tbDimensions, {data.select}, observerParams, data.target.cells)
-	end
-
-	local map = TeMap()
-	map:setObserver(obs)
-
-	data.id = idObs
-	data.cObj_ = map
-
-	if data.grid then
-		map:setGridVisible(1)
 	end
 
-	if data.title then
-		map:setTitle(data.title)
-	end
+	data.cObj_ = TeMap()
+	data.observerParams_ = observerParams
+	createMapObserver(data, observerType)
 
 	setmetatable(data, metaTableMap_)
 	table.insert(_Gtme.createdObservers, data)
@@ -22,6 +22,36 @@
 --
 -------------------------------------------------------------------------------------------
 
+-- Position of each Cell in the connections of each Neighborhood, indexed by Cell id.
+-- It is kept out of the Neighborhoods so that they still have only connections and weights.
+local positions = setmetatable({}, {__mode = "k"})
+
+-- Return the index of positions of a Neighborhood, building it if necessary.
+local function getIndex(self)
+	local index = positions[self]
+
+	if not index then
+		index = {}
+
+		for i = 1, #self.connections do
+			index[self.connections[i]:getId()] = i
+		end
+
+		positions[self] = index
+	end
+
+	return index
+end
+
+-- Return the position of a Cell in a Neighborhood, or nil if it is not a neighbor.
+local function getPosition(self, cell)
+	local position = getIndex(self)[cell:getId()]
+
+	if position and self.connections[position] == cell then
+		return position
+	end
+end
+
 Neighborhood_ = {
 	type_ = "Neighborhood",
 	--- Add a new Cell to the Neighborhood. If the Neighborhood already contains such Cell
@@ -42,14 +72,14 @@ Neighborhood_ = {
 			customError("Cell should have an id in order to be added to a Neighborhood.") -- SKIP
 		end
 
-		for i = 1, #self do
-			if self.connections[i]:getId() == id then
-				customError("Cell '"..id.."' already belongs to the Neighborhood.")
-			end
+		local index = getIndex(self)
+		if index[id] then
+			customError("Cell '"..id.."' already belongs to the Neighborhood.")
 		end
 
 		table.insert(self.connections, cell)
 		table.insert(self.weights, weight)
+		index[id] = #self.connections
 	end,
 	--- Remove all Cells from the Neighborhood. In practice, it has the same behavior
 	-- as calling Neighborhood() again if the Neighborhood was not added to any Cell.
@@ -58,6 +88,7 @@ Neighborhood_ = {
 	clear = function(self)
 		self.connections = {}
 		self.weights = {}
+		positions[self] = {}
 	end,
 	--- Return the weight of the connection to a given neighbor Cell. It returns nil when
 	-- the Cell is not a neighbor.
@@ -76,10 +107,9 @@ Neighborhood_ = {
 			customError("Cell does not belong to the Neighborhood because it does not have an id.")
 		end
 
-		for i = 1, #self do
-			if self.connections[i] == cell then
-				return self.weights[i]
-			end
+		local position = getPosition(self, cell)
+		if position then
+			return self.weights[position]
 		end
 
 		customError("Cell '"..id.."' does not belong to the Neighborhood.")
@@ -105,11 +135,7 @@ Neighborhood_ = {
 	isNeighbor = function(self, cell)
 		mandatoryArgument(1, "Cell", cell)
 
-		for i = 1, #self do
-			if self.connections[i] == cell then return true end
-		end
-
-		return false
+		return getPosition(self, cell) ~= nil
 	end,
 	--- Remove a Cell from the Neighborhood.
 	-- @arg cell The Cell that is going to be removed.
@@ -126,12 +152,19 @@ Neighborhood_ = {
 	remove = function(self, cell)
 		mandatoryArgument(1, "Cell", cell)
 
-		for i = 1, #self do
-			if self.connections[i] == cell then
-				table.remove(self.connections, i)
-				table.remove(self.weights, i)
-				return true
+		local position = getPosition(self, cell)
+		if position then
+			local index = getIndex(self)
+
+			table.remove(self.connections, position)
+			table.remove(self.weights, position)
+			index[cell:getId()] = nil
+
+			for i = position, #self.connections do
+				index[self.connections[i]:getId()] = i
 			end
+
+			return true
 		end
 
 		customWarning("Trying to remove a Cell that does not belong to the Neighborhood.")
@@ -173,11 +206,10 @@ Neighborhood_ = {
 			customError("Cell does not belong to the Neighborhood because it does not have an id.")
 		end
 
-		for i = 1, #self do
-			if self.connections[i] == cell then
-				self.weights[i] = weight
-				return true
-			end
+		local position = getPosition(self, cell)
+		if position then
+			self.weights[position] = weight
+			return true
 		end
 
 		customError("Cell '"..id.."' does not belong to the Neighborhood.")
@@ -196,6 +228,59 @@ metaTableNeighborhood_ = {
 	__tostring = _Gtme.tostring
 }
 
+-- Neighborhoods of all the Cells of a CellularSpace stored in compressed sparse
+-- row form. The neighbors of the Cell in position p of the CellularSpace are
+-- cells[neighbors[first[p]]] to cells[neighbors[first[p + 1] - 1]]. The weights of
+-- stencil Neighborhoods of regular CellularSpaces are stored once for each Cell, in
+-- weights[p], while the ones of loaded Neighborhoods (edgeWeights) are stored for each
+-- neighbor, in the same positions of neighbors. Each Cell converts it into a Neighborhood
+-- when Cell:getNeighborhood() is called, while forEachNeighbor() traverses it directly.
+NeighborhoodIndex_ = {
+	type_ = "NeighborhoodIndex",
+	-- Return the position of a Cell in the CellularSpace.
+	position = function(self, cell)
+		local grid = self.grid
+		if grid then
+			return (cell.x - grid.xMin) * grid.ydim + cell.y - grid.yMin + 1
+		end
+
+		local positions = self.positions
+		if not positions then
+			positions = {}
+
+			for i, mcell in ipairs(self.cells) do
+				positions[mcell] = i
+			end
+
+			self.positions = positions
+		end
+
+		return positions[cell]
+	end,
+	-- Return a new Neighborhood with the neighbors of a Cell.
+	get = function(self, cell)
+		local position = self:position(cell)
+		local cells = self.cells
+		local neighbors = self.neighbors
+		local weights = self.weights
+		local weight = weights[position]
+		local neigh = Neighborhood()
+
+		for k = self.first[position], self.first[position + 1] - 1 do
+			if self.edgeWeights then weight = weights[k] end
+
+			neigh:add(cells[neighbors[k]], weight)
+		end
+
+		return neigh
+	end
+}
+
+metaTableNeighborhoodIndex_ = {
+	__index = NeighborhoodIndex_,
+	__tostring = _Gtme.tostring
+}
+
 --- A Neighborhood is a set of pairs (cell, weight), where cell is a neighbor Cell and weight
 -- is a number storing the relation's strength.
 -- Each Cell can have one or more Neighborhoods to represent its proximity relations. \
@@ -39,6 +39,9 @@ end
 function isFile(file)
 	mandatoryArgument(1, "string", file)
 
+	-- images saved by Maps are written in the background
+	cpp_flushimage(file)
+
 	return lfs.attributes(file, "mode") == "file"
 end
 
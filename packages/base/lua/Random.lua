@@ -24,13 +24,51 @@
 
 local MersenneTwister
 local UniformReal
+local randomSeed
 local TerraLib = getPackage("gis").TerraLib
 
+-- numbers generated at once by each buffer of a stream
+local STREAM_BUFFER = 1024
+
+-- uniform generators of the Random objects that have a stream
+local streamUniform = setmetatable({}, {__mode = "k"})
+
 local function getMT()
 	MersenneTwister()
 	return MersenneTwister
 end
 
+local function setSeed(seed)
+	randomSeed = seed
+	MersenneTwister = TerraLib().random().MersenneTwister(seed)
+	UniformReal = TerraLib().random().UniformRealDistribution(getMT(), 0, 1)
+end
+
+local function buffered(stream, distrib, v1, v2)
+	local buffer = {}
+	local size = 0
+	local position = 1
+
+	return function()
+		if position > size then
+			stream.position = cpp_randomfill(buffer, STREAM_BUFFER, stream.seed, stream.id, stream.position, distrib, v1, v2)
+			size = STREAM_BUFFER
+			position = 1
+		end
+
+		local value = buffer[position]
+		position = position + 1
+		return value
+	end
+end
+
+local function uniform(self)
+	local generator = streamUniform[self]
+	if generator then return generator() end
+
+	return UniformReal()
+end
+
 local function categorical(values)
 	local str = "return function(number)\n"
 
@@ -84,7 +122,7 @@ Random_ = {
 		v1 = math.floor(v1)
 		v2 = math.floor(v2)
 
-		return math.floor(v1 + UniformReal() * (v2 - v1 + 1))
+		return math.floor(v1 + uniform(self) * (v2 - v1 + 1))
 	end,
 	--- Return a random real number.
 	--  By default number() will return a value between zero and one.
@@ -103,7 +141,7 @@ Random_ = {
 		optionalArgument(2, "number", v2)
 
 		if not v1 and not v2 then
-			return UniformReal()
+			return uniform(self)
 		else
 			local max = 1
 			local min = 0
@@ -125,7 +163,7 @@ Random_ = {
 				end
 			end
 
-			return (max - min) * UniformReal() + min
+			return (max - min) * uniform(self) + min
 		end
 	end,
 	--- Set the seed to generate random numbers. This seed will be used in new instances
@@ -145,8 +183,7 @@ Random_ = {
 		optionalArgument(1, "number", seed)
 		integerArgument(1, seed)
 
-		MersenneTwister = TerraLib().random().MersenneTwister(seed)
-		UniformReal = TerraLib().random().UniformRealDistribution(getMT(), 0, 1)
+		setSeed(seed)
 	end,
 	--- Return a random element from the chosen distribution.
 	-- @usage random = Random{2, 3, 4, 6}
@@ -223,6 +260,12 @@ metaTableRandom_ = {__index = Random_, __tostring = _Gtme.tostring}
 -- It is a good programming practice to set
 -- the seed in the beginning of the simulation and only once.
 -- @arg data.sd A number indicating the standard deviation. The default value is 1.
+-- @arg data.stream A positive integer number (including zero) to draw the numbers from an
+-- independent stream of the current seed. Streams use a counter-based generator (Philox)
+-- that computes the numbers in blocks, which is much faster than the default generator.
+-- Random objects created with the same seed and the same stream always return the same
+-- sequence, while different streams never overlap. It is useful to give each parallel
+-- worker its own reproducible sequence.
 -- @arg attrTab.step The step where possible values are computed from minimum to maximum.
 -- When using this argument, min and max become mandatory.
 -- @arg attrTab.... Other values to build a categorical or discrete uniform distribution.
@@ -248,6 +291,9 @@ metaTableRandom_ = {__index = Random_, __tostring = _Gtme.tostring}
 -- cover = Random{"pasture", "forest", "clearcut"}
 -- print(cover:sample())
 --
+-- worker = Random{stream = 2}
+-- print(worker:number())
+--
 -- person = Agent{
 --     gender = Random{male = 0.49, female = 0.51},
 --     age = Random{mean = 20, sd = 2},
@@ -267,6 +313,13 @@ function Random(data)
 		customError(tableArgumentMsg())
 	end
 
+	local streamId = data.stream
+	if streamId ~= nil then
+		integerTableArgument(data, "stream")
+		positiveTableArgument(data, "stream", true)
+		data.stream = nil
+	end
+
 	if not data.distrib then
 		if data.p ~= nil then
 			data.distrib = "bernoulli"
@@ -297,19 +350,32 @@ function Random(data)
 		integerTableArgument(data, "seed")
 		verify(data.seed ~= 0, "Argument 'seed' cannot be zero.")
 
-		MersenneTwister = TerraLib().random().MersenneTwister(data.seed)
-		UniformReal = TerraLib().random().UniformRealDistribution(getMT(), 0, 1)
+		setSeed(data.seed)
 		data.seed = nil
 	elseif not MersenneTwister then
-		local seed = os.time() -- SKIP
-		MersenneTwister = TerraLib().random().MersenneTwister(seed) -- SKIP
-		UniformReal = TerraLib().random().UniformRealDistribution(getMT(), 0, 1) -- SKIP
+		setSeed(os.time()) -- SKIP
+	end
+
+	local stream
+	local draw
+
+	if streamId then
+		stream = {id = streamId, seed = randomSeed, position = 0}
+		draw = buffered(stream, "uniform", 0, 1)
+		streamUniform[data] = draw
 	end
 
 	switch(data, "distrib"):caseof{
 		bernoulli = function()
 			verifyUnnecessaryArguments(data, {"distrib", "p"})
 			mandatoryTableArgument(data, "p", "number")
+
+			if draw then
+				local p = data.p
+				data.sample = function() return draw() < p end
+				return
+			end
+
 			local bd = TerraLib().random().BernoulliDistribution(getMT(), data.p)
 			data.sample = function() return bd() end
 		end,
@@ -328,10 +394,19 @@ function Random(data)
 				customError("Invalid 'max' value ("..data.max.."). It could be "..max1.." or "..max2..".")
 			end
 
-			local ud = TerraLib().random().UniformIntDistribution(getMT(), 0, k)
 			local min = data.min
 			local step = data.step
 
+			if draw then
+				local quantity = math.floor(k + 0.5) + 1
+				data.sample = function()
+					return min + step * math.floor(draw() * quantity)
+				end
+				return
+			end
+
+			local ud = TerraLib().random().UniformIntDistribution(getMT(), 0, k)
+
 			data.sample = function()
 				return min + step * ud()
 			end
@@ -347,6 +422,12 @@ function Random(data)
 			verify(#data == getn(data), "The only named arguments should be distrib and seed.")
 			data.distrib = "discrete"
 
+			if draw then
+				local quantity = #values
+				data.sample = function() return values[math.floor(draw() * quantity) + 1] end
+				return
+			end
+
 			local dd = TerraLib().random().UniformIntDistribution(getMT(), 1, #values)
 			data.sample = function() return values[dd()] end
 		end,
@@ -356,6 +437,11 @@ function Random(data)
 			mandatoryTableArgument(data, "max", "number")
 			verify(data.max > data.min, "Argument 'max' should be greater than 'min'.")
 
+			if stream then
+				data.sample = buffered(stream, "uniform", data.min, data.max)
+				return
+			end
+
 			local urd = TerraLib().random().UniformRealDistribution(getMT(), data.min, data.max)
 
 			data.sample = function() return urd() end
@@ -377,9 +463,14 @@ function Random(data)
 			verify(math.abs(sum - 1) < sessionInfo().round, "Sum should be one, got "..sum..".")
 
 			local categoricalFunc = categorical(probabilities)
-			local discrete = Random{min = 0, max = 1}
 
-			data.sample = function() return categoricalFunc(discrete:sample()) end
+			if draw then
+				data.sample = function() return categoricalFunc(draw()) end
+			else
+				local discrete = Random{min = 0, max = 1}
+				data.sample = function() return categoricalFunc(discrete:sample()) end
+			end
+
 			data.distrib = "categorical"
 			data.values = values
 		end,
@@ -388,6 +479,11 @@ function Random(data)
 
 			verifyUnnecessaryArguments(data, {"distrib", "lambda"})
 
+			if stream then
+				data.sample = buffered(stream, "exponential", data.lambda)
+				return
+			end
+
 			local exp = TerraLib().random().ExponentialDistribution(getMT(), data.lambda)
 
 			data.sample = function()
@@ -400,6 +496,11 @@ function Random(data)
 
 			verifyUnnecessaryArguments(data, {"distrib", "mean", "sd"})
 
+			if stream then
+				data.sample = buffered(stream, "normal", data.mean, data.sd)
+				return
+			end
+
 			local nd = TerraLib().random().NormalDistribution(getMT(), data.mean, data.sd)
 			data.sample = function() return nd() end
 		end,
@@ -412,6 +513,12 @@ function Random(data)
 
 			verifyUnnecessaryArguments(data, {"distrib", "mean", "sd"})
 
+			if stream then
+				local normal = buffered(stream, "normal", data.mean, data.sd)
+				data.sample = function() return math.exp(normal()) end
+				return
+			end
+
 			local ln = TerraLib().random().LogNormalDistribution(getMT(), data.mean, data.sd)
 			data.sample = function() return ln() end
 		end,
@@ -422,6 +529,22 @@ function Random(data)
 
 			verifyUnnecessaryArguments(data, {"distrib", "lambda"})
 
+			if draw then
+				local limit = math.exp(-data.lambda)
+				data.sample = function()
+					local value = 0
+					local product = draw()
+
+					while product > limit do
+						value = value + 1
+						product = product * draw()
+					end
+
+					return value
+				end
+				return
+			end
+
 			local pd = TerraLib().random().PoissonDistribution(getMT(), data.lambda)
 			data.sample = function() return pd() end
 		end,
@@ -432,6 +555,13 @@ function Random(data)
 			positiveTableArgument(data, "lambda")
 			positiveTableArgument(data, "k")
 
+			if draw then
+				local lambda = data.lambda
+				local k = data.k
+				data.sample = function() return lambda * (-math.log(draw())) ^ (1 / k) end
+				return
+			end
+
 			local wd = TerraLib().random().WeibullDistribution(getMT(), data.k, data.lambda)
 			data.sample = function() return wd() end
 		end,
@@ -443,12 +573,19 @@ function Random(data)
 			positiveTableArgument(data, "beta")
 
 			local betad = TerraLib().random().BetaDistribution(data.alpha, data.beta)
+
+			if draw then
+				data.sample = function() return betad(draw()) end
+				return
+			end
+
 			local urd = TerraLib().random().UniformRealDistribution(getMT(), 0, 1)
 
 			data.sample = function() return betad(urd()) end
 		end
 	}
 
+	data.stream = streamId
 	setmetatable(data, metaTableRandom_)
 	return data
 end
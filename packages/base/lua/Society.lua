@@ -1052,15 +1052,14 @@ function Society(data)
 			end
 
 			local csv = data.file:read(data.sep)
-			local columns = csv:columns()
+			local columns = csv.data_
 
 			for i = 1, #csv do
 				local attributes = {}
-				local row = csv[i]
 
-				forEachElement(columns, function(idx)
-					attributes[idx] = row[idx]
-				end)
+				for idx, values in pairs(columns) do
+					attributes[idx] = values[i]
+				end
 
 				data:add(attributes)
 			end
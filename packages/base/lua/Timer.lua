@@ -22,6 +22,61 @@
 --
 -------------------------------------------------------------------------------------------
 
+-- The Events of a Timer are stored in a binary heap ordered by time, priority, and
+-- the order they were added to the Timer. The order of each Event is kept in a
+-- weak table to avoid new attributes in the Events.
+local queues = setmetatable({}, {__mode = "k"})
+
+local function getQueue(timer)
+	local queue = queues[timer]
+	if not queue then
+		queue = {order = setmetatable({}, {__mode = "k"}), count = 0}
+		queues[timer] = queue
+	end
+
+	return queue
+end
+
+local function before(ev1, ev2, order)
+	if ev1.time ~= ev2.time then return ev1.time < ev2.time end
+	if ev1.priority ~= ev2.priority then return ev1.priority < ev2.priority end
+	return order[ev1] < order[ev2]
+end
+
+local function siftUp(events, pos, order)
+	local event = events[pos]
+	while pos > 1 do
+		local parent = pos // 2
+		local evp = events[parent]
+		if not before(event, evp, order) then break end
+
+		events[pos] = evp
+		pos = parent
+	end
+
+	events[pos] = event
+end
+
+local function siftDown(events, pos, order)
+	local quant = #events
+	local event = events[pos]
+	while true do
+		local child = pos * 2
+		if child > quant then break end
+
+		if child < quant and before(events[child + 1], events[child], order) then
+			child = child + 1
+		end
+
+		if not before(events[child], event, order) then break end
+
+		events[pos] = events[child]
+		pos = child
+	end
+
+	events[pos] = event
+end
+
 Timer_ = {
 	type_ = "Timer",
 	--- Add a new Event to the timer. If the Event has a start time less than the current
@@ -44,17 +99,13 @@ Timer_ = {
 			customWarning(msg)
 		end
 
-		local pos = 1
-		local evp = self.events[pos]
-		local quant = #self.events
-		local time = event.time
-		local prio = event.priority
-		while pos <= quant and (time > evp.time or (time == evp.time and prio >= evp.priority)) do
-			pos = pos + 1
-			evp = self.events[pos]
-		end
+		local queue = getQueue(self)
+		queue.count = queue.count + 1
+		queue.order[event] = queue.count
 
-		table.insert(self.events, pos, event)
+		local events = self.events
+		events[#events + 1] = event
+		siftUp(events, #events, queue.order)
 		event.parent = self
 	end,
 	--- Remove all the Events from the Timer. Note that, when this function is called
@@ -68,15 +119,28 @@ Timer_ = {
 	-- timer:clear()
 	clear = function(self)
 		self.events = {}
+		queues[self] = nil
 	end,
-	--- Return a vector with the Events of the Timer.
+	--- Return a vector with the Events of the Timer, ordered according to the
+	-- sequence they will be executed.
 	-- @usage timer = Timer{
 	--     Event{action = function() print("step") end}
 	-- }
 	--
 	-- print(timer:getEvents()[1]:getTime())
 	getEvents = function(self)
-		return self.events
+		local order = getQueue(self).order
+		local events = {}
+
+		for i = 1, #self.events do
+			events[i] = self.events[i]
+		end
+
+		table.sort(events, function(ev1, ev2)
+			return before(ev1, ev2, order)
+		end)
+
+		return events
 	end,
 	--- Return the current simulation time.
 	-- @usage timer = Timer{
@@ -141,9 +205,11 @@ Timer_ = {
 		end
 
 		while true do
-			if getn(self.events) == 0 then return end
+			local events = self.events
+			local quant = #events
+			if quant == 0 then return end
 
-			local ev = self.events[1]
+			local ev = events[1]
 			if ev.time > finalTime then
 				self.time = finalTime
 				return
@@ -151,7 +217,11 @@ Timer_ = {
 
 			self.time = ev.time
 
-			table.remove(self.events, 1)
+			events[1] = events[quant]
+			events[quant] = nil
+			if quant > 1 then
+				siftDown(events, 1, getQueue(self).order)
+			end
 
 			local result = ev.action(ev, self)
 
@@ -202,7 +272,8 @@ metaTableTimer_ = {
 -- Events before that time were already executed. See Timer:run() for more details.
 -- @arg data.... A set of Events.
 -- @output cObj_ A pointer to a C++ representation of the Timer. Never use this object.
--- @output events An ordered vector with the Events.
+-- @output events A binary heap with the Events. The first one is the next to be executed.
+-- Use Timer:getEvents() to get them in the order they will be executed.
 -- @output time The current simulation time.
 -- @usage timer = Timer{
 --     Event{action = function()
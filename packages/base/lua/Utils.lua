@@ -357,15 +357,32 @@ end
 -- It can optionally have a second argument with a positive number representing the position of
 -- the Cell in the vector of Cells. If it returns false when processing a given Cell,
 -- forEachCell() stops and does not process any other Cell. In the case where the second argument
--- is missing, this function becomes the second argument.
+-- is missing, this function becomes the second argument. When the first argument is a
+-- CellularSpace, the third argument can be a positive number of threads or true (as many
+-- threads as processor cores) to traverse the Cells in parallel. In this case, each thread
+-- has its own Lua state and the function cannot use local variables declared outside it nor
+-- the TerraME types, only the Lua standard libraries and forEachNeighbor(). The function gets a
+-- copy of the Cell with its attributes and past values (see CellularSpace:synchronize()).
+-- Only the attributes whose names appear in the function are copied, unless it uses pairs(),
+-- next(), rawget(), or indexes tables with computed keys.
+-- Neighbors only have x, y, id, and the past values, and only the Neighborhoods of regular
+-- CellularSpaces created with strategies moore, vonneumann, diagonal, or mxn can be traversed.
+-- The attributes changed by the function are copied back to the Cell after all the Cells are
+-- processed. All the Cells are processed even if some call returns false.
 -- @usage cellularspace = CellularSpace{xdim = 10}
 --
 -- forEachCell(cellularspace, function(cell)
 --     cell.water = 0
 -- end)
+--
+-- cellularspace:synchronize()
+-- forEachCell(cellularspace, function(cell)
+--     cell.water = cell.past.water + 1
+-- end, 4)
 -- @see Environment:createPlacement
 function forEachCell(object, name, _sof_)
 	local t = type(object)
+	local parallel
 
 	if t == "Agent" then
 		if type(name) == "function" then
@@ -379,6 +396,7 @@ function forEachCell(object, name, _sof_)
 
 		return true
 	else
+		parallel = _sof_
 		_sof_ = name
 	end
 
@@ -388,6 +406,32 @@ function forEachCell(object, name, _sof_)
 		incompatibleTypeError(2, "function", _sof_)
 	end
 
+	if parallel ~= nil and parallel ~= false then
+		if t ~= "CellularSpace" then
+			customError("Only a CellularSpace can be traversed in parallel, got "..t..".")
+		elseif parallel == true then
+			parallel = 0
+		elseif type(parallel) ~= "number" then
+			incompatibleTypeError(3, "boolean or number", parallel)
+		else
+			integerArgument(3, parallel)
+			positiveArgument(3, parallel)
+		end
+
+		local i = 1
+		local upvalue = debug.getupvalue(_sof_, i)
+		while upvalue do
+			if upvalue ~= "_ENV" then
+				customError("Function cannot use local variable '"..upvalue.."' declared outside it when traversing a CellularSpace in parallel.")
+			end
+
+			i = i + 1
+			upvalue = debug.getupvalue(_sof_, i)
+		end
+
+		return cpp_forEachCell(object, _sof_, parallel)
+	end
+
 	for i, cell in ipairs(object.cells) do
 		if _sof_(cell, i) == false then return false end
 	end
@@ -742,6 +786,30 @@ function forEachNeighbor(cell, name, _sof_)
 		incompatibleTypeError(3, "function", _sof_)
 	end
 
+	local index = cell.neighborhoods[name]
+	if getmetatable(index) == metaTableNeighborhoodIndex_ then
+		local position = index:position(cell)
+		local cells = index.cells
+		local neighbors = index.neighbors
+		local weights = index.weights
+
+		if index.edgeWeights then
+			for k = index.first[position], index.first[position + 1] - 1 do
+				if _sof_(cells[neighbors[k]], weights[k], cell) == false then return false end
+			end
+
+			return true
+		end
+
+		local weight = weights[position]
+
+		for k = index.first[position], index.first[position + 1] - 1 do
+			if _sof_(cells[neighbors[k]], weight, cell) == false then return false end
+		end
+
+		return true
+	end
+
 	local neighborhood = cell:getNeighborhood(name)
 	if neighborhood == nil then
 		if name == "1" then
@@ -604,6 +604,64 @@ return{
 		end
 
 		unitTest:assert(saveTifDirectory)
+
+		local saveColumnar = function()
+			local file = File("cellspace_save_alt.tmc"):deleteIfExists()
+			local cs = CellularSpace{xdim = 5}
+
+			forEachCell(cs, function(cell)
+				cell.value = 1
+			end)
+
+			local error_func = function()
+				cs:save(file, "value", "a")
+			end
+			unitTest:assertError(error_func, incompatibleTypeMsg(3, "number", "a"))
+
+			cs.cells[2].value = "a"
+
+			error_func = function()
+				cs:save(file, "value")
+			end
+			unitTest:assertError(error_func, "Attribute 'value' should have values of a single type, Cell '"..cs.cells[2]:getId().."' has a string.")
+
+			cs.cells[2].value = 1
+			cs:save(file, "value")
+
+			local small = CellularSpace{xdim = 2}
+
+			forEachCell(small, function(cell)
+				cell.value = 1
+			end)
+
+			error_func = function()
+				small:save(file, "value")
+			end
+			unitTest:assertError(error_func, "File '"..tostring(file).."' stores 25 cells, got 4.")
+
+			local other = CellularSpace{xdim = 5}
+			local firstId = other.cells[1]:getId()
+
+			forEachCell(other, function(cell)
+				cell.value = 1
+			end)
+
+			other.cells[1].id = "other"
+
+			error_func = function()
+				other:save(file, "value")
+			end
+			unitTest:assertError(error_func, "File '"..tostring(file).."' stores Cell '"..firstId.."' at position 1, got Cell 'other'.")
+
+			error_func = function()
+				CellularSpace{file = file, time = 5}
+			end
+			unitTest:assertError(error_func, "Time 5 was not saved in file '"..tostring(file).."'.")
+
+			file:delete()
+		end
+
+		unitTest:assert(saveColumnar)
 	end
 }
 
@@ -27,7 +27,7 @@ return{
 		local error_func = function()
 			DataFrame{file = "dump"}
 		end
-		unitTest:assertError(error_func, "File 'dump' does not have '.lua' extension.")
+		unitTest:assertError(error_func, "File 'dump' does not have '.lua' or '.tmc' extension.")
 
 		local file = File("dump.lua")
 
@@ -770,6 +770,25 @@ return{
 		end)
 
 		unitTest:assertEquals(count, 7)
+
+		-- loading the same file again maps its binary cache
+		cs1:loadNeighborhood{
+			file = filePath("cabecadeboi-neigh.gpm", "base"),
+			name = "cached"
+		}
+
+		forEachCell(cs1, function(cell)
+			local neighborhood = cell:getNeighborhood()
+			local cached = 0
+
+			forEachNeighbor(cell, "cached", function(neigh, weight)
+				unitTest:assertEquals(neighborhood:getWeight(neigh), weight)
+				cached = cached + 1
+			end)
+
+			unitTest:assertEquals(#neighborhood, cached)
+			unitTest:assertEquals(#neighborhood, #cell:getNeighborhood("cached"))
+		end)
 	end,
 	save = function(unitTest)
 		local gis = getPackage("gis")
@@ -1045,6 +1064,47 @@ return{
 		unitTest:assert(saveWithGeom)
 		unitTest:assert(saveWithMissing)
 		unitTest:assert(saveTifDirectory)
+
+		local saveColumnar = function()
+			local file = File("cellspace_save.tmc"):deleteIfExists()
+
+			local cs = CellularSpace{xdim = 5}
+
+			forEachCell(cs, function(cell)
+				cell.value = cell.x + cell.y
+				cell.cover = "forest"
+				cell.region = "Amazônia"
+				cell.burned = false
+			end)
+
+			cs:save(file)
+
+			forEachCell(cs, function(cell)
+				cell.value = cell.value * 2
+				cell.burned = cell.x > 2
+			end)
+
+			cs:save(file, {"value", "burned"}, 10)
+
+			local first = CellularSpace{file = file, time = 1}
+
+			unitTest:assertEquals(#first, 25)
+			unitTest:assertEquals(first:get(3, 4).value, 7)
+			unitTest:assertEquals(first:get(3, 4).cover, "forest")
+			unitTest:assertEquals(first:get(3, 4).region, "Amazônia")
+			unitTest:assert(not first:get(3, 4).burned)
+
+			local last = CellularSpace{file = file}
+
+			unitTest:assertEquals(#last, 25)
+			unitTest:assertEquals(last:get(3, 4).value, 14)
+			unitTest:assert(last:get(3, 4).burned)
+			unitTest:assertNil(last:get(3, 4).cover)
+
+			file:delete()
+		end
+
+		unitTest:assert(saveColumnar)
 	end,
 	synchronize = function(unitTest)
 		local gis = getPackage("gis")
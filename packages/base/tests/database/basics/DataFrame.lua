@@ -43,6 +43,27 @@ return{
 		end
 
 		File(filename):deleteIfExists()
+
+		local file = File("dump.tmc"):deleteIfExists()
+		local cs = CellularSpace{xdim = 3}
+
+		forEachCell(cs, function(cell)
+			cell.value = cell.x * 10 + cell.y
+		end)
+
+		cs:save(file, "value", 2000)
+
+		actual = DataFrame{file = file, time = 2000}
+
+		unitTest:assertEquals(#actual, 9)
+
+		for i = 1, 9 do
+			unitTest:assertEquals(actual[i].id, cs.cells[i].id)
+			unitTest:assertEquals(actual.x[i], cs.cells[i].x)
+			unitTest:assertEquals(actual[i].value, cs.cells[i].value)
+		end
+
+		file:delete()
 	end,
 	save = function(unitTest)
 		local filename1 = "dump.lua"
@@ -765,6 +765,18 @@ return{
 		end
 
 		unitTest:assertError(error_func, "Argument 'values' should contain only strings.")
+
+		error_func = function()
+			cs:synchronize("height_", 1)
+		end
+
+		unitTest:assertError(error_func, incompatibleTypeMsg(2, "boolean", 1))
+
+		error_func = function()
+			cs:synchronize({123, "height_"}, true)
+		end
+
+		unitTest:assertError(error_func, "Argument 'values' should contain only strings.")
 	end
 }
 
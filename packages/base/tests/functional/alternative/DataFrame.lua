@@ -105,6 +105,45 @@ return{
 		end
 		unitTest:assertError(error_func, "Argument 'instance' should be an isTable() object, got number.")
 	end,
+	filter = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3}}
+
+		local error_func = function()
+			df:filter("z", 2)
+		end
+		unitTest:assertError(error_func, "Column 'z' does not exist in the DataFrame.")
+
+		error_func = function()
+			df:filter("x")
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(2))
+	end,
+	mean = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3}}
+
+		local error_func = function()
+			df:mean(2)
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg(1, "string", 2))
+
+		error_func = function()
+			df:mean("x", "y")
+		end
+		unitTest:assertError(error_func, "Column 'y' does not exist in the DataFrame.")
+	end,
+	sum = function(unitTest)
+		local df = DataFrame{x = {1, 2, 3}, y = {"a", "b", "c"}}
+
+		local error_func = function()
+			df:sum()
+		end
+		unitTest:assertError(error_func, mandatoryArgumentMsg(1))
+
+		error_func = function()
+			df:sum("y")
+		end
+		unitTest:assertError(error_func, "Column 'y' should contain only numbers, got string.")
+	end,
 	__index = function(unitTest)
 		local df = DataFrame{}
 
@@ -101,6 +101,24 @@ return{
 		end
 
 		unitTest:assertError(error_func, "Sum should be one, got 0.9.")
+
+		error_func = function()
+			Random{stream = "1"}
+		end
+
+		unitTest:assertError(error_func, incompatibleTypeMsg("stream", "number", "1"))
+
+		error_func = function()
+			Random{stream = 1.5}
+		end
+
+		unitTest:assertError(error_func, integerArgumentMsg("stream", 1.5))
+
+		error_func = function()
+			Random{stream = -1}
+		end
+
+		unitTest:assertError(error_func, positiveArgumentMsg("stream", -1, true))
 	end,
 	integer = function(unitTest)
 		local randomObj = Random{}
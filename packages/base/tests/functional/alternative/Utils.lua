@@ -128,6 +128,33 @@ return{
 		end
 
 		unitTest:assertError(error_func, incompatibleTypeMsg(2, "function"))
+
+		local cs = CellularSpace{xdim = 5}
+
+		error_func = function()
+			forEachCell(cs, function() end, "4")
+		end
+
+		unitTest:assertError(error_func, incompatibleTypeMsg(3, "boolean or number", "4"))
+
+		error_func = function()
+			forEachCell(cs, function() end, 0)
+		end
+
+		unitTest:assertError(error_func, positiveArgumentMsg(3, 0))
+
+		error_func = function()
+			forEachCell(Trajectory{target = cs}, function() end, 2)
+		end
+
+		unitTest:assertError(error_func, "Only a CellularSpace can be traversed in parallel, got Trajectory.")
+
+		local sum = 0
+		error_func = function()
+			forEachCell(cs, function(cell) sum = sum + cell.x end, 2)
+		end
+
+		unitTest:assertError(error_func, "Function cannot use local variable 'sum' declared outside it when traversing a CellularSpace in parallel.")
 	end,
 	forEachCellPair = function(unitTest)
 		local cs1 = CellularSpace{xdim = 10}
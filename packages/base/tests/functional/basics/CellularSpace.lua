@@ -1458,6 +1458,35 @@ ydim    number [20]
 			m = 5,
 			name = "3"
 		}
+
+		-- traversing the neighbors before getting the Neighborhood
+		cs = CellularSpace{xdim = 4, ydim = 3}
+
+		cs:createNeighborhood{wrap = true}
+		cs:createNeighborhood{
+			strategy = "function",
+			name = "2",
+			filter = function(cell, neigh)
+				local dx = math.abs(cell.x - neigh.x)
+				local dy = math.abs(cell.y - neigh.y)
+				return cell ~= neigh and (dx <= 1 or dx == 3) and (dy <= 1 or dy == 2)
+			end,
+			weight = function() return 1 / 8 end
+		}
+
+		forEachCell(cs, function(cell)
+			local count = 0
+
+			forEachNeighbor(cell, function(neigh, weight)
+				unitTest:assertEquals(1 / 8, weight)
+				unitTest:assertEquals(weight, cell:getNeighborhood("2"):getWeight(neigh))
+				count = count + 1
+			end)
+
+			unitTest:assertEquals(8, count)
+			unitTest:assertEquals(8, #cell:getNeighborhood())
+			unitTest:assert(not cell:getNeighborhood():isNeighbor(cell))
+		end)
 	end,
 	cut = function(unitTest)
 		local cs = CellularSpace{xdim = 10}
@@ -1757,6 +1786,30 @@ ydim    number [20]
 
 		forEachCell(cs, function(cell) unitTest:assertEquals(3, cell.past.value) end)
 		forEachCell(cs, function(cell) unitTest:assertEquals(0, cell.value) end)
+
+		cs = CellularSpace{xdim = 5}
+		forEachCell(cs, function(cell) cell.cover = "forest" cell.value = 1 end)
+
+		cs:synchronize(nil, true)
+		forEachCell(cs, function(cell) unitTest:assertEquals("forest", cell.past.cover) end)
+		forEachCell(cs, function(cell) unitTest:assertEquals(1, cell.past.value) end)
+
+		local past = cs.cells[1].past
+		forEachCell(cs, function(cell, i) cell.value = i end)
+
+		cs:synchronize("value", true)
+		unitTest:assertEquals(cs.cells[1].past, past)
+		forEachCell(cs, function(cell, i) unitTest:assertEquals(i, cell.past.value) end)
+		forEachCell(cs, function(cell) unitTest:assertNil(cell.past.cover) end)
+
+		local count = 0
+		forEachElement(cs.cells[3].past, function(idx, value)
+			unitTest:assertEquals(idx, "value")
+			unitTest:assertEquals(value, 3)
+			count = count + 1
+		end)
+
+		unitTest:assertEquals(count, 1)
 	end
 }
 
@@ -167,6 +167,66 @@ return{
 		unitTest:assert(cols.y)
 		unitTest:assertEquals(getn(cols), 2)
 	end,
+	filter = function(unitTest)
+		local df = DataFrame{
+			cover = {"forest", "pasture", "forest", "water", "forest"},
+			area = {10, 20, 5, 3, 2},
+			protected = {true, false, false, true, true}
+		}
+
+		local forest = df:filter("cover", "forest")
+
+		unitTest:assertType(forest, "DataFrame")
+		unitTest:assertEquals(#forest, 3)
+		unitTest:assertEquals(forest[2].area, 5)
+		unitTest:assertEquals(forest.protected[3], true)
+
+		local protected = df:filter("protected", true)
+		unitTest:assertEquals(#protected, 3)
+		unitTest:assertEquals(protected.cover[2], "water")
+
+		local large = df:filter("area", function(value) return value >= 10 end)
+		unitTest:assertEquals(#large, 2)
+		unitTest:assertEquals(large[2].cover, "pasture")
+
+		local empty = df:filter("cover", "urban")
+		unitTest:assertEquals(#empty, 0)
+
+		df = DataFrame{
+			{x = 1, y = "a"},
+			{x = 2, y = "b"},
+			{x = 3, y = "a"},
+			first = 2000,
+			step = 10
+		}
+
+		local a = df:filter("y", "a")
+		unitTest:assertEquals(#a, 2)
+		unitTest:assertEquals(a[2].x, 3)
+	end,
+	mean = function(unitTest)
+		local df = DataFrame{
+			cover = {"forest", "pasture", "forest", "water", "forest"},
+			area = {10, 20, 6, 3, 2}
+		}
+
+		unitTest:assertEquals(df:mean("area"), 8.2)
+
+		local means = df:mean("area", "cover")
+		unitTest:assertEquals(means.forest, 6)
+		unitTest:assertEquals(means.pasture, 20)
+		unitTest:assertEquals(means.water, 3)
+
+		df = DataFrame{
+			{x = 1, y = 1},
+			{x = 2, y = 1},
+			{x = 3.5, y = 2},
+			first = 0
+		}
+
+		unitTest:assertEquals(df:mean("x"), 6.5 / 3, 0.00001)
+		unitTest:assertEquals(df:mean("x", "y")[2], 3.5)
+	end,
 	remove = function(unitTest)
 		local df = DataFrame{
 			{x = 1, y = 1},
@@ -181,6 +241,16 @@ return{
 		df:remove(3)
 		unitTest:assertEquals(#df, 4)
 		unitTest:assertEquals(df[3].x, 4)
+
+		df = DataFrame{
+			x = {1, 2, 3, 4, 5},
+			y = {"a", "b", "c", "d", "e"}
+		}
+
+		df:remove(2)
+		unitTest:assertEquals(df[2].x, 3)
+		unitTest:assertEquals(df.y[4], "e")
+		unitTest:assertNil(df.y[5])
 	end,
 	rows = function(unitTest)
 		local df = DataFrame{
@@ -199,6 +269,43 @@ return{
 
 		unitTest:assertEquals(#rows, 5)
 	end,
+	sum = function(unitTest)
+		local df = DataFrame{
+			cover = {"forest", "pasture", "forest", "water", "forest"},
+			area = {10, 20, 6, 3, 2},
+			cost = {1.5, 2, 0.5, 1, 1}
+		}
+
+		unitTest:assertEquals(df:sum("area"), 41)
+		unitTest:assertEquals(df:sum("cost"), 6)
+
+		local sums = df:sum("area", "cover")
+		unitTest:assertEquals(sums.forest, 18)
+		unitTest:assertEquals(sums.pasture, 20)
+		unitTest:assertEquals(sums.water, 3)
+		unitTest:assertEquals(getn(sums), 3)
+
+		local values = {}
+		local parity = {}
+		for i = 1, 10000 do
+			values[i] = i
+			parity[i] = i % 2 == 0
+		end
+
+		df = DataFrame{value = values, even = parity}
+
+		unitTest:assertEquals(df:sum("value"), 50005000)
+		unitTest:assertEquals(df:sum("value", "even")[true], 25005000)
+		unitTest:assertEquals(df:sum("value", "even")[false], 25000000)
+
+		df.value[2] = 2.5
+		df:add{value = 10001, even = false}
+
+		unitTest:assertEquals(df.value[2], 2.5)
+		unitTest:assertEquals(df[10001].value, 10001)
+		unitTest:assertEquals(df:sum("value"), 50015001.5)
+		unitTest:assertEquals(df:sum("value", "even")[true], 25005000.5)
+	end,
 	__index = function(unitTest)
 		local df = DataFrame{
 			{x = 1, y = 1},
@@ -238,6 +238,9 @@ return{
 		unitTest:assertType(csv, "DataFrame")
 		unitTest:assertEquals(4, #csv)
 		unitTest:assertEquals(20, csv[1].age)
+		unitTest:assertEquals(500, csv.wealth[3])
+		unitTest:assertEquals("fred", csv[4].name)
+		unitTest:assertEquals("true", csv[4].immune)
 
 		local s = sessionInfo().separator
 		file = filePath("test/error"..s.."csv-error.csv")
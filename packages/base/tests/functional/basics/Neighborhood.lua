@@ -139,6 +139,8 @@ weights      vector of size 0
 		neigh:remove(cell1)
 		unitTest:assertEquals(#neigh, 2)
 		unitTest:assert(not neigh:isNeighbor(cell1))
+		unitTest:assert(neigh:isNeighbor(cell3))
+		unitTest:assertEquals(neigh:getWeight(cell3), 1)
 
 		neigh:remove(cell2)
 		unitTest:assertEquals(#neigh, 1)
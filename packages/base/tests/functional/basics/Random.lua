@@ -197,6 +197,47 @@ return {
 		unitTest:assertEquals(modelBeta:mean(modelBeta.data), modelBeta:mean(modelBeta.expected), 0.02)
 		unitTest:assertEquals(modelBeta:sd(modelBeta.data), modelBeta:sd(modelBeta.expected), 0.02)
 		unitTest:assertEquals(modelBeta:meanSquaredError(modelBeta.data, modelBeta.expected), 0, 0.02)
+
+		Random{seed = 987654321}
+
+		local worker1 = Random{stream = 1}
+		local worker2 = Random{stream = 2}
+
+		unitTest:assertEquals(worker1.stream, 1)
+		unitTest:assertEquals(worker1.distrib, "none")
+		unitTest:assertEquals(worker1:number(), 0.849, 0.001)
+		unitTest:assertEquals(worker1:integer(3), 3)
+		unitTest:assertEquals(worker1:integer(3), 0)
+		unitTest:assertEquals(worker2:number(), 0.362, 0.001)
+
+		local same = true
+		local different = false
+		worker1 = Random{stream = 1}
+		worker2 = Random{stream = 1}
+		local worker3 = Random{stream = 3}
+
+		for _ = 1, 2500 do
+			local value = worker1:number()
+			if value ~= worker2:number() then same = false end
+			if value ~= worker3:number() then different = true end
+		end
+
+		unitTest:assert(same)
+		unitTest:assert(different)
+
+		local normal = Random{mean = 5, sd = 2, stream = 4}
+		local values = {}
+		for _ = 1, 5000 do
+			table.insert(values, normal:sample())
+		end
+
+		unitTest:assertEquals(normal.distrib, "normal")
+		unitTest:assertEquals(modelNormal:mean(values), 5, 0.1)
+		unitTest:assertEquals(modelNormal:sd(values), 2, 0.1)
+
+		local cover = Random{"pasture", "forest", "clearcut", stream = 5}
+		unitTest:assertEquals(cover.distrib, "discrete")
+		unitTest:assert(belong(cover:sample(), {"pasture", "forest", "clearcut"}))
 	end,
 	__tostring = function(unitTest)
 		local bern = Random{p = 0.3}
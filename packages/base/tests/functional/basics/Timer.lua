@@ -129,6 +129,30 @@ return {
 		}
 
 		unitTest:assertEquals(#timer:getEvents(), 2)
+
+		local executed = {}
+		timer = Timer{}
+
+		for i = 1, 20 do
+			timer:add(Event{start = i % 3, priority = i % 2, period = false, action = function()
+				table.insert(executed, i)
+			end})
+		end
+
+		local events = timer:getEvents()
+		unitTest:assertEquals(#events, 20)
+
+		for i = 2, #events do
+			local ev1 = events[i - 1]
+			local ev2 = events[i]
+
+			unitTest:assert(ev1.time < ev2.time or (ev1.time == ev2.time and ev1.priority <= ev2.priority))
+		end
+
+		timer:run(5)
+
+		unitTest:assertEquals(#executed, 20)
+		unitTest:assertEquals(table.concat(executed, " "), "6 12 18 3 9 15 4 10 16 1 7 13 19 2 8 14 20 5 11 17")
 	end,
 	__len = function(unitTest)
 		local timer = Timer{
@@ -276,6 +276,40 @@ return{
 		end)
 
 		unitTest:assertEquals(r, 40)
+
+		cs = CellularSpace{xdim = 10, instance = Cell{value = 1}}
+		cs:createNeighborhood()
+		cs:synchronize()
+
+		r = forEachCell(cs, function(cell, i)
+			cell.position = i
+			cell.value = 0
+			forEachNeighbor(cell, function(neighbor)
+				cell.value = cell.value + neighbor.past.value
+			end)
+		end, 4)
+
+		unitTest:assert(r)
+		unitTest:assertEquals(cs:get(0, 0).value, 3)
+		unitTest:assertEquals(cs:get(5, 5).value, 8)
+		unitTest:assertEquals(cs:get(5, 5).past.value, 1)
+
+		forEachCell(cs, function(cell, i)
+			unitTest:assertEquals(cell.position, i)
+		end)
+
+		forEachCell(cs, function(cell)
+			if cell.x > 4 then cell.position = nil end
+		end, 4)
+
+		unitTest:assertEquals(cs:get(4, 0).position, 41)
+		unitTest:assertNil(cs:get(5, 0).position)
+
+		r = forEachCell(cs, function(cell)
+			if cell.x == 5 then return false end
+		end, true)
+
+		unitTest:assert(not r)
 	end,
 	forEachCellPair = function(unitTest)
 		local cs1 = CellularSpace{xdim = 10}
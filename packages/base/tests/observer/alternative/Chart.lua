@@ -133,6 +133,24 @@ return{
 
 		unitTest:assertError(error_func, positiveArgumentMsg("size", -3))
 
+		error_func = function()
+			Chart{target = cell, select = "value1", capacity = -1}
+		end
+
+		unitTest:assertError(error_func, positiveArgumentMsg("capacity", -1, true))
+
+		error_func = function()
+			Chart{target = cell, select = "value1", capacity = 2.5}
+		end
+
+		unitTest:assertError(error_func, integerArgumentMsg("capacity", 2.5))
+
+		error_func = function()
+			Chart{target = cell, select = "value1", resolution = 0}
+		end
+
+		unitTest:assertError(error_func, positiveArgumentMsg("resolution", 0))
+
 		error_func = function()
 			Chart{target = Environment{}, select = "value1"}
 		end
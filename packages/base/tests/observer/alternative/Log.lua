@@ -72,6 +72,21 @@ return{
 		end
 		unitTest:assertError(error_func, incompatibleTypeMsg("separator", "string", 2))
 
+		error_func = function()
+			Log{target = c, flush = "2"}
+		end
+		unitTest:assertError(error_func, incompatibleTypeMsg("flush", "number", "2"))
+
+		error_func = function()
+			Log{target = c, flush = 2.5}
+		end
+		unitTest:assertError(error_func, integerArgumentMsg("flush", 2.5))
+
+		error_func = function()
+			Log{target = c, flush = 0}
+		end
+		unitTest:assertError(error_func, positiveArgumentMsg("flush", 0))
+
 		local unit = Cell{}
 
 		error_func = function()
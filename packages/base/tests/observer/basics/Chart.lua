@@ -415,6 +415,21 @@ return{
 
 		unitTest:assertEquals(data[2].count, 2)
 		unitTest:assertEquals(data[2].mCount_, 3)
+
+		local cell = Cell{value = 0}
+
+		c1 = Chart{target = cell, capacity = 3, resolution = 10}
+
+		for time = 1, 5 do
+			cell.value = time * 2
+			c1:update(time)
+		end
+
+		data = c1:getData()
+		unitTest:assertEquals(getn(data:rows()), 3)
+		unitTest:assertNil(data[2].value)
+		unitTest:assertEquals(data[3].value, 6)
+		unitTest:assertEquals(data[5].value, 10)
 	end,
 	update = function(unitTest)
 		local world = Cell{
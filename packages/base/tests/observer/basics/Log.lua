@@ -168,6 +168,22 @@ return{
 		log:update()
 
 		unitTest:assertFile("logfile-update.csv")
+	end,
+	flush = function(unitTest)
+		local world = Cell{
+			count = 0
+		}
+
+		local log = Log{target = world, file = "logfile-flush.csv", flush = 3}
+
+		for _ = 1, 4 do
+			log:update()
+			world.count = world.count + 1
+		end
+
+		log:flush()
+
+		unitTest:assertFile("logfile-flush.csv")
 	end
 }
 
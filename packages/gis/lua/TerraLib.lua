@@ -32,7 +32,20 @@ local instance = nil
 local dataCache = makeWeakTable{}
 local progress = false
 
-require("swig")
+local qgisModule
+
+-- QGIS support is loaded on first use, as TerraLib.
+local function getQGis()
+	if not qgisModule then
+		_Gtme.loadComponent("QGIS support", function()
+			require("swig")
+		end)
+
+		qgisModule = swig.terrame.qgis
+	end
+
+	return qgisModule
+end
 
 local function getCache(level1, level2, level3)
 	-- level1 is compulsory. The other ones are optional.
@@ -79,26 +92,27 @@ local function addCache(value, level1, level2, level3)
 end
 
 -- Raster operations must be added in SWIG TerraLib AttributeFill.i
--- on RasterToVector::setParams()
+-- on RasterToVector::setParams(). The values are the names of the constants of the binding,
+-- which are taken only when the operations are executed, as TerraLib is loaded on first use.
 local OperationMapper = {
-	value = binding.VALUE_OPERATION,
-	area = binding.PERCENT_TOTAL_AREA,
-	presence = binding.PRESENCE,
-	count = binding.COUNT,
-	distance = binding.MIN_DISTANCE_CENTROID,
-	minimum = binding.MIN_VALUE,
-	maximum = binding.MAX_VALUE,
-	mode = binding.MODE,
-	coverage = binding.PERCENT_EACH_CLASS,
-	total = binding.TOTAL_AREA_BY_CLASS,
-	stdev = binding.STANDARD_DEVIATION,
-	mean = binding.MEAN,
-	weighted = binding.WEIGHTED,
-	intersection = binding.HIGHEST_INTERSECTION,
-	occurrence = binding.MODE,
-	sum = binding.SUM,
-	wsum = binding.WEIGHTED_SUM,
-	median = binding.MEDIAN
+	value = "VALUE_OPERATION",
+	area = "PERCENT_TOTAL_AREA",
+	presence = "PRESENCE",
+	count = "COUNT",
+	distance = "MIN_DISTANCE_CENTROID",
+	minimum = "MIN_VALUE",
+	maximum = "MAX_VALUE",
+	mode = "MODE",
+	coverage = "PERCENT_EACH_CLASS",
+	total = "TOTAL_AREA_BY_CLASS",
+	stdev = "STANDARD_DEVIATION",
+	mean = "MEAN",
+	weighted = "WEIGHTED",
+	intersection = "HIGHEST_INTERSECTION",
+	occurrence = "MODE",
+	sum = "SUM",
+	wsum = "WEIGHTED_SUM",
+	median = "MEDIAN"
 }
 
 local VectorAttributeCreatedMapper = {
@@ -568,7 +582,7 @@ local function getLayersToAddFromQGis(qgp, layers)
 end
 
 local function setQGisLayerAttributesToSave(qgp, layersToAdd)
-	local qgis = swig.terrame.qgis
+	local qgis = getQGis()
 	for i = 1, #layersToAdd do
 		local layer = layersToAdd[i]
 		local qgisLayer = qgis.QGisLayer()
@@ -603,7 +617,7 @@ local function setQGisLayerAttributesToSave(qgp, layersToAdd)
 end
 
 local function saveQGisProject(qgsfile, projfile, title)
-	local qgis = swig.terrame.qgis
+	local qgis = getQGis()
 
 	local qgp
 	if File(qgsfile):exists() then
@@ -910,7 +924,7 @@ local function vectorToVector(data)
 		local toDs = makeAndOpenDataSource(toConnInfo:getConnInfo(), toConnInfo:getType())
 		local toDst = toDs:getDataSetType(toDSetName)
 
-		v2v:setParams(data.select, OperationMapper[op], toDst)
+		v2v:setParams(data.select, binding[OperationMapper[op]], toDst)
 
 		local viewerId = createProgressViewer("Creating attribute '"..data.attribute
 												.."' using operation '"..data.operation.."'")
@@ -970,7 +984,7 @@ local function rasterToVector(data)
 			op = "total"
 		end
 
-		r2v:setParams(data.select, OperationMapper[op], data.pixel, false, true) -- TODO: ITERATOR BY BOX, TEXTURE, READALL PARAMS (REVIEW)
+		r2v:setParams(data.select, binding[OperationMapper[op]], data.pixel, false, true) -- TODO: ITERATOR BY BOX, TEXTURE, READALL PARAMS (REVIEW)
 
 		local outDs = r2v:createAndSetOutput(data.out.dseName, data.out.type, data.out.connInfo)
 
@@ -1154,7 +1168,7 @@ local function removeDataSource(project, dsId)
 end
 
 local function removeQGisLayer(qgsfile, layerName)
-	local qgis = swig.terrame.qgis
+	local qgis = getQGis()
 	local qgp = qgis.QGis.getInstance():read(tostring(qgsfile))
 	local layers = qgp:getLayers()
 
@@ -2083,7 +2097,7 @@ local function getWfsUri(uri)
 end
 
 local function createProjectFromQGis(project)
-	local qgis = swig.terrame.qgis
+	local qgis = getQGis()
 
 	if project.user and project.password then
 		qgis.QGis.getInstance():setPostgisRole(project.user, project.password)
@@ -2236,7 +2250,7 @@ TerraLib_ = {
 	-- @usage import("gis")
 	-- print(TerraLib().getVersion())
 	getVersion = function()
-		return binding.te.common.Version.asString()
+		return _Gtme.loadTerraLib().te.common.Version.asString()
 	end,
 	--- Create a new Project.
 	-- @arg project The name of the project.
@@ -3543,13 +3557,13 @@ TerraLib_ = {
 	-- nd = TerraLib().random().NormalDistribution(mt, 1, 6)
 	-- print(nd())
 	random = function()
-		return binding.te.random
+		return _Gtme.loadTerraLib().te.random
 	end,
 	--- Return a handle to TerraLib Geometry Objects.
 	-- @usage -- DONTRUN
 	-- TerraLib().geometry().Point(0, 0)
 	geometry = function()
-		return binding.te.gm
+		return _Gtme.loadTerraLib().te.gm
 	end,
 	--- Creates a polygonized data using GDALPolygonize().
 	-- @arg rasterInfo A table with input Raster layer information.
@@ -50,6 +50,10 @@ namespace terrame
 
 				virtual int pushGlobalByName(lua_State* L, const std::string& name) = 0;
 				virtual int pushTableAt(lua_State* L, int index) = 0;
+				virtual int pushIndexAt(lua_State* L, int index, long long i) = 0;
+				virtual void setIndexAt(lua_State* L, int index, long long i) = 0;
+				virtual int pushFieldAt(lua_State* L, int index, const std::string& name) = 0;
+				virtual void setFieldAt(lua_State* L, int index, const std::string& name) = 0;
 
 				virtual void pop(lua_State* L, int numberOfElements) = 0;
 				virtual void popOneElement(lua_State* L) = 0;
@@ -92,6 +96,7 @@ namespace terrame
 				virtual void callWarning(lua_State* L, const std::string& msg) = 0;
 
 				virtual int createWeakTable(lua_State *L) = 0;
+				virtual void createTable(lua_State *L, int arraySize, int hashSize) = 0;
 
 				virtual void setReference(lua_State* L, int ref, const void* p) = 0;
 				virtual void getReference(lua_State* L, int ref, const void* p) = 0;
@@ -71,6 +71,26 @@ int terrame::lua::LuaFacade::pushTableAt(lua_State* L, int index)
 	return lua_gettable(L, index);
 }
 
+int terrame::lua::LuaFacade::pushIndexAt(lua_State* L, int index, long long i)
+{
+	return lua_rawgeti(L, index, (lua_Integer)i);
+}
+
+void terrame::lua::LuaFacade::setIndexAt(lua_State* L, int index, long long i)
+{
+	lua_rawseti(L, index, (lua_Integer)i);
+}
+
+int terrame::lua::LuaFacade::pushFieldAt(lua_State* L, int index, const std::string& name)
+{
+	return lua_getfield(L, index, name.c_str());
+}
+
+void terrame::lua::LuaFacade::setFieldAt(lua_State* L, int index, const std::string& name)
+{
+	lua_setfield(L, index, name.c_str());
+}
+
 void terrame::lua::LuaFacade::pop(lua_State* L, int numberOfElements)
 {
 	lua_pop(L, numberOfElements);
@@ -288,6 +308,11 @@ int terrame::lua::LuaFacade::createWeakTable(lua_State *L)
     return luaL_ref(L, LUA_REGISTRYINDEX);
 }
 
+void terrame::lua::LuaFacade::createTable(lua_State *L, int arraySize, int hashSize)
+{
+	lua_createtable(L, arraySize, hashSize);
+}
+
 void terrame::lua::LuaFacade::setReference(lua_State* L, int ref, const void* p)
 {
     lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
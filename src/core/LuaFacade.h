@@ -51,6 +51,10 @@ namespace terrame
 
 				int pushGlobalByName(lua_State* L, const std::string& name);
 				int pushTableAt(lua_State* L, int index);
+				int pushIndexAt(lua_State* L, int index, long long i);
+				void setIndexAt(lua_State* L, int index, long long i);
+				int pushFieldAt(lua_State* L, int index, const std::string& name);
+				void setFieldAt(lua_State* L, int index, const std::string& name);
 
 				void pop(lua_State* L, int numberOfElements);
 				void popOneElement(lua_State* L);
@@ -93,6 +97,7 @@ namespace terrame
 				void callWarning(lua_State* L, const std::string& msg);
 
 				int createWeakTable(lua_State *L);
+				void createTable(lua_State *L, int arraySize, int hashSize);
 
 				void setReference(lua_State* L, int ref, const void* p);
 				void getReference(lua_State* L, int ref, const void* p);
@@ -70,6 +70,108 @@ class CellularSpace : public Model, public CellularSpaceInterf, public Cell,
 					public Region_<CellIndex>
 {
 public:
+    /// Constructor
+    CellularSpace() : gridXMin_(0), gridYMin_(0), gridXDim_(0), gridYDim_(0), gridCells_(0) {}
+
+    /// Adds a cell to the cellular space. Cells inside the dense grid are also
+    /// stored in it.
+    /// \param indx is the (x, y) cell coordinate
+    /// \param cell is a pointer to the cell being inserted
+    void add(CellIndex indx, Cell* cell) {
+        Region_<CellIndex>::add(indx, cell);
+        gridInsert(indx, cell);
+    }
+
+    /// Removes the cell with the given coordinate, also from the dense grid.
+    /// \param indx is the (x, y) cell coordinate
+    bool erase(CellIndex indx) {
+        gridRemove(indx);
+        return Region_<CellIndex>::erase(indx);
+    }
+
+    /// Removes the cell pointed by an iterator, also from the dense grid.
+    /// \param itr is an iterator of the cellular space
+    iterator erase(iterator itr) {
+        gridRemove(itr->first, itr->second);
+        return Region_<CellIndex>::erase(itr);
+    }
+
+    /// Removes all the cells of the cellular space, including the dense grid.
+    void clear() {
+        Region_<CellIndex>::clear();
+        grid_.clear();
+        gridXDim_ = 0;
+        gridYDim_ = 0;
+        gridCells_ = 0;
+    }
+
+    /// Declares the cellular space as a regular grid of xDim x yDim cells starting
+    /// at (xMin, yMin). Cells inside the grid are stored in a contiguous row-major array
+    /// of pointers and can be found in constant time. Cells already added are moved into the grid.
+    /// \param xMin is the smallest x coordinate
+    /// \param yMin is the smallest y coordinate
+    /// \param xDim is the number of columns
+    /// \param yDim is the number of lines
+    void setGrid(int xMin, int yMin, int xDim, int yDim) {
+        gridXMin_ = xMin;
+        gridYMin_ = yMin;
+        gridXDim_ = xDim > 0 ? xDim : 0;
+        gridYDim_ = yDim > 0 ? yDim : 0;
+        gridCells_ = 0;
+        grid_.assign((size_t) gridXDim_ * gridYDim_, (Cell*) NULL);
+
+        Region_<CellIndex>::iterator theIterator;
+        theIterator = Region_<CellIndex>::pImpl_->begin();
+        while (theIterator != Region_<CellIndex>::pImpl_->end())
+        {
+            gridInsert(theIterator->first, theIterator->second);
+            theIterator++;
+        }
+    }
+
+    /// Returns whether all the cells of the cellular space are stored in the dense grid,
+    /// so that they can be traversed through it instead of the region index.
+    bool isDense() {
+        return gridCells_ > 0 && gridCells_ == Region_<CellIndex>::size();
+    }
+
+    /// Calls a function for each cell of the cellular space. Dense cellular spaces are
+    /// traversed through the contiguous grid, line by line (row-major order); the other ones
+    /// through the region index.
+    /// \param func is a function or function object that takes a Cell pointer
+    template <class Function>
+    void forEachCell(Function func) {
+        if (isDense())
+        {
+            for (size_t i = 0; i < grid_.size(); i++)
+                if (grid_[i] != NULL)
+                    func(grid_[i]);
+            return;
+        }
+
+        Region_<CellIndex>::iterator theIterator;
+        theIterator = Region_<CellIndex>::pImpl_->begin();
+        while (theIterator != Region_<CellIndex>::pImpl_->end())
+        {
+            func(theIterator->second);
+            theIterator++;
+        }
+    }
+
+    /// Searches for a cell. Cells inside the dense grid are found in constant time,
+    /// the other ones in the region index.
+    /// \param indx is the (x, y) cell coordinate
+    /// \return a Cell pointer if the cell has been found, otherwise returns a NULL pointer
+    Cell* getCell(const CellIndex& indx) {
+        int position = gridPosition(indx);
+        if (position >= 0 && grid_[position] != NULL)
+            return grid_[position];
+
+        Region_<CellIndex>::iterator theIterator = Region_<CellIndex>::find(indx);
+        if (theIterator != Region_<CellIndex>::end())
+            return theIterator->second;
+        return NULL;
+    }
     /// Attaches agent to all cellular space cell.
     /// \param agent is new agent being inserted into the cellular space
     void attachAgent(class LocalAgent *agent) {
@@ -83,46 +185,151 @@ public:
         detachControlModeFromCells(agent);
     }
 
+    /// Returns the number of columns of the dense grid (zero when the cellular space is not regular).
+    int getGridXDim() const { return gridXDim_; }
+
+    /// Returns the number of lines of the dense grid (zero when the cellular space is not regular).
+    int getGridYDim() const { return gridYDim_; }
+
+    /// Builds the neighborhoods of all the cells of the dense grid from a stencil of relative
+    /// positions, in compressed sparse row form. The neighbors of the cell in grid position p
+    /// are neighbors[first[p]] to neighbors[first[p + 1] - 1], all of them with weight weights[p].
+    /// Repeated neighbors (possible when wrapping small grids) are stored only once.
+    /// \param dxs the x offsets of the stencil
+    /// \param dys the y offsets of the stencil, with the same size of dxs
+    /// \param wrap whether the offsets wrap around the borders of the grid
+    /// \param average if true the weight is one divided by the number of offsets that
+    /// fall inside the grid, otherwise it is one
+    /// \param first receives the size of the grid plus one offsets into neighbors
+    /// \param neighbors receives the grid positions of the neighbors
+    /// \param weights receives the weight of each cell
+    void buildStencilNeighborhood(const vector<int>& dxs, const vector<int>& dys, bool wrap, bool average,
+                                  vector<int>& first, vector<int>& neighbors, vector<double>& weights) {
+        int cells = gridXDim_ * gridYDim_;
+        vector<int> stamp(cells, -1);
+
+        first.assign(cells + 1, 0);
+        weights.assign(cells, 1.0);
+        neighbors.clear();
+        neighbors.reserve((size_t) cells * dxs.size());
+
+        for (int col = 0; col < gridXDim_; col++)
+        {
+            for (int lin = 0; lin < gridYDim_; lin++)
+            {
+                int position = col * gridYDim_ + lin;
+                int found = 0;
+                first[position] = (int) neighbors.size();
+
+                for (size_t i = 0; i < dxs.size(); i++)
+                {
+                    int x = col + dxs[i];
+                    int y = lin + dys[i];
+
+                    if (wrap)
+                    {
+                        x = ((x % gridXDim_) + gridXDim_) % gridXDim_;
+                        y = ((y % gridYDim_) + gridYDim_) % gridYDim_;
+                    }
+                    else if (x < 0 || x >= gridXDim_ || y < 0 || y >= gridYDim_)
+                        continue;
+
+                    found++;
+                    int neighbor = x * gridYDim_ + y;
+                    if (stamp[neighbor] != position)
+                    {
+                        stamp[neighbor] = position;
+                        neighbors.push_back(neighbor);
+                    }
+                }
+
+                if (average)
+                    weights[position] = 1.0 / found;
+            }
+        }
+
+        first[cells] = (int) neighbors.size();
+    }
+
     /// Updates than cellular space past copying the current value of all cells attributes over the past values.
     /// \param sizeMem is the size (in bytes) of the cell with all its attributes, including the ones defined
     /// in TerraME framework application layer.
     void synchronize(unsigned int  sizeMem) {
-        Region_<CellIndex>::iterator theIterator;
-        theIterator = Region_<CellIndex>::pImpl_->begin();
-        while (theIterator != Region_<CellIndex>::pImpl_->end())
+        forEachCell(CellSynchronizer(sizeMem));
+    }
+
+private:
+    vector<Cell*> grid_; ///< dense row-major grid of the cells of a regular cellular space
+    int gridXMin_; ///< smallest x coordinate of the grid
+    int gridYMin_; ///< smallest y coordinate of the grid
+    int gridXDim_; ///< number of columns of the grid
+    int gridYDim_; ///< number of lines of the grid
+    int gridCells_; ///< number of cells stored in the grid
+
+    /// Synchronizes each cell traversed by forEachCell().
+    struct CellSynchronizer {
+        unsigned int sizeMem;
+        CellSynchronizer(unsigned int size) : sizeMem(size) {}
+        void operator()(Cell* cell) const { cell->synchronize(sizeMem); }
+    };
+
+    /// Attaches (or detaches, when there is no control mode) an agent to each cell traversed
+    /// by forEachCell().
+    struct ControlModeAttacher {
+        LocalAgent *agent;
+        ControlMode *controlMode;
+        ControlModeAttacher(LocalAgent *a, ControlMode *c) : agent(a), controlMode(c) {}
+        void operator()(Cell* cell) const {
+            if (controlMode) cell->attachControlMode(agent, controlMode);
+            else cell->detachControlMode(agent);
+        }
+    };
+
+    /// Stores a cell in the dense grid if its position is inside the grid and still empty.
+    void gridInsert(const CellIndex& indx, Cell* cell) {
+        int position = gridPosition(indx);
+        if (position >= 0 && grid_[position] == NULL)
         {
-            theIterator->second->synchronize(sizeMem);
-            theIterator++;
+            grid_[position] = cell;
+            gridCells_++;
         }
     }
 
-private:
+    /// Removes the cell with the given coordinate from the dense grid. When a cell is given,
+    /// the grid position is only cleared if it stores this cell.
+    void gridRemove(const CellIndex& indx, Cell* cell = NULL) {
+        int position = gridPosition(indx);
+        if (position >= 0 && grid_[position] != NULL && (cell == NULL || grid_[position] == cell))
+        {
+            grid_[position] = NULL;
+            gridCells_--;
+        }
+    }
+
+    /// Returns the position of a cell coordinate in the dense grid, or -1 when it is outside the grid.
+    int gridPosition(const CellIndex& indx) const {
+        int col = indx.first - gridXMin_;
+        int lin = indx.second - gridYMin_;
+
+        if (col < 0 || col >= gridXDim_ || lin < 0 || lin >= gridYDim_)
+            return -1;
+
+        return lin * gridXDim_ + col;
+    }
+
     /// Attaches a control model of a agent attached to the cellular space to each cell.
     /// Using this method, the cell can keep track of the agents active control mode (or discrete state).
     /// \param agent is a pointer to a agent attached to the cellular space.
     /// \param controlMode is pointer to the agents control mode.
     void attachControlModeToCells(LocalAgent *agent, ControlMode *controlMode) {
-        Region_<CellIndex>::iterator theIterator;
-
-        theIterator = Region_<CellIndex>::pImpl_->begin();
-        while (theIterator != Region_<CellIndex>::pImpl_->end())
-        {
-            theIterator->second->attachControlMode(agent, controlMode);
-            theIterator++;
-        }
+        forEachCell(ControlModeAttacher(agent, controlMode));
     }
 
     /// Detaches the control model of a agent from the cells.
     /// Using this method, the cells stop to keep track of the agents active control mode (or discrete state).
     /// \param agent is a pointer to a agent attached to the cellular space.
     void detachControlModeFromCells(LocalAgent *agent) {
-        Region_<CellIndex>::iterator theIterator;
-        theIterator = Region_<CellIndex>::pImpl_->begin();
-        while (theIterator != Region_<CellIndex>::pImpl_->end())
-        {
-            theIterator->second->detachControlMode(agent);
-            theIterator++;
-        }
+        forEachCell(ControlModeAttacher(agent, NULL));
     }
 };
 
@@ -0,0 +1,519 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "columnarFile.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFileInfo>
+
+extern "C"
+{
+	#include <lauxlib.h>
+}
+
+static const quint32 COLUMNAR_MAGIC = 0x544D4331; // "TMC1"
+static const quint32 COLUMNAR_VERSION = 2; // 2: ids, names, and strings as raw bytes
+
+template <class T>
+static QByteArray pack(const T& values)
+{
+	QByteArray bytes;
+	QDataStream out(&bytes, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << values;
+	return qCompress(bytes);
+}
+
+template <class T>
+static bool unpack(const QByteArray& packed, T& values)
+{
+	QByteArray bytes = qUncompress(packed);
+	QDataStream in(bytes);
+	in.setVersion(QDataStream::Qt_5_0);
+	in >> values;
+	return in.status() == QDataStream::Ok;
+}
+
+static QByteArray packBooleans(const QVector<double>& values)
+{
+	QByteArray bytes(values.size(), 0);
+	for (int i = 0; i < values.size(); i++)
+		if (values.at(i) != 0) bytes[i] = 1;
+	return qCompress(bytes);
+}
+
+static bool unpackBooleans(const QByteArray& packed, QVector<double>& values)
+{
+	QByteArray bytes = qUncompress(packed);
+	values.resize(bytes.size());
+	for (int i = 0; i < bytes.size(); i++)
+		values[i] = bytes.at(i) ? 1 : 0;
+	return bytes.size() > 0 || packed.size() > 0;
+}
+
+ColumnarFile::ColumnarFile(const QString& path) : file_(path)
+{
+}
+
+bool ColumnarFile::create(const QList<QByteArray>& ids, const QVector<double>& xs, const QVector<double>& ys)
+{
+	if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		error_ = file_.errorString();
+		return false;
+	}
+
+	QDataStream out(&file_);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << COLUMNAR_MAGIC << COLUMNAR_VERSION << (quint32) ids.size();
+	out << pack(ids) << pack(xs) << pack(ys);
+	file_.close();
+
+	if (out.status() != QDataStream::Ok)
+	{
+		error_ = QString("Could not write file '%1'.").arg(file_.fileName());
+		return false;
+	}
+
+	ids_ = ids;
+	xs_ = xs;
+	ys_ = ys;
+	times_.clear();
+	offsets_.clear();
+	return true;
+}
+
+bool ColumnarFile::open()
+{
+	if (!file_.open(QIODevice::ReadOnly))
+	{
+		error_ = file_.errorString();
+		return false;
+	}
+
+	QDataStream in(&file_);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0, version = 0, size = 0;
+	in >> magic >> version >> size;
+
+	if (magic != COLUMNAR_MAGIC || version != COLUMNAR_VERSION)
+	{
+		file_.close();
+		error_ = QString("File '%1' is not a columnar time series file.").arg(file_.fileName());
+		return false;
+	}
+
+	QByteArray packedIds, packedXs, packedYs;
+	in >> packedIds >> packedXs >> packedYs;
+
+	bool ok = unpack(packedIds, ids_) && unpack(packedXs, xs_) && unpack(packedYs, ys_)
+		&& ids_.size() == (int) size && xs_.size() == (int) size && ys_.size() == (int) size;
+
+	times_.clear();
+	offsets_.clear();
+
+	while (ok && !in.atEnd())
+	{
+		double time;
+		quint32 bytes;
+		in >> time >> bytes;
+
+		qint64 offset = file_.pos();
+		ok = in.status() == QDataStream::Ok && in.skipRawData(bytes) == (int) bytes;
+
+		if (ok)
+		{
+			times_.push_back(time);
+			offsets_.push_back(offset);
+		}
+	}
+
+	file_.close();
+
+	if (!ok)
+	{
+		error_ = QString("File '%1' is corrupted.").arg(file_.fileName());
+		return false;
+	}
+
+	return true;
+}
+
+bool ColumnarFile::append(double time, const QList<ColumnarColumn>& columns)
+{
+	QByteArray block;
+	QDataStream out(&block, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_5_0);
+
+	out << (quint32) columns.size();
+	for (int i = 0; i < columns.size(); i++)
+	{
+		const ColumnarColumn& column = columns.at(i);
+		out << column.name << (quint8) column.type;
+
+		switch (column.type)
+		{
+			case ColumnarColumn::String:
+				out << pack(column.texts);
+				break;
+
+			case ColumnarColumn::Boolean:
+				out << packBooleans(column.numbers);
+				break;
+
+			default:
+				out << pack(column.numbers);
+				break;
+		}
+	}
+
+	if (!file_.open(QIODevice::Append))
+	{
+		error_ = file_.errorString();
+		return false;
+	}
+
+	QDataStream fout(&file_);
+	fout.setVersion(QDataStream::Qt_5_0);
+	fout << time << (quint32) block.size();
+
+	qint64 offset = file_.pos();
+	fout.writeRawData(block.constData(), block.size());
+	file_.close();
+
+	if (fout.status() != QDataStream::Ok)
+	{
+		error_ = QString("Could not write file '%1'.").arg(file_.fileName());
+		return false;
+	}
+
+	times_.push_back(time);
+	offsets_.push_back(offset);
+	return true;
+}
+
+bool ColumnarFile::read(int step, QList<ColumnarColumn>& columns)
+{
+	if (step < 0 || step >= offsets_.size())
+	{
+		error_ = QString("File '%1' does not have the requested time.").arg(file_.fileName());
+		return false;
+	}
+
+	if (!file_.open(QIODevice::ReadOnly))
+	{
+		error_ = file_.errorString();
+		return false;
+	}
+
+	file_.seek(offsets_.at(step));
+
+	QDataStream in(&file_);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	quint32 size = 0;
+	in >> size;
+
+	bool ok = in.status() == QDataStream::Ok;
+	columns.clear();
+
+	for (quint32 i = 0; ok && i < size; i++)
+	{
+		ColumnarColumn column;
+		quint8 type;
+		QByteArray packed;
+
+		in >> column.name >> type >> packed;
+		column.type = (ColumnarColumn::Type) type;
+
+		switch (column.type)
+		{
+			case ColumnarColumn::String:
+				ok = unpack(packed, column.texts) && column.texts.size() == ids_.size();
+				break;
+
+			case ColumnarColumn::Boolean:
+				ok = unpackBooleans(packed, column.numbers) && column.numbers.size() == ids_.size();
+				break;
+
+			default:
+				ok = unpack(packed, column.numbers) && column.numbers.size() == ids_.size();
+				break;
+		}
+
+		ok = ok && in.status() == QDataStream::Ok;
+		columns.push_back(column);
+	}
+
+	file_.close();
+
+	if (!ok)
+	{
+		error_ = QString("File '%1' is corrupted.").arg(file_.fileName());
+		return false;
+	}
+
+	return true;
+}
+
+static int columnarError(lua_State *L, const QString& message)
+{
+	lua_pushnil(L);
+	lua_pushstring(L, message.toUtf8().constData());
+	return 2;
+}
+
+static void pushNumbers(lua_State *L, const QVector<double>& values)
+{
+	lua_createtable(L, values.size(), 0);
+	for (int i = 0; i < values.size(); i++)
+	{
+		lua_pushnumber(L, values.at(i));
+		lua_rawseti(L, -2, i + 1);
+	}
+}
+
+static void pushStrings(lua_State *L, const QList<QByteArray>& values)
+{
+	lua_createtable(L, values.size(), 0);
+	for (int i = 0; i < values.size(); i++)
+	{
+		const QByteArray& value = values.at(i);
+		lua_pushlstring(L, value.constData(), value.size());
+		lua_rawseti(L, -2, i + 1);
+	}
+}
+
+// copies the bytes of the Lua string at the given index, without any encoding
+static QByteArray toBytes(lua_State *L, int index)
+{
+	size_t size = 0;
+	const char *value = lua_tolstring(L, index, &size);
+	return QByteArray(value, (int) size);
+}
+
+int cpp_columnarsave(lua_State *L)
+{
+	QString path(luaL_checkstring(L, 1));
+	luaL_checktype(L, 2, LUA_TTABLE);
+	luaL_checktype(L, 3, LUA_TTABLE);
+
+	int cells = (int) lua_rawlen(L, 2);
+	int attributes = (int) lua_rawlen(L, 3);
+
+	QList<ColumnarColumn> columns;
+	for (int a = 1; a <= attributes; a++)
+	{
+		ColumnarColumn column;
+		lua_rawgeti(L, 3, a);
+		column.name = toBytes(L, -1);
+		column.type = ColumnarColumn::Number;
+		lua_pop(L, 1);
+		columns.push_back(column);
+	}
+
+	QList<QByteArray> ids;
+	QVector<double> xs(cells), ys(cells);
+
+	for (int i = 1; i <= cells; i++)
+	{
+		lua_rawgeti(L, 2, i);
+
+		lua_getfield(L, -1, "id");
+		QByteArray id = lua_isstring(L, -1) ? toBytes(L, -1) : QByteArray::number(i);
+		ids.push_back(id);
+		lua_pop(L, 1);
+
+		lua_getfield(L, -1, "x");
+		xs[i - 1] = lua_tonumber(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, -1, "y");
+		ys[i - 1] = lua_tonumber(L, -1);
+		lua_pop(L, 1);
+
+		for (int a = 0; a < columns.size(); a++)
+		{
+			ColumnarColumn& column = columns[a];
+			lua_getfield(L, -1, column.name.constData());
+
+			int luaType = lua_type(L, -1);
+			ColumnarColumn::Type type;
+
+			switch (luaType)
+			{
+				case LUA_TNUMBER:
+					type = lua_isinteger(L, -1) ? ColumnarColumn::Integer : ColumnarColumn::Number;
+					break;
+
+				case LUA_TBOOLEAN:
+					type = ColumnarColumn::Boolean;
+					break;
+
+				case LUA_TSTRING:
+					type = ColumnarColumn::String;
+					break;
+
+				default:
+					return columnarError(L, QString("Attribute '%1' of Cell '%2' should be number, boolean, or string, got %3.")
+						.arg(QString(column.name)).arg(QString(id)).arg(lua_typename(L, luaType)));
+			}
+
+			bool number = type == ColumnarColumn::Number || type == ColumnarColumn::Integer;
+
+			if (i == 1)
+				column.type = type;
+			else if (number && column.type == ColumnarColumn::Integer)
+				column.type = type;
+			else if (!(number && column.type == ColumnarColumn::Number) && type != column.type)
+				return columnarError(L, QString("Attribute '%1' should have values of a single type, Cell '%2' has a %3.")
+					.arg(QString(column.name)).arg(QString(id)).arg(lua_typename(L, luaType)));
+
+			if (type == ColumnarColumn::String)
+				column.texts.push_back(toBytes(L, -1));
+			else if (type == ColumnarColumn::Boolean)
+				column.numbers.push_back(lua_toboolean(L, -1) ? 1 : 0);
+			else
+				column.numbers.push_back(lua_tonumber(L, -1));
+
+			lua_pop(L, 1);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	ColumnarFile file(path);
+
+	if (QFileInfo(path).exists())
+	{
+		if (!file.open())
+			return columnarError(L, file.error());
+
+		if (file.ids().size() != cells)
+			return columnarError(L, QString("File '%1' stores %2 cells, got %3.")
+				.arg(path).arg(file.ids().size()).arg(cells));
+
+		for (int i = 0; i < cells; i++)
+		{
+			if (file.ids().at(i) != ids.at(i))
+				return columnarError(L, QString("File '%1' stores Cell '%2' at position %3, got Cell '%4'.")
+					.arg(path).arg(QString(file.ids().at(i))).arg(i + 1).arg(QString(ids.at(i))));
+		}
+	}
+	else if (!file.create(ids, xs, ys))
+		return columnarError(L, file.error());
+
+	double time = file.times().size() + 1;
+	if (!lua_isnoneornil(L, 4))
+		time = luaL_checknumber(L, 4);
+
+	if (!file.append(time, columns))
+		return columnarError(L, file.error());
+
+	lua_pushnumber(L, time);
+	return 1;
+}
+
+int cpp_columnarload(lua_State *L)
+{
+	QString path(luaL_checkstring(L, 1));
+
+	ColumnarFile file(path);
+	if (!file.open())
+		return columnarError(L, file.error());
+
+	int step = file.times().size() - 1;
+	if (!lua_isnoneornil(L, 2))
+	{
+		double time = luaL_checknumber(L, 2);
+		step = file.times().indexOf(time);
+
+		if (step < 0)
+			return columnarError(L, QString("Time %1 was not saved in file '%2'.").arg(time).arg(path));
+	}
+
+	QList<ColumnarColumn> columns;
+	if (step >= 0 && !file.read(step, columns))
+		return columnarError(L, file.error());
+
+	lua_createtable(L, 0, 6);
+
+	pushStrings(L, file.ids());
+	lua_setfield(L, -2, "id");
+
+	pushNumbers(L, file.xs());
+	lua_setfield(L, -2, "x");
+
+	pushNumbers(L, file.ys());
+	lua_setfield(L, -2, "y");
+
+	pushNumbers(L, file.times());
+	lua_setfield(L, -2, "times");
+
+	if (step >= 0)
+	{
+		lua_pushnumber(L, file.times().at(step));
+		lua_setfield(L, -2, "time");
+	}
+
+	lua_createtable(L, 0, columns.size());
+	for (int a = 0; a < columns.size(); a++)
+	{
+		const ColumnarColumn& column = columns.at(a);
+
+		switch (column.type)
+		{
+			case ColumnarColumn::String:
+				pushStrings(L, column.texts);
+				break;
+
+			case ColumnarColumn::Boolean:
+				lua_createtable(L, column.numbers.size(), 0);
+				for (int i = 0; i < column.numbers.size(); i++)
+				{
+					lua_pushboolean(L, column.numbers.at(i) != 0);
+					lua_rawseti(L, -2, i + 1);
+				}
+				break;
+
+			case ColumnarColumn::Integer:
+				lua_createtable(L, column.numbers.size(), 0);
+				for (int i = 0; i < column.numbers.size(); i++)
+				{
+					lua_pushinteger(L, (lua_Integer) column.numbers.at(i));
+					lua_rawseti(L, -2, i + 1);
+				}
+				break;
+
+			default:
+				pushNumbers(L, column.numbers);
+				break;
+		}
+
+		lua_setfield(L, -2, column.name.constData());
+	}
+	lua_setfield(L, -2, "columns");
+
+	return 1;
+}
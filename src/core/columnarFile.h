@@ -0,0 +1,136 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*! \file columnarFile.h
+\brief This file contains definitions about the columnar time series files
+	used by CellularSpace:save(). The ids and coordinates of the cells are stored
+	once, followed by one block of compressed attribute columns for each saved time.
+*/
+
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+extern "C"
+{
+	#include <lua.h>
+}
+
+/**
+* \brief
+*  One attribute column of a columnar time series file.
+*  Numbers and booleans are stored in numbers, strings in texts.
+*  Integer columns hold only numbers without fractional part in Lua.
+*  Names and strings keep the bytes of the Lua strings, without any encoding.
+*/
+struct ColumnarColumn
+{
+	enum Type {Number = 0, Boolean = 1, String = 2, Integer = 3};
+
+	QByteArray name;
+	Type type;
+	QVector<double> numbers;
+	QList<QByteArray> texts;
+};
+
+/**
+* \brief
+*  Columnar time series file. Its content is
+*  <header> <ids> <xs> <ys> (<time> <size> <columns>)*
+*  where each block of columns holds the name, the type, and the compressed
+*  values of each attribute in the same order of the ids.
+*/
+class ColumnarFile
+{
+public:
+	/// Constructor
+	/// \param path is the location of the file
+	ColumnarFile(const QString& path);
+
+	/// Creates the file, replacing it if it already exists.
+	/// \param ids the ids of the cells, with the bytes of the Lua strings
+	/// \param xs the x coordinates of the cells, with the same size of ids
+	/// \param ys the y coordinates of the cells, with the same size of ids
+	/// \return false if the file could not be written
+	bool create(const QList<QByteArray>& ids, const QVector<double>& xs, const QVector<double>& ys);
+
+	/// Reads the cells and the saved times of an existing file.
+	/// \return false if the file could not be read or is not a columnar file
+	bool open();
+
+	/// Appends the columns of a given time to the end of the file.
+	/// \param time the simulation time of the values
+	/// \param columns the attribute columns, all of them with one value for each cell
+	/// \return false if the file could not be written
+	bool append(double time, const QList<ColumnarColumn>& columns);
+
+	/// Reads the columns saved for a given time.
+	/// \param step the position of the time in times(), starting in zero
+	/// \param columns receives the attribute columns
+	/// \return false if the file could not be read
+	bool read(int step, QList<ColumnarColumn>& columns);
+
+	/// Returns the ids of the cells.
+	const QList<QByteArray>& ids() const { return ids_; }
+
+	/// Returns the x coordinates of the cells.
+	const QVector<double>& xs() const { return xs_; }
+
+	/// Returns the y coordinates of the cells.
+	const QVector<double>& ys() const { return ys_; }
+
+	/// Returns the saved times, in the order they were appended.
+	const QVector<double>& times() const { return times_; }
+
+	/// Returns the description of the last error.
+	const QString& error() const { return error_; }
+
+private:
+	QFile file_;
+	QList<QByteArray> ids_;
+	QVector<double> xs_, ys_;
+	QVector<double> times_;
+	QVector<qint64> offsets_; ///< position of the columns of each time in the file
+	QString error_;
+};
+
+/// Saves attributes of the cells in a columnar time series file.
+/// Lua arguments: file name, vector of cells, vector of attribute names, and an optional time
+/// (the default is the number of times already saved plus one). The cells and coordinates
+/// are written only when the file does not exist; otherwise the ids of the cells must be
+/// the same ones of the file. Returns the saved time, or nil and an error message.
+int cpp_columnarsave(lua_State *L);
+
+/// Loads a columnar time series file. Lua arguments: file name and an optional time
+/// (the default is the last saved time). Returns a table with the vectors id, x, y,
+/// and times, the selected time, and a named table columns with the attribute vectors,
+/// or nil and an error message.
+int cpp_columnarload(lua_State *L);
+
+#endif
@@ -0,0 +1,806 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "csvFile.h"
+#include "dataFrameColumn.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+extern "C"
+{
+	#include <lauxlib.h>
+}
+
+// files smaller than this are read by a single thread
+static const qint64 CSV_PARALLEL_SIZE = 1 << 20;
+
+// chunks of lines for each thread, to balance lines with different lengths
+static const int CSV_CHUNKS_PER_THREAD = 4;
+
+namespace {
+
+enum CsvKind {CsvInteger = 0, CsvNumber = 1, CsvString = 2, CsvMixed = 3};
+
+struct CsvField
+{
+	const char* data;
+	int length;
+	QByteArray copy; // value of a quoted field with escaped quotes
+};
+
+struct CsvInvalid
+{
+	int line;
+	QByteArray text;
+	int size;
+};
+
+/**
+* \brief
+*  Lines of the file read by a single task.
+*/
+struct CsvChunk
+{
+	qint64 begin;
+	qint64 end;
+	int lines;
+	int rows;
+	int firstRow;            // position of the first row of the chunk in the columns
+	int errorLine;           // first line with invalid quotes, or -1
+	QByteArray errorText;
+	QVector<int> kinds;      // bit mask of the kinds found in each column
+	QList<CsvInvalid> invalid;
+	QVector<QHash<QByteArray, int> > lookups;     // codes of the strings of each column
+	QVector<QVector<QByteArray> > dictionaries;   // strings of each column, by code
+};
+
+/**
+* \brief
+*  Values of a column. Mixed columns keep the kind of each value.
+*/
+struct CsvColumn
+{
+	int kind;
+	QVector<lua_Integer> integers;
+	QVector<double> numbers;
+	QVector<int> codes;
+	QVector<char> kinds;
+	QVector<QByteArray> texts;
+
+	// raw pointers used by the tasks, taken before they start
+	lua_Integer* integerData;
+	double* numberData;
+	int* codeData;
+	char* kindData;
+	QByteArray* textData;
+};
+
+// removes the white spaces, as string.match(value, "^%s*(.-)%s*$")
+static inline void trim(CsvField& field)
+{
+	static const char* spaces = " \t\n\v\f\r";
+
+	while (field.length > 0 && strchr(spaces, field.data[0]) && field.data[0] != '\0')
+	{
+		field.data++;
+		field.length--;
+	}
+
+	while (field.length > 0 && strchr(spaces, field.data[field.length - 1]) && field.data[field.length - 1] != '\0')
+		field.length--;
+}
+
+// splits a line as parseLine() in File.lua, returning the number of fields,
+// or -1 if a quoted value is not closed or not followed by the separator
+static int splitLine(const char* line, int length, char sep, QVector<CsvField>& fields)
+{
+	int count = 0;
+	int pos = 0;
+
+	while (pos < length)
+	{
+		if (count == fields.size())
+			fields.resize(count + 16);
+
+		CsvField& field = fields[count++];
+
+		if (line[pos] == '"')
+		{
+			int start = pos + 1;
+			const char* close = (const char*) memchr(line + start, '"', length - start);
+			if (!close) return -1;
+
+			int end = (int) (close - line);
+			pos = end + 1;
+
+			if (pos < length && line[pos] == '"')
+			{
+				// two quotes inside a quoted value are a single quote
+				field.copy = QByteArray(line + start, end - start);
+
+				while (pos < length && line[pos] == '"')
+				{
+					field.copy.append('"');
+
+					start = pos + 1;
+					close = (const char*) memchr(line + start, '"', length - start);
+					if (!close) return -1;
+
+					end = (int) (close - line);
+					field.copy.append(line + start, end - start);
+					pos = end + 1;
+				}
+
+				field.data = field.copy.constData();
+				field.length = field.copy.size();
+			}
+			else
+			{
+				field.data = line + start;
+				field.length = end - start;
+			}
+
+			if (pos < length && line[pos] != sep) return -1;
+			pos++;
+		}
+		else
+		{
+			const char* found = (const char*) memchr(line + pos, sep, length - pos);
+			int end = found ? (int) (found - line) : length;
+
+			field.data = line + pos;
+			field.length = end - pos;
+			pos = end + 1;
+		}
+
+		trim(field);
+	}
+
+	return count;
+}
+
+// converts a value as tonumber() in Lua 5.3, returning its kind
+static CsvKind classify(const CsvField& field, lua_Integer& integer, double& number)
+{
+	if (field.length == 0) return CsvString;
+
+	char small[256];
+	QByteArray large;
+	char* text = small;
+
+	if (field.length >= (int) sizeof(small))
+	{
+		large = QByteArray(field.data, field.length);
+		text = large.data();
+	}
+	else
+	{
+		memcpy(small, field.data, field.length);
+		small[field.length] = '\0';
+	}
+
+	if ((int) strlen(text) != field.length) return CsvString;
+
+	// integers, as l_str2int()
+	const char* s = text;
+	bool negative = false;
+	if (*s == '-') { negative = true; s++; }
+	else if (*s == '+') s++;
+
+	lua_Unsigned value = 0;
+	bool empty = true;
+	bool overflow = false;
+
+	if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+	{
+		for (s += 2; isxdigit((unsigned char) *s); s++)
+		{
+			int digit = isdigit((unsigned char) *s) ? *s - '0' : (tolower((unsigned char) *s) - 'a') + 10;
+			value = value * 16 + digit;
+			empty = false;
+		}
+	}
+	else
+	{
+		const lua_Unsigned maxBy10 = (lua_Unsigned) (LUA_MAXINTEGER / 10);
+		const int maxLastDigit = (int) (LUA_MAXINTEGER % 10);
+
+		for (; isdigit((unsigned char) *s); s++)
+		{
+			int digit = *s - '0';
+			if (value >= maxBy10 && (value > maxBy10 || digit > maxLastDigit + (negative ? 1 : 0)))
+			{
+				overflow = true;
+				break;
+			}
+
+			value = value * 10 + digit;
+			empty = false;
+		}
+	}
+
+	if (!empty && !overflow && *s == '\0')
+	{
+		integer = (lua_Integer) (negative ? 0u - value : value);
+		return CsvInteger;
+	}
+
+	// floats, as l_str2d(), which rejects 'inf' and 'nan'
+	if (strpbrk(text, "nN")) return CsvString;
+
+	char* end;
+	number = strtod(text, &end);
+
+	if (end == text || *end != '\0') return CsvString;
+
+	return CsvNumber;
+}
+
+class CsvReader;
+
+/**
+* \brief
+*  Task that runs one of the passes of the reader on a chunk.
+*/
+class CsvTask : public QRunnable
+{
+public:
+	CsvTask(CsvReader* reader, bool scan, int chunk) : reader(reader), scan(scan), chunk(chunk) {}
+	void run();
+
+private:
+	CsvReader* reader;
+	bool scan;
+	int chunk;
+};
+
+/**
+* \brief
+*  Reads the lines of the file in two passes over the chunks. The first one
+*  counts the rows and finds the kinds of the columns, the second one writes
+*  the values straight into the columns.
+*/
+class CsvReader
+{
+public:
+	CsvReader(const char* data, qint64 size, char sep) : data(data), size(size), sep(sep) {}
+
+	bool read(QString& error);
+	void scanChunk(int index);
+	void convertChunk(int index);
+	void push(lua_State* L);
+
+private:
+	void runTasks(bool scan);
+	void mergeDictionaries(int column);
+
+	const char* data;
+	qint64 size;
+	char sep;
+
+	QList<QByteArray> names;
+	QVector<CsvChunk> chunks;
+	QVector<CsvColumn> columns;
+	int rows;
+	int lines;
+};
+
+void CsvTask::run()
+{
+	if (scan) reader->scanChunk(chunk);
+	else reader->convertChunk(chunk);
+}
+
+bool CsvReader::read(QString& error)
+{
+	const char* newline = (const char*) memchr(data, '\n', size);
+	qint64 headerEnd = newline ? newline - data : size;
+
+	QVector<CsvField> fields;
+	int count = splitLine(data, (int) headerEnd, sep, fields);
+	if (count < 0)
+	{
+		error = QString("Line 1 ('%1') is invalid.").arg(QString::fromUtf8(data, (int) headerEnd));
+		return false;
+	}
+
+	for (int i = 0; i < count; i++)
+		names.append(QByteArray(fields.at(i).data, fields.at(i).length));
+
+	qint64 begin = newline ? headerEnd + 1 : size;
+	int quantity = 1;
+
+	if (size - begin > CSV_PARALLEL_SIZE)
+		quantity = qMax(1, QThread::idealThreadCount()) * CSV_CHUNKS_PER_THREAD;
+
+	for (int i = 0; i < quantity && begin < size; i++)
+	{
+		qint64 end = size;
+
+		if (i < quantity - 1)
+		{
+			end = begin + (size - begin) / (quantity - i);
+			const char* next = (const char*) memchr(data + end, '\n', size - end);
+			end = next ? next - data + 1 : size;
+		}
+
+		CsvChunk chunk;
+		chunk.begin = begin;
+		chunk.end = end;
+		chunk.lines = 0;
+		chunk.rows = 0;
+		chunk.firstRow = 0;
+		chunk.errorLine = -1;
+		chunk.kinds.fill(0, names.size());
+		chunks.append(chunk);
+
+		begin = end;
+	}
+
+	runTasks(true);
+
+	rows = 0;
+	lines = 1;
+
+	for (int i = 0; i < chunks.size(); i++)
+	{
+		CsvChunk& chunk = chunks[i];
+
+		if (chunk.errorLine >= 0)
+		{
+			error = QString("Line %1 ('%2') is invalid.").arg(lines + chunk.errorLine + 1)
+				.arg(QString::fromUtf8(chunk.errorText));
+			return false;
+		}
+
+		for (int j = 0; j < chunk.invalid.size(); j++)
+			chunk.invalid[j].line += lines + 1;
+
+		chunk.firstRow = rows;
+		rows += chunk.rows;
+		lines += chunk.lines;
+	}
+
+	columns.resize(names.size());
+
+	for (int j = 0; j < names.size(); j++)
+	{
+		int kinds = 0;
+		for (int i = 0; i < chunks.size(); i++)
+			kinds |= chunks.at(i).kinds.at(j);
+
+		CsvColumn& column = columns[j];
+
+		if (kinds == (1 << CsvInteger)) column.kind = CsvInteger;
+		else if (kinds == (1 << CsvNumber)) column.kind = CsvNumber;
+		else if (kinds == (1 << CsvString)) column.kind = CsvString;
+		else column.kind = CsvMixed;
+
+		if (column.kind == CsvInteger || column.kind == CsvMixed) column.integers.resize(rows);
+		if (column.kind == CsvNumber || column.kind == CsvMixed) column.numbers.resize(rows);
+		if (column.kind == CsvString) column.codes.resize(rows);
+		if (column.kind == CsvMixed)
+		{
+			column.kinds.resize(rows);
+			column.texts.resize(rows);
+		}
+
+		column.integerData = column.integers.data();
+		column.numberData = column.numbers.data();
+		column.codeData = column.codes.data();
+		column.kindData = column.kinds.data();
+		column.textData = column.texts.data();
+	}
+
+	for (int i = 0; i < chunks.size(); i++)
+	{
+		chunks[i].lookups.resize(names.size());
+		chunks[i].dictionaries.resize(names.size());
+	}
+
+	runTasks(false);
+
+	for (int j = 0; j < columns.size(); j++)
+		if (columns.at(j).kind == CsvString)
+			mergeDictionaries(j);
+
+	return true;
+}
+
+void CsvReader::runTasks(bool scan)
+{
+	if (chunks.size() == 1)
+	{
+		if (scan) scanChunk(0);
+		else convertChunk(0);
+		return;
+	}
+
+	QThreadPool pool;
+	for (int i = 0; i < chunks.size(); i++)
+		pool.start(new CsvTask(this, scan, i));
+
+	pool.waitForDone();
+}
+
+void CsvReader::scanChunk(int index)
+{
+	CsvChunk& chunk = chunks[index];
+	QVector<CsvField> fields;
+	int* kinds = chunk.kinds.data();
+	int expected = names.size();
+
+	const char* line = data + chunk.begin;
+	const char* end = data + chunk.end;
+
+	while (line < end)
+	{
+		const char* newline = (const char*) memchr(line, '\n', end - line);
+		int length = (int) ((newline ? newline : end) - line);
+
+		int count = splitLine(line, length, sep, fields);
+
+		if (count < 0)
+		{
+			chunk.errorLine = chunk.lines;
+			chunk.errorText = QByteArray(line, length);
+			return;
+		}
+		else if (count != expected)
+		{
+			CsvInvalid invalid;
+			invalid.line = chunk.lines;
+			invalid.text = QByteArray(line, length);
+			invalid.size = count;
+			chunk.invalid.append(invalid);
+		}
+		else
+		{
+			lua_Integer integer;
+			double number;
+
+			for (int j = 0; j < count; j++)
+				kinds[j] |= 1 << classify(fields.at(j), integer, number);
+
+			chunk.rows++;
+		}
+
+		chunk.lines++;
+		line = newline ? newline + 1 : end;
+	}
+}
+
+void CsvReader::convertChunk(int index)
+{
+	CsvChunk& chunk = chunks[index];
+	QVector<CsvField> fields;
+	int expected = names.size();
+	int row = chunk.firstRow;
+
+	const char* line = data + chunk.begin;
+	const char* end = data + chunk.end;
+
+	while (line < end)
+	{
+		const char* newline = (const char*) memchr(line, '\n', end - line);
+		int length = (int) ((newline ? newline : end) - line);
+		int count = splitLine(line, length, sep, fields);
+
+		line = newline ? newline + 1 : end;
+		if (count != expected) continue;
+
+		for (int j = 0; j < expected; j++)
+		{
+			const CsvColumn& column = columns.at(j);
+			const CsvField& field = fields.at(j);
+			lua_Integer integer = 0;
+			double number = 0;
+			CsvKind kind = CsvString;
+
+			if (column.kind != CsvString)
+				kind = classify(field, integer, number);
+
+			switch (column.kind)
+			{
+				case CsvInteger:
+					column.integerData[row] = integer;
+					break;
+				case CsvNumber:
+					column.numberData[row] = number;
+					break;
+				case CsvString:
+				{
+					QByteArray text(field.data, field.length);
+					QHash<QByteArray, int>& lookup = chunk.lookups[j];
+					QHash<QByteArray, int>::const_iterator it = lookup.constFind(text);
+
+					if (it == lookup.constEnd())
+					{
+						it = lookup.insert(text, chunk.dictionaries[j].size());
+						chunk.dictionaries[j].append(text);
+					}
+
+					column.codeData[row] = it.value();
+					break;
+				}
+				case CsvMixed:
+					column.kindData[row] = (char) kind;
+					if (kind == CsvInteger) column.integerData[row] = integer;
+					else if (kind == CsvNumber) column.numberData[row] = number;
+					else column.textData[row] = QByteArray(field.data, field.length);
+					break;
+			}
+		}
+
+		row++;
+	}
+}
+
+void CsvReader::mergeDictionaries(int index)
+{
+	CsvColumn& column = columns[index];
+	QHash<QByteArray, int> lookup;
+	QVector<QByteArray> dictionary;
+
+	for (int i = 0; i < chunks.size(); i++)
+	{
+		const QVector<QByteArray>& local = chunks.at(i).dictionaries.at(index);
+		QVector<int> codes(local.size());
+
+		for (int code = 0; code < local.size(); code++)
+		{
+			QHash<QByteArray, int>::const_iterator it = lookup.constFind(local.at(code));
+			if (it == lookup.constEnd())
+			{
+				it = lookup.insert(local.at(code), dictionary.size());
+				dictionary.append(local.at(code));
+			}
+
+			codes[code] = it.value();
+		}
+
+		int last = chunks.at(i).firstRow + chunks.at(i).rows;
+		for (int row = chunks.at(i).firstRow; row < last; row++)
+			column.codeData[row] = codes.at(column.codeData[row]);
+	}
+
+	column.texts = dictionary;
+}
+
+void CsvReader::push(lua_State* L)
+{
+	lua_createtable(L, 0, 5);
+
+	lua_createtable(L, names.size(), 0);
+	for (int j = 0; j < names.size(); j++)
+	{
+		lua_pushlstring(L, names.at(j).constData(), names.at(j).size());
+		lua_rawseti(L, -2, j + 1);
+	}
+	lua_setfield(L, -2, "names");
+
+	lua_createtable(L, 0, names.size());
+	for (int j = 0; j < names.size(); j++)
+	{
+		const CsvColumn& column = columns.at(j);
+		lua_pushlstring(L, names.at(j).constData(), names.at(j).size());
+
+		if (rows == 0)
+			lua_newtable(L);
+		else if (column.kind == CsvInteger)
+			pushDataFrameColumn(L, DataFrameColumn::fromIntegers(column.integers));
+		else if (column.kind == CsvNumber)
+			pushDataFrameColumn(L, DataFrameColumn::fromNumbers(column.numbers));
+		else if (column.kind == CsvString)
+			pushDataFrameColumn(L, DataFrameColumn::fromStrings(column.codes, column.texts));
+		else
+		{
+			lua_createtable(L, rows, 0);
+			for (int row = 0; row < rows; row++)
+			{
+				if (column.kinds.at(row) == CsvInteger)
+					lua_pushinteger(L, column.integers.at(row));
+				else if (column.kinds.at(row) == CsvNumber)
+					lua_pushnumber(L, column.numbers.at(row));
+				else
+					lua_pushlstring(L, column.texts.at(row).constData(), column.texts.at(row).size());
+
+				lua_rawseti(L, -2, row + 1);
+			}
+		}
+
+		lua_rawset(L, -3);
+	}
+	lua_setfield(L, -2, "columns");
+
+	lua_pushinteger(L, rows);
+	lua_setfield(L, -2, "rows");
+
+	lua_pushinteger(L, lines);
+	lua_setfield(L, -2, "lines");
+
+	lua_newtable(L);
+	int position = 1;
+	for (int i = 0; i < chunks.size(); i++)
+	{
+		const QList<CsvInvalid>& invalid = chunks.at(i).invalid;
+		for (int j = 0; j < invalid.size(); j++)
+		{
+			lua_createtable(L, 0, 3);
+
+			lua_pushinteger(L, invalid.at(j).line);
+			lua_setfield(L, -2, "line");
+
+			lua_pushlstring(L, invalid.at(j).text.constData(), invalid.at(j).text.size());
+			lua_setfield(L, -2, "text");
+
+			lua_pushinteger(L, invalid.at(j).size);
+			lua_setfield(L, -2, "size");
+
+			lua_rawseti(L, -2, position++);
+		}
+	}
+	lua_setfield(L, -2, "invalid");
+}
+
+} // namespace
+
+bool csvToNumber(const char* text, int length, double& number)
+{
+	CsvField field;
+	field.data = text;
+	field.length = length;
+
+	lua_Integer integer;
+	switch (classify(field, integer, number))
+	{
+	case CsvInteger:
+		number = (double) integer;
+		return true;
+	case CsvNumber:
+		return true;
+	default:
+		return false;
+	}
+}
+
+int cpp_csvread(lua_State *L)
+{
+	QString path(luaL_checkstring(L, 1));
+	size_t length;
+	const char* sep = luaL_checklstring(L, 2, &length);
+	luaL_argcheck(L, length == 1, 2, "single character expected");
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, QString("File '%1' could not be read.").arg(path).toUtf8().constData());
+		return 2;
+	}
+
+	qint64 size = file.size();
+	QByteArray contents;
+	const char* data = size > 0 ? (const char*) file.map(0, size) : NULL;
+
+	if (!data)
+	{
+		contents = file.readAll();
+		data = contents.constData();
+		size = contents.size();
+	}
+
+	CsvReader reader(data, size, sep[0]);
+	QString error;
+
+	if (!reader.read(error))
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, error.toUtf8().constData());
+		return 2;
+	}
+
+	reader.push(L);
+	return 1;
+}
+
+int cpp_csvformat(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int first = (int) luaL_checkinteger(L, 2);
+	int last = (int) luaL_checkinteger(L, 3);
+	size_t sepLength;
+	const char* sep = luaL_checklstring(L, 4, &sepLength);
+
+	int quantity = (int) lua_rawlen(L, 1);
+	luaL_checkstack(L, quantity + 4, "too many columns");
+
+	int base = lua_gettop(L);
+	QVector<DataFrameColumn*> natives(quantity);
+
+	for (int j = 0; j < quantity; j++)
+	{
+		lua_rawgeti(L, 1, j + 1);
+		natives[j] = toDataFrameColumn(L, -1);
+	}
+
+	QByteArray text;
+	text.reserve(qMax(0, last - first + 1) * qMax(1, quantity) * 8);
+
+	for (int row = first; row <= last; row++)
+	{
+		for (int j = 0; j < quantity; j++)
+		{
+			if (j > 0) text.append(sep, (int) sepLength);
+
+			DataFrameColumn* column = natives.at(j);
+
+			if (column)
+			{
+				if (row >= 1 && row <= column->size())
+					column->appendText(row - 1, text);
+				else
+					text.append("\"nil\"");
+
+				continue;
+			}
+
+			lua_rawgeti(L, base + j + 1, row);
+
+			if (lua_type(L, -1) == LUA_TNUMBER)
+			{
+				if (lua_isinteger(L, -1))
+					text.append(QByteArray::number((qlonglong) lua_tointeger(L, -1)));
+				else
+					appendLuaNumber(text, lua_tonumber(L, -1));
+			}
+			else
+			{
+				size_t length;
+				const char* value = luaL_tolstring(L, -1, &length);
+				text.append('"');
+				text.append(value, (int) length);
+				text.append('"');
+				lua_pop(L, 1);
+			}
+
+			lua_pop(L, 1);
+		}
+
+		text.append('\n');
+	}
+
+	lua_pushlstring(L, text.constData(), text.size());
+	return 1;
+}
@@ -0,0 +1,56 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*! \file csvFile.h
+\brief This file contains definitions about the native reading and writing of CSV files
+	used by File:read() and File:write(). The file is mapped into memory and its lines
+	are parsed in parallel, in the same way of the Lua parser of File.
+*/
+
+#ifndef CSV_FILE_H
+#define CSV_FILE_H
+
+extern "C"
+{
+	#include <lua.h>
+}
+
+/// Converts a trimmed value into a number as tonumber() does in Lua 5.3.
+/// Returns false if the value is not a number.
+bool csvToNumber(const char* text, int length, double& number);
+
+/// Reads a CSV file. Lua arguments: the file name and the separator, with a single character.
+/// The values are trimmed and converted into numbers as tonumber() does. Columns with only
+/// numbers with fractional part, only integers, or only strings are native DataFrame columns,
+/// the other ones are Lua vectors. Returns a table with the vector names (the first line),
+/// the named table columns, the number of rows, the number of lines, and the vector invalid
+/// with the lines whose quantity of values is different from the first line, described as
+/// {line, text, size}. In case of error, returns nil and an error message.
+int cpp_csvread(lua_State *L);
+
+/// Formats rows of a DataFrame as CSV lines, as File:write() does. Lua arguments: a vector
+/// with the columns (native DataFrame columns or Lua vectors), the first row, the last row,
+/// and the separator. Returns a string with one line for each row.
+int cpp_csvformat(lua_State *L);
+
+#endif
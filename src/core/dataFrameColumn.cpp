@@ -0,0 +1,699 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "dataFrameColumn.h"
+
+#include <cstdio>
+#include <cstring>
+
+extern "C"
+{
+	#include <lauxlib.h>
+}
+
+static const char* COLUMN_METATABLE = "TerraME.DataFrameColumn";
+
+// type of a Lua value, returning false if it cannot be stored in a native column
+static bool valueType(lua_State* L, int index, DataFrameColumn::Type& type)
+{
+	switch (lua_type(L, index))
+	{
+		case LUA_TNUMBER:
+			type = lua_isinteger(L, index) ? DataFrameColumn::Integer : DataFrameColumn::Number;
+			return true;
+		case LUA_TBOOLEAN:
+			type = DataFrameColumn::Boolean;
+			return true;
+		case LUA_TSTRING:
+			type = DataFrameColumn::String;
+			return true;
+		default:
+			return false;
+	}
+}
+
+DataFrameColumn::DataFrameColumn(Type type) : type_(type), size_(0)
+{
+}
+
+DataFrameColumn* DataFrameColumn::fromVector(lua_State* L, int index)
+{
+	index = lua_absindex(L, index);
+	int size = (int) lua_rawlen(L, index);
+	if (size == 0) return NULL;
+
+	int keys = 0;
+	lua_pushnil(L);
+	while (lua_next(L, index))
+	{
+		keys++;
+		lua_pop(L, 1);
+	}
+
+	if (keys != size) return NULL;
+
+	Type type;
+	lua_rawgeti(L, index, 1);
+	bool valid = valueType(L, -1, type);
+	lua_pop(L, 1);
+
+	if (!valid) return NULL;
+
+	DataFrameColumn* column = new DataFrameColumn(type);
+
+	for (int i = 1; i <= size && valid; i++)
+	{
+		lua_rawgeti(L, index, i);
+		valid = column->set(L, i - 1, -1);
+		lua_pop(L, 1);
+	}
+
+	if (!valid)
+	{
+		delete column;
+		return NULL;
+	}
+
+	return column;
+}
+
+DataFrameColumn* DataFrameColumn::fromNumbers(const QVector<double>& values)
+{
+	DataFrameColumn* column = new DataFrameColumn(Number);
+	column->numbers_ = values;
+	column->size_ = values.size();
+	return column;
+}
+
+DataFrameColumn* DataFrameColumn::fromIntegers(const QVector<lua_Integer>& values)
+{
+	DataFrameColumn* column = new DataFrameColumn(Integer);
+	column->integers_ = values;
+	column->size_ = values.size();
+	return column;
+}
+
+DataFrameColumn* DataFrameColumn::fromStrings(const QVector<int>& codes, const QVector<QByteArray>& dictionary)
+{
+	DataFrameColumn* column = new DataFrameColumn(String);
+	column->codes_ = codes;
+	column->dictionary_ = dictionary;
+	column->size_ = codes.size();
+
+	column->lookup_.reserve(dictionary.size());
+	for (int i = 0; i < dictionary.size(); i++)
+		column->lookup_.insert(dictionary.at(i), i);
+
+	return column;
+}
+
+int DataFrameColumn::encode(const QByteArray& value)
+{
+	QHash<QByteArray, int>::const_iterator it = lookup_.constFind(value);
+	if (it != lookup_.constEnd())
+		return it.value();
+
+	int code = dictionary_.size();
+	dictionary_.append(value);
+	lookup_.insert(value, code);
+	return code;
+}
+
+bool DataFrameColumn::set(lua_State* L, int row, int index)
+{
+	Type type;
+	if (row < 0 || row > size_ || !valueType(L, index, type) || type != type_)
+		return false;
+
+	bool append = row == size_;
+
+	switch (type_)
+	{
+		case Number:
+			if (append) numbers_.append(lua_tonumber(L, index));
+			else numbers_[row] = lua_tonumber(L, index);
+			break;
+		case Integer:
+			if (append) integers_.append(lua_tointeger(L, index));
+			else integers_[row] = lua_tointeger(L, index);
+			break;
+		case Boolean:
+			if (append) booleans_.append(lua_toboolean(L, index) ? 1 : 0);
+			else booleans_[row] = lua_toboolean(L, index) ? 1 : 0;
+			break;
+		case String:
+		{
+			size_t length;
+			const char* text = lua_tolstring(L, index, &length);
+			int code = encode(QByteArray(text, (int) length));
+
+			if (append) codes_.append(code);
+			else codes_[row] = code;
+			break;
+		}
+	}
+
+	if (append) size_++;
+	return true;
+}
+
+void DataFrameColumn::push(lua_State* L, int row) const
+{
+	switch (type_)
+	{
+		case Number:
+			lua_pushnumber(L, numbers_.at(row));
+			break;
+		case Integer:
+			lua_pushinteger(L, integers_.at(row));
+			break;
+		case Boolean:
+			lua_pushboolean(L, booleans_.at(row));
+			break;
+		case String:
+		{
+			const QByteArray& text = dictionary_.at(codes_.at(row));
+			lua_pushlstring(L, text.constData(), text.size());
+			break;
+		}
+	}
+}
+
+void appendLuaNumber(QByteArray& line, lua_Number value)
+{
+	char text[64];
+	int length = snprintf(text, sizeof(text), LUA_NUMBER_FMT, (LUAI_UACNUMBER) value);
+
+	// as lua_tostring, floats that look like integers end with ".0"
+	if (text[strspn(text, "-0123456789")] == '\0')
+	{
+		text[length++] = '.';
+		text[length++] = '0';
+	}
+
+	line.append(text, length);
+}
+
+void DataFrameColumn::appendText(int row, QByteArray& line) const
+{
+	switch (type_)
+	{
+		case Number:
+			appendLuaNumber(line, numbers_.at(row));
+			break;
+		case Integer:
+			line.append(QByteArray::number((qlonglong) integers_.at(row)));
+			break;
+		case Boolean:
+			line.append(booleans_.at(row) ? "\"true\"" : "\"false\"");
+			break;
+		case String:
+			line.append('"');
+			line.append(dictionary_.at(codes_.at(row)));
+			line.append('"');
+			break;
+	}
+}
+
+void DataFrameColumn::remove(int row)
+{
+	switch (type_)
+	{
+		case Number: numbers_.remove(row); break;
+		case Integer: integers_.remove(row); break;
+		case Boolean: booleans_.remove(row); break;
+		case String: codes_.remove(row); break;
+	}
+
+	size_--;
+}
+
+void DataFrameColumn::pushSum(lua_State* L) const
+{
+	if (type_ == Integer)
+	{
+		lua_Integer sum = 0;
+		const lua_Integer* values = integers_.constData();
+		for (int i = 0; i < size_; i++)
+			sum += values[i];
+
+		lua_pushinteger(L, sum);
+		return;
+	}
+
+	// four independent partial sums, that the compiler can keep in vector registers
+	double sums[4] = {0, 0, 0, 0};
+	const double* values = numbers_.constData();
+	int i = 0;
+
+	for (; i + 4 <= size_; i += 4)
+	{
+		sums[0] += values[i];
+		sums[1] += values[i + 1];
+		sums[2] += values[i + 2];
+		sums[3] += values[i + 3];
+	}
+
+	for (; i < size_; i++)
+		sums[0] += values[i];
+
+	lua_pushnumber(L, (sums[0] + sums[1]) + (sums[2] + sums[3]));
+}
+
+QVector<int> DataFrameColumn::group(lua_State* L) const
+{
+	QVector<int> groups(size_);
+	int quantity = 0;
+
+	lua_newtable(L);
+
+	switch (type_)
+	{
+		case Number:
+		{
+			QHash<double, int> found;
+			for (int i = 0; i < size_; i++)
+			{
+				QHash<double, int>::const_iterator it = found.constFind(numbers_.at(i));
+				if (it == found.constEnd())
+				{
+					it = found.insert(numbers_.at(i), quantity++);
+					push(L, i);
+					lua_rawseti(L, -2, quantity);
+				}
+
+				groups[i] = it.value();
+			}
+			break;
+		}
+		case Integer:
+		{
+			QHash<lua_Integer, int> found;
+			for (int i = 0; i < size_; i++)
+			{
+				QHash<lua_Integer, int>::const_iterator it = found.constFind(integers_.at(i));
+				if (it == found.constEnd())
+				{
+					it = found.insert(integers_.at(i), quantity++);
+					push(L, i);
+					lua_rawseti(L, -2, quantity);
+				}
+
+				groups[i] = it.value();
+			}
+			break;
+		}
+		case Boolean:
+		case String:
+		{
+			// booleans and string codes are small integers, mapped straight to their groups
+			QVector<int> codeGroup(type_ == String ? dictionary_.size() : 2, -1);
+
+			for (int i = 0; i < size_; i++)
+			{
+				int code = type_ == String ? codes_.at(i) : booleans_.at(i);
+				if (codeGroup.at(code) < 0)
+				{
+					codeGroup[code] = quantity++;
+					push(L, i);
+					lua_rawseti(L, -2, quantity);
+				}
+
+				groups[i] = codeGroup.at(code);
+			}
+			break;
+		}
+	}
+
+	return groups;
+}
+
+void DataFrameColumn::pushGroupSum(lua_State* L, const DataFrameColumn& groups) const
+{
+	QVector<int> rowGroup = groups.group(L);
+	int keys = lua_gettop(L);
+	int quantity = (int) lua_rawlen(L, keys);
+
+	QVector<double> sums(quantity, 0);
+	QVector<lua_Integer> integerSums(quantity, 0);
+	QVector<lua_Integer> counts(quantity, 0);
+
+	if (type_ == Integer)
+	{
+		for (int i = 0; i < size_; i++)
+		{
+			integerSums[rowGroup.at(i)] += integers_.at(i);
+			counts[rowGroup.at(i)]++;
+		}
+	}
+	else
+	{
+		for (int i = 0; i < size_; i++)
+		{
+			sums[rowGroup.at(i)] += numbers_.at(i);
+			counts[rowGroup.at(i)]++;
+		}
+	}
+
+	lua_createtable(L, 0, quantity);
+	lua_createtable(L, 0, quantity);
+
+	for (int g = 0; g < quantity; g++)
+	{
+		lua_rawgeti(L, keys, g + 1);
+		if (type_ == Integer) lua_pushinteger(L, integerSums.at(g));
+		else lua_pushnumber(L, sums.at(g));
+		lua_rawset(L, -4);
+
+		lua_rawgeti(L, keys, g + 1);
+		lua_pushinteger(L, counts.at(g));
+		lua_rawset(L, -3);
+	}
+
+	lua_remove(L, keys);
+}
+
+QVector<int> DataFrameColumn::find(lua_State* L, int index) const
+{
+	QVector<int> rows;
+
+	switch (type_)
+	{
+		case Number:
+		case Integer:
+		{
+			if (lua_type(L, index) != LUA_TNUMBER) break;
+
+			if (type_ == Integer && lua_isinteger(L, index))
+			{
+				lua_Integer value = lua_tointeger(L, index);
+				for (int i = 0; i < size_; i++)
+					if (integers_.at(i) == value) rows.append(i);
+			}
+			else if (type_ == Integer)
+			{
+				double value = lua_tonumber(L, index);
+				for (int i = 0; i < size_; i++)
+					if ((double) integers_.at(i) == value) rows.append(i);
+			}
+			else
+			{
+				double value = lua_tonumber(L, index);
+				for (int i = 0; i < size_; i++)
+					if (numbers_.at(i) == value) rows.append(i);
+			}
+			break;
+		}
+		case Boolean:
+		{
+			if (lua_type(L, index) != LUA_TBOOLEAN) break;
+
+			char value = lua_toboolean(L, index) ? 1 : 0;
+			for (int i = 0; i < size_; i++)
+				if (booleans_.at(i) == value) rows.append(i);
+			break;
+		}
+		case String:
+		{
+			if (lua_type(L, index) != LUA_TSTRING) break;
+
+			size_t length;
+			const char* text = lua_tolstring(L, index, &length);
+			QHash<QByteArray, int>::const_iterator it = lookup_.constFind(QByteArray(text, (int) length));
+			if (it == lookup_.constEnd()) break;
+
+			int code = it.value();
+			for (int i = 0; i < size_; i++)
+				if (codes_.at(i) == code) rows.append(i);
+			break;
+		}
+	}
+
+	return rows;
+}
+
+DataFrameColumn* DataFrameColumn::gather(const QVector<int>& rows) const
+{
+	DataFrameColumn* column = new DataFrameColumn(type_);
+	column->size_ = rows.size();
+
+	switch (type_)
+	{
+		case Number:
+			column->numbers_.reserve(rows.size());
+			for (int i = 0; i < rows.size(); i++)
+				column->numbers_.append(numbers_.at(rows.at(i)));
+			break;
+		case Integer:
+			column->integers_.reserve(rows.size());
+			for (int i = 0; i < rows.size(); i++)
+				column->integers_.append(integers_.at(rows.at(i)));
+			break;
+		case Boolean:
+			column->booleans_.reserve(rows.size());
+			for (int i = 0; i < rows.size(); i++)
+				column->booleans_.append(booleans_.at(rows.at(i)));
+			break;
+		case String:
+			column->codes_.reserve(rows.size());
+			for (int i = 0; i < rows.size(); i++)
+				column->codes_.append(column->encode(dictionary_.at(codes_.at(rows.at(i)))));
+			break;
+	}
+
+	return column;
+}
+
+static DataFrameColumn* checkColumn(lua_State* L, int index)
+{
+	return *(DataFrameColumn**) luaL_checkudata(L, index, COLUMN_METATABLE);
+}
+
+DataFrameColumn* toDataFrameColumn(lua_State* L, int index)
+{
+	DataFrameColumn** column = (DataFrameColumn**) luaL_testudata(L, index, COLUMN_METATABLE);
+	return column ? *column : NULL;
+}
+
+// returns the zero-based row of a Lua index, or -1 if it is not a row of the column
+static int checkRow(lua_State* L, int index, const DataFrameColumn* column)
+{
+	int isInteger;
+	lua_Integer row = lua_tointegerx(L, index, &isInteger);
+
+	if (!isInteger || row < 1 || row > column->size())
+		return -1;
+
+	return (int) row - 1;
+}
+
+
+static int columnSet(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	int isInteger;
+	lua_Integer row = lua_tointegerx(L, 2, &isInteger);
+
+	lua_pushboolean(L, isInteger && row >= 1 && row <= column->size() + 1 && column->set(L, (int) row - 1, 3));
+	return 1;
+}
+
+static int columnType(lua_State* L)
+{
+	static const char* names[] = {"number", "integer", "boolean", "string"};
+
+	lua_pushstring(L, names[checkColumn(L, 1)->type()]);
+	return 1;
+}
+
+static int columnToTable(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+
+	lua_createtable(L, column->size(), 0);
+	for (int i = 0; i < column->size(); i++)
+	{
+		column->push(L, i);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+static int columnRemove(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	int row = checkRow(L, 2, column);
+	luaL_argcheck(L, row >= 0, 2, "row out of the column");
+
+	column->remove(row);
+	return 0;
+}
+
+static int columnSum(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	luaL_argcheck(L, column->isNumeric(), 1, "numeric column expected");
+
+	if (lua_isnoneornil(L, 2))
+	{
+		column->pushSum(L);
+		return 1;
+	}
+
+	DataFrameColumn* groups = checkColumn(L, 2);
+	luaL_argcheck(L, groups->size() == column->size(), 2, "column with the same size expected");
+
+	column->pushGroupSum(L, *groups);
+	return 2;
+}
+
+static int columnFind(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	QVector<int> rows = column->find(L, 2);
+
+	lua_createtable(L, rows.size(), 0);
+	for (int i = 0; i < rows.size(); i++)
+	{
+		lua_pushinteger(L, rows.at(i) + 1);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+static int columnGather(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int quantity = (int) lua_rawlen(L, 2);
+	QVector<int> rows(quantity);
+
+	for (int i = 0; i < quantity; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+		rows[i] = checkRow(L, -1, column);
+		lua_pop(L, 1);
+
+		luaL_argcheck(L, rows.at(i) >= 0, 2, "row out of the column");
+	}
+
+	pushDataFrameColumn(L, column->gather(rows));
+	return 1;
+}
+
+static int columnIndex(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+
+	if (lua_type(L, 2) == LUA_TNUMBER)
+	{
+		int row = checkRow(L, 2, column);
+		if (row >= 0) column->push(L, row);
+		else lua_pushnil(L);
+
+		return 1;
+	}
+
+	lua_pushvalue(L, 2);
+	lua_rawget(L, lua_upvalueindex(1));
+	return 1;
+}
+
+static int columnNewIndex(lua_State* L)
+{
+	DataFrameColumn* column = checkColumn(L, 1);
+	int isInteger;
+	lua_Integer row = lua_tointegerx(L, 2, &isInteger);
+
+	if (!isInteger || row < 1 || row > column->size() + 1 || !column->set(L, (int) row - 1, 3))
+		return luaL_error(L, "Value cannot be stored in position %s of a native column.", luaL_tolstring(L, 2, NULL));
+
+	return 0;
+}
+
+static int columnLength(lua_State* L)
+{
+	lua_pushinteger(L, checkColumn(L, 1)->size());
+	return 1;
+}
+
+static int columnGc(lua_State* L)
+{
+	DataFrameColumn** column = (DataFrameColumn**) luaL_checkudata(L, 1, COLUMN_METATABLE);
+	delete *column;
+	*column = NULL;
+	return 0;
+}
+
+void pushDataFrameColumn(lua_State* L, DataFrameColumn* column)
+{
+	DataFrameColumn** data = (DataFrameColumn**) lua_newuserdata(L, sizeof(DataFrameColumn*));
+	*data = column;
+
+	if (luaL_newmetatable(L, COLUMN_METATABLE))
+	{
+		static const luaL_Reg methods[] = {
+			{"set", columnSet},
+			{"type", columnType},
+			{"totable", columnToTable},
+			{"remove", columnRemove},
+			{"sum", columnSum},
+			{"find", columnFind},
+			{"gather", columnGather},
+			{NULL, NULL}
+		};
+
+		luaL_newlib(L, methods);
+		lua_pushcclosure(L, columnIndex, 1);
+		lua_setfield(L, -2, "__index");
+
+		lua_pushcfunction(L, columnNewIndex);
+		lua_setfield(L, -2, "__newindex");
+
+		lua_pushcfunction(L, columnLength);
+		lua_setfield(L, -2, "__len");
+
+		lua_pushcfunction(L, columnGc);
+		lua_setfield(L, -2, "__gc");
+	}
+
+	lua_setmetatable(L, -2);
+}
+
+int cpp_dataframecolumn(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+
+	DataFrameColumn* column = DataFrameColumn::fromVector(L, 1);
+	if (!column)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	pushDataFrameColumn(L, column);
+	return 1;
+}
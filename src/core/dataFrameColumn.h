@@ -0,0 +1,160 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*! \file dataFrameColumn.h
+\brief This file contains definitions about the native columns of DataFrame.
+	A column stores the values of the rows one to n in a contiguous typed array.
+	DataFrame keeps in Lua tables the columns that cannot be stored natively.
+*/
+
+#ifndef DATA_FRAME_COLUMN_H
+#define DATA_FRAME_COLUMN_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+extern "C"
+{
+	#include <lua.h>
+}
+
+/**
+* \brief
+*  Native column of a DataFrame. All its values have the same type, that is,
+*  numbers with fractional part, integers, booleans, or strings. Strings are
+*  dictionary encoded: each distinct string is stored once and the rows
+*  store its code.
+*/
+class DataFrameColumn
+{
+public:
+	enum Type {Number = 0, Integer = 1, Boolean = 2, String = 3};
+
+	/// Constructor
+	/// \param type the type of the values
+	DataFrameColumn(Type type);
+
+	/// Creates a column from a Lua vector.
+	/// \param L the Lua state
+	/// \param index the position of the vector in the stack
+	/// \return a new column, or NULL if the vector is empty, has holes,
+	/// or has values with different types
+	static DataFrameColumn* fromVector(lua_State* L, int index);
+
+	/// Creates a column of numbers with fractional part, sharing the given values.
+	static DataFrameColumn* fromNumbers(const QVector<double>& values);
+
+	/// Creates a column of integers, sharing the given values.
+	static DataFrameColumn* fromIntegers(const QVector<lua_Integer>& values);
+
+	/// Creates a column of strings from their dictionary codes.
+	/// \param codes the code of each row
+	/// \param dictionary the distinct strings, indexed by their codes
+	static DataFrameColumn* fromStrings(const QVector<int>& codes, const QVector<QByteArray>& dictionary);
+
+	/// Returns the type of the values.
+	Type type() const { return type_; }
+
+	/// Returns the number of values.
+	int size() const { return size_; }
+
+	/// Returns whether the values are numbers or integers.
+	bool isNumeric() const { return type_ == Number || type_ == Integer; }
+
+	/// Stores a Lua value in a row, appending it when the row is the size of the column.
+	/// \param L the Lua state
+	/// \param row the position of the row, starting in zero
+	/// \param index the position of the value in the stack
+	/// \return false if the row is out of the column or the value does not have the type of the column
+	bool set(lua_State* L, int row, int index);
+
+	/// Pushes the value of a row onto the stack.
+	/// \param L the Lua state
+	/// \param row the position of the row, starting in zero
+	void push(lua_State* L, int row) const;
+
+	/// Appends the value of a row to a CSV line, as File:write() does: numbers are
+	/// written as Lua converts them into strings and the other values between quotes.
+	/// \param row the position of the row, starting in zero
+	/// \param line the line being written
+	void appendText(int row, QByteArray& line) const;
+
+	/// Removes a row, moving the next ones back.
+	/// \param row the position of the row, starting in zero
+	void remove(int row);
+
+	/// Pushes the sum of the values onto the stack. Sums of integers are integers.
+	/// \param L the Lua state
+	void pushSum(lua_State* L) const;
+
+	/// Pushes two tables indexed by the values of another column with the same size:
+	/// the sum of the values of each group and the number of rows of each group.
+	/// \param L the Lua state
+	/// \param groups the column whose values define the groups
+	void pushGroupSum(lua_State* L, const DataFrameColumn& groups) const;
+
+	/// Returns the rows whose values are equal to a given Lua value.
+	/// \param L the Lua state
+	/// \param index the position of the value in the stack
+	QVector<int> find(lua_State* L, int index) const;
+
+	/// Returns a new column with the values of some rows, in the given order.
+	/// \param rows the positions of the rows, starting in zero
+	DataFrameColumn* gather(const QVector<int>& rows) const;
+
+private:
+	/// Returns the code of a string, adding it to the dictionary if needed.
+	int encode(const QByteArray& value);
+
+	/// Returns the group of each row, from zero to the number of distinct values
+	/// minus one, pushing a table with the distinct values in the order of their groups.
+	QVector<int> group(lua_State* L) const;
+
+	Type type_;
+	int size_;
+
+	QVector<double> numbers_;
+	QVector<lua_Integer> integers_;
+	QVector<char> booleans_;
+	QVector<int> codes_;               ///< dictionary codes of the strings
+	QVector<QByteArray> dictionary_;   ///< distinct strings, indexed by their codes
+	QHash<QByteArray, int> lookup_;    ///< code of each distinct string
+};
+
+/// Creates a native DataFrame column from a Lua vector. Lua argument: the vector.
+/// Returns the column, or nil if the vector cannot be stored natively. Columns are
+/// indexed from one, as Lua vectors, and have the functions set(row, value),
+/// type(), totable(), remove(row), sum([groups]), find(value), and gather(rows).
+int cpp_dataframecolumn(lua_State *L);
+
+/// Pushes a native column onto the stack. Lua becomes the owner of the column.
+void pushDataFrameColumn(lua_State* L, DataFrameColumn* column);
+
+/// Returns the native column in a given position of the stack, or NULL if it is not a native column.
+DataFrameColumn* toDataFrameColumn(lua_State* L, int index);
+
+/// Appends a number to a CSV line, as Lua converts it into a string.
+void appendLuaNumber(QByteArray& line, lua_Number value);
+
+#endif
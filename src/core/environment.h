@@ -58,6 +58,7 @@ of this software and its documentation.
 #include "player.h"
 
 extern bool SHOW_GUI;
+extern bool HEADLESS;
 extern bool paused;
 extern bool step;
 
@@ -199,9 +200,10 @@ public:
         bool run = true;
         while (run &(time <= finalTime))
         {
-            // Player
-            while (paused)
-                qApp->processEvents();
+            // Player (not available in headless mode)
+            if (!HEADLESS)
+                while (paused)
+                    qApp->processEvents();
 
             // If there is no any internal environment: run "my" clock
             if (TimeEnvironmentPairCompositeInterf::size() == 0)
@@ -248,7 +250,7 @@ public:
                     }
                 }
             }
-            if (step)
+            if (step && !HEADLESS)
                 paused = true;
         }
         return true;
@@ -22,6 +22,7 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "imageCompare.h"
+#include "frameWriter.h"
 
 #include <iostream>
 
@@ -29,6 +30,9 @@ using namespace std;
 
 void imageSize(const QString &img, int &width, int &height)
 {
+	// the image may have been saved by a Map and still be waiting to be written
+	TerraMEObserver::FrameWriter::flush(img);
+
 	QImage image(img);
 
 	width = image.width();
@@ -37,6 +41,9 @@ void imageSize(const QString &img, int &width, int &height)
 
 double comparePerPixel(const QString &img1, const QString &img2)
 {
+	TerraMEObserver::FrameWriter::flush(img1);
+	TerraMEObserver::FrameWriter::flush(img2);
+
 	QImage image1(img1);
 	QImage image2(img2);
 
@@ -562,6 +562,8 @@ int luaCell::createObserver(lua_State *)
             obsLog->setFileName(cols.at(0));
             obsLog->setSeparator(cols.at(1));
 			obsLog->setWriteMode(cols.at(2));
+			if (cols.size() > 3)
+				obsLog->setFlushRows(cols.at(3).toInt());
 
             lua->pushNumber(luaL, obsId);
             lua->pushLightUserdata(luaL, (void*) obsLog);
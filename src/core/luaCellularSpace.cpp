@@ -36,6 +36,7 @@ of this software and its documentation.
 // Observadores
 #include "../observer/types/observerUDPSender.h"
 #include "../observer/types/agentObserverMap.h"
+#include "../observer/types/observerImage.h"
 #include "../observer/types/observerTextScreen.h"
 #include "../observer/types/observerGraphic.h"
 #include "../observer/types/observerLogFile.h"
@@ -49,6 +50,8 @@ of this software and its documentation.
 #include <fstream>
 #include <algorithm>
 
+#include <QtNumeric>
+
 #ifndef WIN32
 #define stricmp strcasecmp
 #define strnicmp strncasecmp
@@ -198,6 +201,127 @@ int luaCellularSpace::addCell(lua_State *L)
     return 0;
 }
 
+/// Declares the luaCellularSpace object as a regular grid, whose cells are found in constant time
+/// parameters: xMin, yMin, xdim, ydim
+int luaCellularSpace::setGrid(lua_State *L)
+{
+    int xMin = lua->getNumberAt(L, -4);
+    int yMin = lua->getNumberAt(L, -3);
+    int xDim = lua->getNumberAt(L, -2);
+    int yDim = lua->getNumberAt(L, -1);
+    CellularSpace::setGrid(xMin, yMin, xDim, yDim);
+
+    return 0;
+}
+
+/// Builds the neighborhoods of a regular luaCellularSpace from a stencil of relative positions
+/// parameters: a table {dx1, dy1, dx2, dy2, ...}, wrap, average
+/// return three arrays (first, neighbors, weights) indexed by the position of the cells in the grid,
+/// starting from one, or nil if the luaCellularSpace is not a regular grid
+int luaCellularSpace::createStencilNeighborhood(lua_State *L)
+{
+    int top = lua->getTopIndex(L);
+    int stencil = top - 2;
+    bool wrap = lua->toBooleanAt(L, top - 1);
+    bool average = lua->toBooleanAt(L, top);
+
+    if (CellularSpace::getGridXDim() == 0 || CellularSpace::getGridYDim() == 0)
+    {
+        lua->pushNil(L);
+        return 1;
+    }
+
+    vector<int> dxs, dys;
+    for (long long i = 1; ; i += 2)
+    {
+        lua->pushIndexAt(L, stencil, i);
+        lua->pushIndexAt(L, stencil, i + 1);
+        if (!lua->isNumberAt(L, -2) || !lua->isNumberAt(L, -1))
+        {
+            lua->pop(L, 2);
+            break;
+        }
+
+        dxs.push_back((int) lua->getNumberAt(L, -2));
+        dys.push_back((int) lua->getNumberAt(L, -1));
+        lua->pop(L, 2);
+    }
+
+    vector<int> first, neighbors;
+    vector<double> weights;
+    CellularSpace::buildStencilNeighborhood(dxs, dys, wrap, average, first, neighbors, weights);
+
+    lua->createTable(L, (int) first.size(), 0);
+    for (size_t i = 0; i < first.size(); i++)
+    {
+        lua->pushNumber(L, first[i] + 1);
+        lua->setIndexAt(L, -2, (long long) i + 1);
+    }
+
+    lua->createTable(L, (int) neighbors.size(), 0);
+    for (size_t i = 0; i < neighbors.size(); i++)
+    {
+        lua->pushNumber(L, neighbors[i] + 1);
+        lua->setIndexAt(L, -2, (long long) i + 1);
+    }
+
+    lua->createTable(L, (int) weights.size(), 0);
+    for (size_t i = 0; i < weights.size(); i++)
+    {
+        lua->pushNumber(L, weights[i]);
+        lua->setIndexAt(L, -2, (long long) i + 1);
+    }
+
+    return 3;
+}
+
+/// Copies the current values of the cells into columns of past values. Each column is an
+/// array indexed by the position of the cell, reused in the next calls
+/// parameters: the array of cells, an array with the attribute names, and a table with the columns
+int luaCellularSpace::synchronizeColumns(lua_State *L)
+{
+    int top = lua->getTopIndex(L);
+    int cells = top - 2;
+    int values = top - 1;
+    int columns = top;
+
+    long long size = 0;
+    while (lua->isTable(lua->pushIndexAt(L, cells, size + 1)))
+    {
+        lua->pop(L, 1);
+        size++;
+    }
+    lua->pop(L, 1);
+
+    for (long long v = 1; lua->isString(lua->pushIndexAt(L, values, v)); v++)
+    {
+        std::string name = lua->getStringAtTop(L);
+        lua->pop(L, 1);
+
+        if (!lua->isTable(lua->pushFieldAt(L, columns, name)))
+        {
+            lua->pop(L, 1);
+            lua->createTable(L, (int) size, 0);
+            lua->setFieldAt(L, columns, name);
+            lua->pushFieldAt(L, columns, name);
+        }
+
+        int column = lua->getTopIndex(L);
+        for (long long i = 1; i <= size; i++)
+        {
+            lua->pushIndexAt(L, cells, i);
+            lua->pushFieldAt(L, -1, name);
+            lua->setIndexAt(L, column, i);
+            lua->pop(L, 1);
+        }
+
+        lua->pop(L, 1);
+    }
+    lua->pop(L, 1);
+
+    return 0;
+}
+
 /// Returns the number of cells of the CellularSpace object
 /// no parameters
 int luaCellularSpace::size(lua_State* L)
@@ -493,6 +617,7 @@ int luaCellularSpace::createObserver(lua_State * luaL)
     }
 
     AgentObserverMap *obsMap = 0;
+    ObserverImage *obsImage = 0;
     ObserverUDPSender *obsUDPSender = 0;
     ObserverTextScreen *obsText = 0;
     ObserverTable *obsTable = 0;
@@ -587,6 +712,18 @@ int luaCellularSpace::createObserver(lua_State * luaL)
                 qWarning("%s", qPrintable(TerraMEObserver::MEMORY_ALLOC_FAILED));
         }
         break;
+    case TObsImage:
+        obsImage =(ObserverImage *) CellSpaceSubjectInterf::createObserver(TObsImage);
+        if (obsImage)
+        {
+            obsId = obsImage->getId();
+        }
+        else
+        {
+            if (execModes != Quiet)
+                qWarning("%s", qPrintable(TerraMEObserver::MEMORY_ALLOC_FAILED));
+        }
+        break;
     case TObsUDPSender:
         obsUDPSender =(ObserverUDPSender *) CellSpaceSubjectInterf::createObserver(TObsUDPSender);
         if (obsUDPSender)
@@ -618,6 +755,8 @@ int luaCellularSpace::createObserver(lua_State * luaL)
         obsLog->setFileName(obsParamsAtribs.at(0));
         obsLog->setSeparator(obsParamsAtribs.at(1));
         obsLog->setWriteMode(obsParamsAtribs.at(2));
+        if (obsParamsAtribs.size() > 3)
+            obsLog->setFlushRows(obsParamsAtribs.at(3).toInt());
 
         lua->pushNumber(luaL, obsId);
         lua->pushLightUserdata(luaL, (void*) obsLog);
@@ -679,6 +818,19 @@ int luaCellularSpace::createObserver(lua_State * luaL)
 		return 2;
     }
 
+    // the image cannot draw agents, it is not returned by getObserver
+    if (obsImage)
+    {
+        if (getSpaceDimensions)
+            obsImage->setCellSpaceSize(width, height);
+
+        obsImage->setAttributes(obsAttribs, obsParams, obsParamsAtribs);
+        lua->pushNumber(luaL, obsId);
+        lua->pushLightUserdata(luaL, (void*) obsImage);
+
+        return 2;
+    }
+
     if (obsUDPSender)
     {
         obsUDPSender->setAttributes(obsAttribs);
@@ -751,6 +903,24 @@ QDataStream& luaCellularSpace::getState(QDataStream& in, Subject *, int observer
 QDataStream& luaCellularSpace::getState(QDataStream& in, Subject *, int observerId, QStringList &  attribs)
 #endif
 {
+    Observer *obs = getObserverById(observerId);
+    if (obs && (obs->getProtocolFormat() == TObsBinaryProtocol))
+    {
+        QVector<BinaryColumn> columns;
+#ifdef TME_BLACK_BOARD
+        popColumns(luaL, observedAttribs, columns);
+#else
+        popColumns(luaL, attribs, columns);
+#endif
+        // after the first state, only the cells that changed are sent, unless the
+        // observer could not apply the last delta
+        if (obs->takeFullStateRequest())
+            binaryBaselines[observerId].clear();
+
+        in << binaryBaselines[observerId].serialize(getId(), TObsCell, columns);
+        return in;
+    }
+
     int obsCurrentState = 0; //serverSession->getState(observerId);
     QString content;
 
@@ -928,9 +1098,111 @@ QString luaCellularSpace::pop(lua_State *luaL, QStringList& attribs)
     return msg;
 }
 
+void luaCellularSpace::popColumns(lua_State *luaL, QStringList& attribs, QVector<BinaryColumn>& columns)
+{
+	getReference(luaL);
+	lua->pushString(luaL, "cells");
+	lua->pushTableAt(luaL, -2);
+
+	int cellsPos = lua->getTopIndex(luaL);
+
+	// each cell is read once and its values are stored by column
+	int numColumns = attribs.size();
+	QVector<BinaryColumn> values(numColumns);
+	QVector<std::string> keys(numColumns);
+
+	int expected = CellularSpace::size();
+	for (int i = 0; i < numColumns; i++)
+	{
+		keys[i] = attribs.at(i).toStdString();
+		values[i].key = attribs.at(i);
+		values[i].numbers.reserve(expected);
+	}
+
+	int elements = 0;
+
+	lua->pushNil(luaL);
+	while (lua->nextAt(luaL, cellsPos) != 0)
+	{
+		int cellTop = lua->getTopIndex(luaL);
+
+		for (int i = 0; i < numColumns; i++)
+		{
+			BinaryColumn &column = values[i];
+
+			lua->pushString(luaL, keys.at(i));
+			lua->pushTableAt(luaL, cellTop);
+
+			int luaType = lua->getTypeAt(luaL, -1);
+
+			// the type of the column is the type of the first value that is not nil,
+			// the cells read before it are filled as not informed
+			if (column.type == TObsUnknownData)
+			{
+				if (lua->isNumber(luaType))
+				{
+					column.type = TObsNumber;
+					column.numbers.fill(qQNaN(), elements);
+				}
+				else if (lua->isString(luaType))
+				{
+					column.type = TObsText;
+					column.texts.reserve(expected);
+					for (int j = 0; j < elements; j++)
+						column.texts.append(VALUE_NOT_INFORMED);
+				}
+				else if (lua->isBoolean(luaType))
+				{
+					column.type = TObsBool;
+					column.bools.fill(false, elements);
+				}
+			}
+
+			switch (column.type)
+			{
+			case TObsNumber:
+				column.numbers.append(lua->isNumber(luaType) ? lua->getNumberAt(luaL, -1) : qQNaN());
+				break;
+
+			case TObsText:
+			{
+				QString text;
+				if (lua->isString(luaType) || lua->isNumber(luaType))
+					text = QString(lua->getStringAtTop(luaL).c_str());
+
+				column.texts.append(text.isEmpty() ? VALUE_NOT_INFORMED : text);
+				break;
+			}
+
+			case TObsBool:
+				column.bools.append(lua->isBoolean(luaType) && lua->toBooleanAt(luaL, -1));
+				break;
+
+			default:
+				break;
+			}
+
+			lua->popOneElement(luaL);
+		}
+
+		elements++;
+		lua->popOneElement(luaL);
+	}
+
+	lua->pop(luaL, 2); // cells and cellular space
+
+	columns.clear();
+	for (int i = 0; i < numColumns; i++)
+	{
+		if (values.at(i).type != TObsUnknownData)
+			columns.append(values.at(i));
+	}
+}
+
 int luaCellularSpace::kill(lua_State *luaL)
 {
     int id = lua->getNumberAt(luaL, 1);
+    binaryBaselines.remove(id);
 
     bool result = CellSpaceSubjectInterf::kill(id);
     lua->pushBoolean(luaL, result);
@@ -962,7 +1234,5 @@ luaCell * luaCellularSpace::findCellByID(const char* cellID)
 /// Find a cell given a luaCellularSpace object and a luaCellIndex object
 luaCell * findCell(luaCellularSpace* cs, CellIndex& cellIndex)
 {
-    Region_<CellIndex>::iterator it = cs->find(cellIndex);
-    if (it != cs->end()) return(luaCell*)it->second;
-    return(luaCell*)0;
+    return(luaCell*)cs->getCell(cellIndex);
 }
@@ -32,6 +32,7 @@ of this software and its documentation.
 #include <QString>
 
 #include "../observer/cellSpaceSubjectInterf.h"
+#include "../observer/protocol/decoder/binaryState.h"
 #include "reference.h"
 #include "luaCell.h"
 #include "LuaApi.h"
@@ -95,6 +96,19 @@ public:
     /// parameters: x, y, luaCell
     int addCell(lua_State *L);
 
+    /// Declares the luaCellularSpace as a regular grid stored in a dense array
+    /// parameters: xMin, yMin, xdim, ydim
+    int setGrid(lua_State *L);
+
+    /// Builds the neighborhoods of a regular luaCellularSpace from a stencil of relative positions
+    /// parameters: stencil offsets, wrap, average
+    /// return first, neighbors, and weights arrays in compressed sparse row form
+    int createStencilNeighborhood(lua_State *L);
+
+    /// Copies the current values of the cells into columns of past values
+    /// parameters: cells, attribute names, columns
+    int synchronizeColumns(lua_State *L);
+
     /// Returns the number of cells of the CellularSpace object
     /// no parameters
     int size(lua_State* L);
@@ -151,6 +165,12 @@ public:
     /// \param attribs the list of attributes observed
     QString pop(lua_State *L, QStringList& attribs);
 
+    /// Gets the attributes of the cells as columns, one value per cell
+    /// \param attribs the list of attributes observed
+    /// \param columns the vector where the columns will be stored
+    /// \see BinaryColumn
+    void popColumns(lua_State *L, QStringList& attribs, QVector<BinaryColumn>& columns);
+
     /// Destroys the observer object instance
     int kill(lua_State *L);
 
@@ -176,6 +196,7 @@ private:
     QHash<int, Observer *> observersHash;
     QString getAll(QDataStream& in, int obsId, QStringList& attribs);
     QString getChanges(QDataStream& in, int obsId, QStringList& attribs);
+    QHash<int, BinaryStateBaseline> binaryBaselines; ///< last binary state sent to each observer
 
 	terrame::lua::LuaApi* lua;
 
@@ -65,3 +65,13 @@ int luaChart::restart(lua_State* L)
 
 	return 0;
 }
+
+int luaChart::setBuffer(lua_State* L)
+{
+	int resolution = (int) luaL_checkinteger(L, -1);
+	int capacity = (int) luaL_checkinteger(L, -2);
+
+	obs->setBuffer(capacity, resolution);
+
+	return 0;
+}
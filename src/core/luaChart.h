@@ -63,6 +63,10 @@ public:
 
 	int restart(lua_State* L);
 
+	/// Sets the capacity and the resolution of the curves.
+	/// \see ObserverGraphic::setBuffer
+	int setBuffer(lua_State* L);
+
 public:
 	ObserverGraphic* obs;
 };
@@ -502,6 +502,8 @@ int luaGlobalAgent::createObserver(lua_State *L)
             obsLog->setFileName(cols.at(0));
             obsLog->setSeparator(cols.at(1));
 			obsLog->setWriteMode(cols.at(2));
+			if (cols.size() > 3)
+				obsLog->setFlushRows(cols.at(3).toInt());
 
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsLog);
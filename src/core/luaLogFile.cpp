@@ -29,6 +29,7 @@ of this software and its documentation.
 luaLogFile::luaLogFile(lua_State* L)
 {
 	luaL = L;
+	obs = 0;
 }
 
 int luaLogFile::setObserver(lua_State* L)
@@ -38,6 +39,13 @@ int luaLogFile::setObserver(lua_State* L)
     return 0;
 }
 
+int luaLogFile::flush(lua_State* L)
+{
+    if (obs)
+        obs->flush();
+    return 0;
+}
+
 luaLogFile::~luaLogFile(void)
 {
 }
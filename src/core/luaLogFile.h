@@ -51,6 +51,9 @@ public:
 
 	int setObserver(lua_State* L);
 
+	/// Writes the lines kept in memory by the observer into the file
+	int flush(lua_State* L);
+
 	/// destructor
         ~luaLogFile(void);
 
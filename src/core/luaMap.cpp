@@ -23,18 +23,32 @@ of this software and its documentation.
 
 #include "luaMap.h"
 #include "observerMap.h"
+#include "observerImage.h"
 #include "luna.h"
 #include "terrameGlobals.h"
 
 luaMap::luaMap(lua_State* L)
 {
 	luaL = L;
+	obs = 0;
+	image = 0;
 }
 
 int luaMap::setObserver(lua_State* L)
 {
-	ObserverMap * obsg =(ObserverMap*) lua_touserdata(L, -1);
-	obs = obsg;
+	void *obsg = lua_touserdata(L, 1);
+	int type = lua_isnoneornil(L, 2) ? TObsMap : (int) luaL_checkinteger(L, 2);
+
+	if (type == TObsImage)
+	{
+		obs = 0;
+		image = (ObserverImage*) obsg;
+	}
+	else
+	{
+		obs = (ObserverMap*) obsg;
+		image = 0;
+	}
 	return 0;
 }
 
@@ -47,7 +61,10 @@ int luaMap::save(lua_State* L)
 	std::string e = luaL_checkstring(L, -1);
 	std::string f = luaL_checkstring(L, -2);
 
-	obs->save(f, e);
+	if (image)
+		image->save(f, e);
+	else
+		obs->save(f, e);
 
 	return 0;
 }
@@ -59,7 +76,10 @@ int luaMap::setGridVisible(lua_State *L)
 #else
     int v = luaL_checkinteger(L, -1);
 #endif
-    obs->setGridVisible(v);
+    if (image)
+        image->setGridVisible(v);
+    else
+        obs->setGridVisible(v);
 
 	return 0;
 }
@@ -68,7 +88,25 @@ int luaMap::setTitle(lua_State *L)
 {
 	std::string title = luaL_checkstring(L, -1);
 
-	obs->setTitle(title);
+	if (image)
+		image->setTitle(title);
+	else
+		obs->setTitle(title);
+
+	return 0;
+}
+
+int luaMap::setProtocolFormat(lua_State *L)
+{
+#if LUA_VERSION_NUM < 503
+    int format = luaL_checkint(L, -1);
+#else
+    int format = luaL_checkinteger(L, -1);
+#endif
+    if (image)
+        image->setProtocolFormat((TerraMEObserver::ProtocolFormats) format);
+    else
+        obs->setProtocolFormat((TerraMEObserver::ProtocolFormats) format);
 
 	return 0;
 }
@@ -30,6 +30,7 @@ of this software and its documentation.
 #define LUAMAP_H
 
 #include "observerMap.h"
+#include "observerImage.h"
 #include "reference.h"
 #include "luna.h"
 
@@ -52,6 +53,9 @@ public:
 	/// constructor
 	luaMap(lua_State* L);
 
+	/// Sets the observer that draws the map
+	/// parameters: the observer, its TerraMEObserver::TypesOfObservers value,
+	/// TObsMap if it is not given
 	int setObserver(lua_State* L);
 
 	/// destructor
@@ -63,8 +67,13 @@ public:
 
 	int setTitle(lua_State *L);
 
+	/// Sets the format used by the target to send its state to the Map
+	/// parameter: a TerraMEObserver::ProtocolFormats value
+	int setProtocolFormat(lua_State *L);
+
 public:
 	ObserverMap* obs;
+	ObserverImage* image; ///< used instead of obs when TerraME runs with -headless
 };
 
 #endif
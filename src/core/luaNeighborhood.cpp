@@ -43,6 +43,47 @@ luaNeighborhood::luaNeighborhood(lua_State *L) {
 /// destructor
 luaNeighborhood::~luaNeighborhood(void) { }
 
+/// Adds a neighbor keeping the Neighborhood iterator in the same neighbor,
+/// as the neighbors are stored in a vector that may be reallocated.
+void luaNeighborhood::insertNeighbor(CellIndex& cellIndex, luaCell *cell, double weight)
+{
+    bool atEnd = it == CellNeighborhood::end();
+    int position = atEnd ? 0 : (int)(it - CellNeighborhood::begin());
+
+    CellNeighborhood::add(cellIndex, (Cell*)cell, weight);
+
+    it = atEnd ? CellNeighborhood::end() : CellNeighborhood::begin() + position;
+}
+
+/// Removes a neighbor keeping the Neighborhood iterator valid. When the neighbor pointed
+/// by the iterator is removed, the iterator moves to the next one and the following
+/// call to next() is ignored.
+void luaNeighborhood::removeNeighbor(CellIndex& cellIndex)
+{
+    CellNeighborhood::iterator location = CellNeighborhood::find(cellIndex);
+    if (location == CellNeighborhood::end())
+        return;
+
+    bool atEnd = it == CellNeighborhood::end();
+    int position = atEnd ? 0 : (int)(it - CellNeighborhood::begin());
+    int erased = (int)(location - CellNeighborhood::begin());
+
+    CellNeighborhood::erase(cellIndex);
+
+    if (atEnd)
+    {
+        it = CellNeighborhood::end();
+        return;
+    }
+
+    if (erased < position)
+        position--;
+    else if (erased == position)
+        itNext = true;
+
+    it = CellNeighborhood::begin() + position;
+}
+
 /// Adds a new cell to the luaNeigborhood
 /// parameters: cell.y, cell.x,  cell, weight
 /// return luaCell
@@ -53,7 +94,7 @@ int luaNeighborhood::addNeighbor(lua_State *L) {
     cellIndex.second = lua->getNumberAt(L, -3);
     cellIndex.first = lua->getNumberAt(L, -4);
     if (cell != NULL) {
-        CellNeighborhood::add(cellIndex, (Cell*)cell, weight);
+        insertNeighbor(cellIndex, cell, weight);
         cell->getReference(L);
     }
     else lua->pushNil(L);
@@ -68,11 +109,7 @@ int luaNeighborhood::eraseNeighbor(lua_State *L) {
 	CellIndex cellIndex;
 	cellIndex.second = lua->getNumberAt(L, -2);
 	cellIndex.first = lua->getNumberAt(L, -3);
-	if (it != CellNeighborhood::end() && it->first == cellIndex){
-		it++;
-		itNext = true;
-	}
-	CellNeighborhood::erase(cellIndex);
+	removeNeighbor(cellIndex);
 	return 0;
 }
 
@@ -89,7 +126,7 @@ int luaNeighborhood::addCell(lua_State *L) {
 	cellIndex.second = cI->y;
     luaCell *cell = ::findCell(cs, cellIndex);
     if (cell != NULL) {
-        CellNeighborhood::add(cellIndex, (Cell*)cell, weight);
+        insertNeighbor(cellIndex, cell, weight);
         cell->getReference(L);
     }
     else lua->pushNil(L);
@@ -103,13 +140,7 @@ int luaNeighborhood::eraseCell(lua_State *L) {
     CellIndex cellIndex; //TODO(avancinirodrigo): repetitions below
 	cellIndex.first = cI->x;
 	cellIndex.second = cI->y;
-    // Raian: Coloquei esta compara??o porque quando um vizinho era retirado da vizinhan?a o iterador era invalidado
-    // Aqui fa?o o tratamento para que isto n?o ocorra.
-    if (it != CellNeighborhood::end() && it->first == cellIndex){
-        it++;
-        itNext = true;
-    }
-    CellNeighborhood::erase(cellIndex);
+    removeNeighbor(cellIndex);
     return 0;
 }
 
@@ -306,17 +337,10 @@ int luaNeighborhood::isNeighbor(lua_State *L)
   CellIndex cellIndex;
   cellIndex.second = lua->getNumberAt(L, -2);
   cellIndex.first = lua->getNumberAt(L, -3);
-  CellNeighborhood::iterator itAux;
-  itAux = CellNeighborhood::begin();
-  bool isneighbor = false;
-  while (itAux != CellNeighborhood::end()){
-	  // RAIAN: adicionei aqui a comparacao do proprio ponteiro, pois ha casos que o vizinho esta em outro CS e pode ter um indice igual
-	  // ao de uma celula do proprio espaco celular que nao e vizinha.
-	  if (itAux->first == cellIndex && itAux->second == cell){
-		  isneighbor = true;
-	  }
-	  itAux++;
-  }
+  CellNeighborhood::iterator itAux = CellNeighborhood::find(cellIndex);
+  // RAIAN: adicionei aqui a comparacao do proprio ponteiro, pois ha casos que o vizinho esta em outro CS e pode ter um indice igual
+  // ao de uma celula do proprio espaco celular que nao e vizinha.
+  bool isneighbor = itAux != CellNeighborhood::end() && itAux->second == cell;
   lua->pushBoolean(L, isneighbor);
   return 1;
 }
@@ -372,6 +396,8 @@ int luaNeighborhood::isEmpty(lua_State *L) {
 /// no parameters
 int luaNeighborhood::clear(lua_State *L) {
     CellNeighborhood::clear();
+    it = CellNeighborhood::end();
+    itNext = false;
     return 0;
 }
 
@@ -57,6 +57,9 @@ class luaNeighborhood : public CellNeighborhood, public Reference<luaNeighborhoo
 
     TypesOfSubjects subjectType;
 
+    void insertNeighbor(CellIndex& cellIndex, luaCell *cell, double weight);
+    void removeNeighbor(CellIndex& cellIndex);
+
 public:
     ///< Data structure issued by Luna<T>
     static const char className[];
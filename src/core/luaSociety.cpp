@@ -355,6 +355,8 @@ int luaSociety::createObserver(lua_State *)
             obsLog->setFileName(cols.at(0));
             obsLog->setSeparator(cols.at(1));
 			obsLog->setWriteMode(cols.at(2));
+			if (cols.size() > 3)
+				obsLog->setFlushRows(cols.at(3).toInt());
 
             lua_pushnumber(luaL, obsId);
             lua_pushlightuserdata(luaL, (void*) obsLog);
@@ -35,6 +35,9 @@ of this software and its documentation.
 #ifndef NEIGHBOURHOOD_H
 #define NEIGHBOURHOOD_H
 
+#include <unordered_map>
+#include <vector>
+
 #include "region.h"
 
 class Cell;
@@ -46,6 +49,32 @@ class Cell;
  */
 typedef pair<int, int> CellIndex;
 
+/**
+ * \brief
+ *  Hash function for CellIndex, used to find neighbors in constant time.
+ *
+ */
+struct CellIndexHash
+{
+    size_t operator()(const CellIndex& cI) const
+    {
+        return std::hash<long long>()(((long long) cI.first << 32) ^ (unsigned int) cI.second);
+    }
+};
+
+/**
+ * \brief
+ *  A neighbor of a Neighborhood: its CellIndex (first), its Cell (second) and the weight of the arrow.
+ *
+ */
+struct CellNeighbor : public pair<CellIndex, Cell*>
+{
+    double weight; ///< the arrow weight
+
+    CellNeighbor(const CellIndex& cellIndex, Cell* cell, double weight)
+        : pair<CellIndex, Cell*>(cellIndex, cell), weight(weight) {}
+};
+
 /**
  * \brief
  *  Implementation for a Neighborhood object.
@@ -54,42 +83,49 @@ typedef pair<int, int> CellIndex;
 class CellNeighborhoodImpl : public Implementation
 {
     string ID;  ///< Neighborhood identifier
-    Region_<CellIndex> neighs; ///< a neighborhood it is a region(map) on cell indexes.
-    CompositeInterface< mapComposite<CellIndex, double> > weights; ///< the arrows weights are stored in a separated composite
+    vector<CellNeighbor> neighs; ///< neighbors and weights stored together, in insertion order
+    unordered_map<CellIndex, int, CellIndexHash> positions; ///< position of each CellIndex in neighs
 
 	//@RAIAN: Parent cell of the neighborhood
 	Cell* parent; ///< Neighborhood parent. It is "central" cell in the neighborhood graph.
 public:
-    typedef Region_<CellIndex>::iterator iterator;
+    typedef vector<CellNeighbor>::iterator iterator;
 
     //@RAIAN: I created a constructor to set the parent to NULL
     /// Default constructor
     CellNeighborhoodImpl(Cell* parent = 0) : parent(parent) {}
     //@RAIAN: END
 
-    /// Adds a new neighbor cell to the cells neighborhood map
+    /// Adds a new neighbor cell to the cells neighborhood. A CellIndex belongs to the
+    /// neighborhood at most once: adding it again keeps the first cell and weight.
     /// \param cellIndex is a reference to "CellIndex" with the possible n-dimensional coordinate of the cell
     /// \param cell is a pointer to cell object being added as neighbor
     /// \param weight is double value
     void add(CellIndex& cellIndex, Cell* cell, double weight = 0)
     {
-        pair<CellIndex, double> indexWeightPair;
-
-        indexWeightPair.first  = cellIndex;
-        indexWeightPair.second = weight;
+        if (positions.find(cellIndex) != positions.end())
+            return;
 
-        neighs.add(cellIndex, cell);
-        weights.add(indexWeightPair);
+        positions[cellIndex] = (int) neighs.size();
+        neighs.push_back(CellNeighbor(cellIndex, cell, weight));
     }
 
-    /// Removes a cell from the cell neighborhood.
+    /// Removes a cell from the cell neighborhood, keeping the order of the other neighbors.
     /// \param cellIndex is a reference to a "CellIndex" with the n-dimensional coordinate of the cell to be excluded.
     bool erase(CellIndex& cellIndex)
     {
-        if (neighs.erase(cellIndex) && weights.erase(cellIndex))
-            return true;
-        else
+        unordered_map<CellIndex, int, CellIndexHash>::iterator location = positions.find(cellIndex);
+        if (location == positions.end())
             return false;
+
+        int position = location->second;
+        positions.erase(location);
+        neighs.erase(neighs.begin() + position);
+
+        for (int i = position; i < (int) neighs.size(); i++)
+            positions[neighs[i].first] = i;
+
+        return true;
     }
 
     /// Puts the neighborhood iterator in the beggining of the neighborhood composite.
@@ -105,7 +141,7 @@ public:
     bool empty(void) { return neighs.empty(); }
 
     /// Clears the neighborhood data structure.
-    void clear(void) { neighs.clear(); weights.clear(); }
+    void clear(void) { neighs.clear(); positions.clear(); }
 
     /// Returns the number of cells in the neighborhood
     /// \return a integer number
@@ -114,27 +150,46 @@ public:
     /// Searchs for a cell in the neighborhood composite. Similar to the "find" method semantics.
     /// \param i is a CellIndex representing a n-dimensional coordinate
     /// \return a pointer to Cell if it has been found, otherwise a NULL pointer.
-    Cell* operator [](CellIndex i) { return neighs[i]; }
+    Cell* operator [](CellIndex i) { return getNeighbor(i); }
 
     /// Searches for a cell in the neighborhood composite.
     /// \param k is a CellIndex representing a n-dimensional coordinate
-    /// \return a pointer to Cell if it has been found, otherwise a NULL pointer.
-    iterator find(CellIndex k) { return neighs.find(k); }
+    /// \return an iterator to the neighbor if it has been found, otherwise end().
+    iterator find(CellIndex k)
+    {
+        unordered_map<CellIndex, int, CellIndexHash>::iterator location = positions.find(k);
+        if (location == positions.end())
+            return neighs.end();
+        return neighs.begin() + location->second;
+    }
 
     /// Gets the weigth of a neighboring relationship.
     /// \param cI is the CellIndex reference representing a n-dimensional coordinate
-    /// \return a double value
-    double getWeight(CellIndex& cI) { return weights[cI].second; }
+    /// \return a double value, zero if the cell is not a neighbor
+    double getWeight(CellIndex& cI)
+    {
+        iterator location = find(cI);
+        return location != neighs.end() ? location->weight : 0;
+    }
 
     /// Sets the weigth of a neighboring relationship.
     /// \param cI is the CellIndex reference representing a n-dimensional coordinate
     /// \param weight is a double number
-    void setWeight(CellIndex& cI, double weight = 0) { weights[cI].second = weight; }
+    void setWeight(CellIndex& cI, double weight = 0)
+    {
+        iterator location = find(cI);
+        if (location != neighs.end())
+            location->weight = weight;
+    }
 
     /// Searches for a cell in the neighborhood composite.
     /// \param cI is a CellIndex representing a n-dimensional coordinate
     /// \return a pointer to Cell if it has been found, otherwise a NULL pointer.
-    Cell* getNeighbor(CellIndex& cI) { return neighs[cI]; }
+    Cell* getNeighbor(CellIndex& cI)
+    {
+        iterator location = find(cI);
+        return location != neighs.end() ? location->second : NULL;
+    }
 
     /// Gets the Neighborhood identifier
     /// \return a string reference to the identifier
@@ -0,0 +1,702 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "neighborhoodFile.h"
+#include "csvFile.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+	#include <lauxlib.h>
+}
+
+static const quint32 NEIGHBORHOOD_MAGIC = 0x544D4E31; // "TMN1"
+static const quint32 NEIGHBORHOOD_VERSION = 1;
+
+static const char* ARRAY_METATABLE = "TerraME.NeighborhoodArray";
+
+namespace {
+
+/**
+* \brief
+*  Header of the binary cache. It is followed by the arrays first (cells + 1 values),
+*  neighbors (edges values), and weights (edges values, aligned to eight bytes), all of
+*  them in the byte order of the machine that created the file.
+*/
+struct NeighborhoodHeader
+{
+	quint32 magic;
+	quint32 version;
+	quint32 values;      // quantity of values of each neighbor in a GPM file
+	quint32 reserved;
+	qint64 sourceSize;   // size of the GAL, GPM, or GWT file
+	qint64 sourceTime;   // last modification of the file, in milliseconds
+	quint64 idsHash;     // hash of the ids of the Cells, in their order
+	qint64 cells;
+	qint64 edges;
+};
+
+struct NeighborhoodField
+{
+	const char* data;
+	int length;
+};
+
+enum NeighborhoodArrayKind {FirstArray, NeighborsArray, WeightsArray};
+
+static qint64 weightsOffset(qint64 cells, qint64 edges)
+{
+	qint64 offset = sizeof(NeighborhoodHeader) + sizeof(qint32) * (cells + 1 + edges);
+	return (offset + 7) & ~((qint64) 7);
+}
+
+static qint64 cacheSize(qint64 cells, qint64 edges)
+{
+	return weightsOffset(cells, edges) + sizeof(double) * edges;
+}
+
+/**
+* \brief
+*  Neighborhoods of all the Cells in compressed sparse row form, either mapped from
+*  the cache or stored in memory when the cache could not be written.
+*/
+class NeighborhoodData
+{
+public:
+	NeighborhoodData() : first(NULL), neighbors(NULL), weights(NULL), cells(0), edges(0) {}
+
+	bool map(const QString& path, const NeighborhoodHeader& expected);
+	bool write(const QString& path, const NeighborhoodHeader& header) const;
+	void useMemory();
+
+	std::vector<qint32> firstValues;
+	std::vector<qint32> neighborValues;
+	std::vector<double> weightValues;
+
+	const qint32* first;
+	const qint32* neighbors;
+	const double* weights;
+	int cells;
+	int edges;
+
+private:
+	QFile file;
+};
+
+/**
+* \brief
+*  One of the arrays of a NeighborhoodData, as seen from Lua.
+*/
+struct NeighborhoodArray
+{
+	QSharedPointer<NeighborhoodData> data;
+	NeighborhoodArrayKind kind;
+};
+
+/**
+* \brief
+*  Parses the lines of a GAL, GPM, or GWT file in the same way of the Lua loaders of
+*  CellularSpace, with a separator with a single space. It stops at the first line that
+*  the Lua loaders would not accept or would not load in the same way.
+*/
+class NeighborhoodParser
+{
+public:
+	NeighborhoodParser(const char* data, qint64 size, const QHash<QByteArray, int>& positions)
+		: data(data), size(size), pos(0), positions(positions) {}
+
+	bool parse(const QString& format, int quantity, QString& error);
+	bool build(NeighborhoodData& result, int cells, QString& error);
+
+private:
+	bool nextLine(const char*& line, int& length);
+	int split(const char* line, int length, QVector<NeighborhoodField>& fields);
+	int position(const NeighborhoodField& field) const;
+	bool parseGAL(int quantity, QString& error);
+	bool parseGWT(QString& error);
+
+	const char* data;
+	qint64 size;
+	qint64 pos;
+	const QHash<QByteArray, int>& positions;
+
+	std::vector<qint32> sources;
+	std::vector<qint32> targets;
+	std::vector<double> values;
+};
+
+} // namespace
+
+bool NeighborhoodData::map(const QString& path, const NeighborhoodHeader& expected)
+{
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadOnly) || file.size() < (qint64) sizeof(NeighborhoodHeader))
+	{
+		file.close();
+		return false;
+	}
+
+	uchar* bytes = file.map(0, file.size());
+	if (!bytes)
+	{
+		file.close();
+		return false;
+	}
+
+	NeighborhoodHeader header;
+	memcpy(&header, bytes, sizeof(header));
+
+	bool valid = header.magic == expected.magic && header.version == expected.version
+		&& header.values == expected.values && header.sourceSize == expected.sourceSize
+		&& header.sourceTime == expected.sourceTime && header.idsHash == expected.idsHash
+		&& header.cells == expected.cells && header.edges >= 0 && header.edges <= INT_MAX
+		&& file.size() == cacheSize(header.cells, header.edges);
+
+	if (valid)
+	{
+		cells = (int) header.cells;
+		edges = (int) header.edges;
+		first = (const qint32*) (bytes + sizeof(NeighborhoodHeader));
+		neighbors = first + cells + 1;
+		weights = (const double*) (bytes + weightsOffset(cells, edges));
+
+		// a damaged cache must not make Lua read out of the arrays
+		valid = first[0] == 0 && first[cells] == edges;
+		for (int i = 0; valid && i < cells; i++)
+			valid = first[i] <= first[i + 1];
+		for (int i = 0; valid && i < edges; i++)
+			valid = neighbors[i] >= 0 && neighbors[i] < cells;
+	}
+
+	if (!valid)
+	{
+		file.unmap(bytes);
+		file.close();
+		first = neighbors = NULL;
+		weights = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+bool NeighborhoodData::write(const QString& path, const NeighborhoodHeader& header) const
+{
+	QFile out(path + ".tmp");
+	if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	qint64 padding = weightsOffset(cells, edges) - sizeof(NeighborhoodHeader)
+		- sizeof(qint32) * (cells + 1 + edges);
+	static const char zeros[8] = {0};
+
+	bool ok = out.write((const char*) &header, sizeof(header)) == (qint64) sizeof(header)
+		&& out.write((const char*) first, sizeof(qint32) * (cells + 1)) == (qint64) sizeof(qint32) * (cells + 1)
+		&& out.write((const char*) neighbors, sizeof(qint32) * edges) == (qint64) sizeof(qint32) * edges
+		&& out.write(zeros, padding) == padding
+		&& out.write((const char*) weights, sizeof(double) * edges) == (qint64) sizeof(double) * edges;
+
+	out.close();
+
+	if (!ok || out.error() != QFile::NoError)
+	{
+		out.remove();
+		return false;
+	}
+
+	QFile::remove(path);
+	return out.rename(path);
+}
+
+void NeighborhoodData::useMemory()
+{
+	first = firstValues.data();
+	neighbors = neighborValues.data();
+	weights = weightValues.data();
+}
+
+bool NeighborhoodParser::nextLine(const char*& line, int& length)
+{
+	if (pos >= size) return false;
+
+	const char* begin = data + pos;
+	const char* end = (const char*) memchr(begin, '\n', size - pos);
+
+	line = begin;
+	length = (int) ((end ? end : data + size) - begin);
+	pos = end ? end - data + 1 : size;
+	return true;
+}
+
+// splits a line as parseLine() with a space as separator, returning the number of fields,
+// or -1 if it has quotes, whose values are not expected in these files
+int NeighborhoodParser::split(const char* line, int length, QVector<NeighborhoodField>& fields)
+{
+	static const char* spaces = " \t\n\v\f\r";
+
+	if (memchr(line, '"', length)) return -1;
+
+	int count = 0;
+	int begin = 0;
+
+	while (begin < length)
+	{
+		const char* found = (const char*) memchr(line + begin, ' ', length - begin);
+		int end = found ? (int) (found - line) : length;
+
+		if (count == fields.size())
+			fields.resize(count + 16);
+
+		NeighborhoodField& field = fields[count++];
+		field.data = line + begin;
+		field.length = end - begin;
+
+		while (field.length > 0 && field.data[0] != '\0' && strchr(spaces, field.data[0]))
+		{
+			field.data++;
+			field.length--;
+		}
+
+		while (field.length > 0 && field.data[field.length - 1] != '\0' && strchr(spaces, field.data[field.length - 1]))
+			field.length--;
+
+		begin = end + 1;
+	}
+
+	return count;
+}
+
+int NeighborhoodParser::position(const NeighborhoodField& field) const
+{
+	return positions.value(QByteArray::fromRawData(field.data, field.length), -1);
+}
+
+bool NeighborhoodParser::parse(const QString& format, int quantity, QString& error)
+{
+	const char* line;
+	int length;
+
+	nextLine(line, length); // the header is checked by the Lua loaders
+
+	if (format == "gwt")
+		return parseGWT(error);
+
+	return parseGAL(format == "gpm" ? quantity : 0, error);
+}
+
+// GAL files and GPM files share the same structure: a line with the id and the quantity
+// of neighbors, followed by a line with the neighbors, which in GPM files can have
+// weights. The argument quantity is zero for GAL files.
+bool NeighborhoodParser::parseGAL(int quantity, QString& error)
+{
+	QVector<NeighborhoodField> line, neighbors;
+	const char* text;
+	int length;
+
+	while (nextLine(text, length))
+	{
+		int fields = split(text, length, line);
+		if (fields == 0) break;
+
+		int cell = fields < 0 ? -1 : position(line[0]);
+		double count;
+
+		if (cell < 0 || fields < 2 || !csvToNumber(line[1].data, line[1].length, count))
+		{
+			error = "Line with an unknown id or without the quantity of neighbors.";
+			return false;
+		}
+
+		int found = 0;
+		if (nextLine(text, length))
+			found = split(text, length, neighbors);
+
+		if (found < 0)
+		{
+			error = "Line with quotes.";
+			return false;
+		}
+
+		if (quantity == 0)
+		{
+			for (double i = 1; i <= count; i++)
+			{
+				int neighbor = i <= found ? position(neighbors[(int) i - 1]) : -1;
+				if (neighbor < 0)
+				{
+					error = "Line with an unknown neighbor.";
+					return false;
+				}
+
+				sources.push_back(cell);
+				targets.push_back(neighbor);
+				values.push_back(1);
+			}
+
+			continue;
+		}
+
+		double limit = floor(count * 2);
+
+		for (double i = 1; i <= limit; i += quantity)
+		{
+			if (i > found)
+			{
+				if (count * quantity >= i)
+				{
+					error = "Line with less neighbors than expected.";
+					return false;
+				}
+
+				continue;
+			}
+
+			int neighbor = position(neighbors[(int) i - 1]);
+			if (neighbor < 0) continue; // as the Lua loader, ignore unknown neighbors
+
+			double weight = 1;
+			if (quantity == 2)
+			{
+				if (i + 1 > found)
+				{
+					error = "Line without the weight of a neighbor.";
+					return false;
+				}
+
+				const NeighborhoodField& field = neighbors[(int) i];
+				if (!csvToNumber(field.data, field.length, weight))
+					weight = 1;
+			}
+
+			sources.push_back(cell);
+			targets.push_back(neighbor);
+			values.push_back(weight);
+		}
+	}
+
+	return true;
+}
+
+bool NeighborhoodParser::parseGWT(QString& error)
+{
+	QVector<NeighborhoodField> line;
+	const char* text;
+	int length;
+
+	while (nextLine(text, length))
+	{
+		int fields = split(text, length, line);
+		if (fields == 0) break;
+
+		int cell = fields < 0 ? -1 : position(line[0]);
+		int neighbor = fields < 3 ? -1 : position(line[1]);
+
+		if (cell < 0 || neighbor < 0)
+		{
+			error = "Line with an unknown id.";
+			return false;
+		}
+
+		double weight;
+		if (!csvToNumber(line[2].data, line[2].length, weight))
+			weight = 1;
+
+		sources.push_back(cell);
+		targets.push_back(neighbor);
+		values.push_back(weight);
+	}
+
+	return true;
+}
+
+// sorts the neighbors by Cell keeping the order of the file, as a counting sort
+bool NeighborhoodParser::build(NeighborhoodData& result, int cells, QString& error)
+{
+	if (sources.size() > (size_t) INT_MAX)
+	{
+		error = "Too many neighbors.";
+		return false;
+	}
+
+	int edges = (int) sources.size();
+
+	result.cells = cells;
+	result.edges = edges;
+	result.firstValues.assign(cells + 1, 0);
+	result.neighborValues.resize(edges);
+	result.weightValues.resize(edges);
+
+	std::vector<qint32>& first = result.firstValues;
+
+	for (int i = 0; i < edges; i++)
+		first[sources[i] + 1]++;
+
+	for (int i = 0; i < cells; i++)
+		first[i + 1] += first[i];
+
+	std::vector<qint32> next(first.begin(), first.end() - 1);
+
+	for (int i = 0; i < edges; i++)
+	{
+		int k = next[sources[i]]++;
+		result.neighborValues[k] = targets[i];
+		result.weightValues[k] = values[i];
+	}
+
+	// the Lua loaders stop when a Cell is added twice to the same Neighborhood
+	std::vector<qint32> stamp(cells, -1);
+	for (int cell = 0; cell < cells; cell++)
+	{
+		for (int k = first[cell]; k < first[cell + 1]; k++)
+		{
+			int neighbor = result.neighborValues[k];
+			if (stamp[neighbor] == cell)
+			{
+				error = "Repeated neighbor.";
+				return false;
+			}
+
+			stamp[neighbor] = cell;
+		}
+	}
+
+	result.useMemory();
+	return true;
+}
+
+static NeighborhoodArray* checkArray(lua_State* L)
+{
+	return *(NeighborhoodArray**) luaL_checkudata(L, 1, ARRAY_METATABLE);
+}
+
+static int arrayIndex(lua_State* L)
+{
+	NeighborhoodArray* array = checkArray(L);
+	const NeighborhoodData* data = array->data.data();
+	int isInteger;
+	lua_Integer i = lua_tointegerx(L, 2, &isInteger) - 1;
+
+	if (!isInteger || i < 0)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	switch (array->kind)
+	{
+	case FirstArray:
+		if (i <= data->cells) lua_pushinteger(L, data->first[i] + 1);
+		else lua_pushnil(L);
+		break;
+	case NeighborsArray:
+		if (i < data->edges) lua_pushinteger(L, data->neighbors[i] + 1);
+		else lua_pushnil(L);
+		break;
+	case WeightsArray:
+		if (i < data->edges)
+		{
+			// integral weights are integers, as tonumber() returns for them in the files
+			double weight = data->weights[i];
+			if (weight == floor(weight) && fabs(weight) < 9007199254740992.0)
+				lua_pushinteger(L, (lua_Integer) weight);
+			else
+				lua_pushnumber(L, weight);
+		}
+		else
+			lua_pushnil(L);
+		break;
+	}
+
+	return 1;
+}
+
+static int arrayLength(lua_State* L)
+{
+	NeighborhoodArray* array = checkArray(L);
+	const NeighborhoodData* data = array->data.data();
+
+	lua_pushinteger(L, array->kind == FirstArray ? data->cells + 1 : data->edges);
+	return 1;
+}
+
+static int arrayGc(lua_State* L)
+{
+	NeighborhoodArray** array = (NeighborhoodArray**) luaL_checkudata(L, 1, ARRAY_METATABLE);
+	delete *array;
+	*array = NULL;
+	return 0;
+}
+
+static void pushArray(lua_State* L, const QSharedPointer<NeighborhoodData>& data, NeighborhoodArrayKind kind)
+{
+	NeighborhoodArray** array = (NeighborhoodArray**) lua_newuserdata(L, sizeof(NeighborhoodArray*));
+	*array = new NeighborhoodArray();
+	(*array)->data = data;
+	(*array)->kind = kind;
+
+	if (luaL_newmetatable(L, ARRAY_METATABLE))
+	{
+		lua_pushcfunction(L, arrayIndex);
+		lua_setfield(L, -2, "__index");
+
+		lua_pushcfunction(L, arrayLength);
+		lua_setfield(L, -2, "__len");
+
+		lua_pushcfunction(L, arrayGc);
+		lua_setfield(L, -2, "__gc");
+	}
+
+	lua_setmetatable(L, -2);
+}
+
+// the cache is stored in the cache directory of the user, as the files are usually in
+// the data directories of the packages, where new files must not be created, and a shared
+// directory would be owned by the first user and could receive caches made by anyone.
+// Returns an empty string if there is no such directory, and then the cache is not used
+static QString cachePath(const QFileInfo& source, const QString& format, int values)
+{
+	QString location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if (location.isEmpty())
+		return QString();
+
+	QDir dir(location);
+	if (!dir.mkpath("neighborhoods"))
+		return QString();
+
+	QByteArray key = QString("%1\n%2\n%3").arg(source.absoluteFilePath()).arg(format).arg(values).toUtf8();
+	QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex();
+
+	return dir.filePath(QString("neighborhoods/%1.tmn").arg(QString(hash)));
+}
+
+int cpp_neighborhoodload(lua_State *L)
+{
+	QString path(luaL_checkstring(L, 1));
+	QString format(luaL_checkstring(L, 2));
+	int values = (int) luaL_checkinteger(L, 3);
+	luaL_checktype(L, 4, LUA_TTABLE);
+
+	int cells = (int) lua_rawlen(L, 4);
+	QHash<QByteArray, int> positions;
+	positions.reserve(cells);
+
+	// FNV-1a of the ids, separated by zeros
+	quint64 idsHash = 14695981039346656037ULL;
+
+	for (int i = 0; i < cells; i++)
+	{
+		lua_rawgeti(L, 4, i + 1);
+		if (lua_type(L, -1) != LUA_TSTRING)
+		{
+			lua_pop(L, 1);
+			lua_pushnil(L);
+			lua_pushstring(L, "The ids of the Cells must be strings.");
+			return 2;
+		}
+
+		size_t length;
+		const char* id = lua_tolstring(L, -1, &length);
+
+		for (size_t k = 0; k <= length; k++)
+		{
+			idsHash ^= (uchar) (k < length ? id[k] : '\0');
+			idsHash *= 1099511628211ULL;
+		}
+
+		positions.insert(QByteArray(id, (int) length), i); // as CellularSpace:get(), the last one wins
+		lua_pop(L, 1);
+	}
+
+	QFileInfo source(path);
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, QString("File '%1' could not be read.").arg(path).toUtf8().constData());
+		return 2;
+	}
+
+	NeighborhoodHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = NEIGHBORHOOD_MAGIC;
+	header.version = NEIGHBORHOOD_VERSION;
+	header.values = values;
+	header.sourceSize = file.size();
+	header.sourceTime = source.lastModified().toMSecsSinceEpoch();
+	header.idsHash = idsHash;
+	header.cells = cells;
+
+	QString cache = cachePath(source, format, values);
+	QSharedPointer<NeighborhoodData> data(new NeighborhoodData());
+
+	if (cache.isEmpty() || !data->map(cache, header))
+	{
+		qint64 size = file.size();
+		QByteArray contents;
+		const char* text = size > 0 ? (const char*) file.map(0, size) : NULL;
+
+		if (!text)
+		{
+			contents = file.readAll();
+			text = contents.constData();
+			size = contents.size();
+		}
+
+		NeighborhoodParser parser(text, size, positions);
+		QString error;
+
+		if (!parser.parse(format, values, error) || !parser.build(*data, cells, error))
+		{
+			lua_pushnil(L);
+			lua_pushstring(L, error.toUtf8().constData());
+			return 2;
+		}
+
+		header.edges = data->edges;
+
+		// the arrays in memory are released when the cache can be mapped
+		QSharedPointer<NeighborhoodData> mapped(new NeighborhoodData());
+		if (!cache.isEmpty() && data->write(cache, header) && mapped->map(cache, header))
+			data = mapped;
+	}
+
+	pushArray(L, data, FirstArray);
+	pushArray(L, data, NeighborsArray);
+	pushArray(L, data, WeightsArray);
+	return 3;
+}
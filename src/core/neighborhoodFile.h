@@ -0,0 +1,52 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*! \file neighborhoodFile.h
+\brief This file contains definitions about the binary cache of the Neighborhoods loaded
+	from GAL, GPM, and GWT files by CellularSpace:loadNeighborhood(). The cache stores the
+	Neighborhoods of all the Cells in compressed sparse row form and is memory-mapped when
+	the same file is loaded again for the same Cells.
+*/
+
+#ifndef NEIGHBORHOOD_FILE_H
+#define NEIGHBORHOOD_FILE_H
+
+extern "C"
+{
+	#include <lua.h>
+}
+
+/// Loads the Neighborhoods described in a GAL, GPM, or GWT file. Lua arguments: the file name,
+/// its format ("gal", "gpm", or "gwt"), the quantity of values for each neighbor in a GPM
+/// file (2 when the file has weights, 1 otherwise), and a vector with the ids of the Cells,
+/// in the order of the CellularSpace. The first call parses the file and stores the result
+/// in a binary cache in the user's cache directory. Later calls map the cache into memory
+/// if the file and the ids were not changed. Returns three read-only arrays (first, neighbors,
+/// and weights): the neighbors of the Cell in position p are neighbors[first[p]] to
+/// neighbors[first[p + 1] - 1], with weights in the same positions. Returns nil and a message
+/// when the file cannot be loaded natively, as when it has an id not found in the Cells or
+/// a repeated neighbor. In this case the file must be loaded by the Lua parser, which
+/// reports the error.
+int cpp_neighborhoodload(lua_State *L);
+
+#endif
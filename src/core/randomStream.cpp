@@ -0,0 +1,184 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "randomStream.h"
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <cmath>
+
+extern "C"
+{
+	#include <lauxlib.h>
+}
+
+static const quint32 PHILOX_M0 = 0xD2511F53;
+static const quint32 PHILOX_M1 = 0xCD9E8D57;
+static const quint32 PHILOX_W0 = 0x9E3779B9; // golden ratio
+static const quint32 PHILOX_W1 = 0xBB67AE85; // sqrt(3) - 1
+static const int PHILOX_ROUNDS = 10;
+
+// blocks generated together, in independent lanes that the compiler can vectorize
+static const int PHILOX_LANES = 8;
+
+static const double TWO_PI = 6.283185307179586;
+static const double TWO_POW_MINUS_53 = 1.0 / 9007199254740992.0;
+
+// converts two 32-bit words into a number in (0, 1) with 53 bits
+static inline double toUniform(quint32 high, quint32 low)
+{
+	quint64 bits = ((quint64) high << 21) | (low >> 11);
+	return (bits + 0.5) * TWO_POW_MINUS_53;
+}
+
+RandomStream::RandomStream(quint64 seed, quint64 stream, quint64 position)
+	: stream_(stream), position_(position)
+{
+	key_[0] = (quint32) seed;
+	key_[1] = (quint32) (seed >> 32);
+}
+
+void RandomStream::generate(double* values, int quantity)
+{
+	int blocks = (quantity + 1) / 2;
+	quint32 c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+
+	for (int first = 0; first < blocks; first += PHILOX_LANES)
+	{
+		for (int lane = 0; lane < PHILOX_LANES; lane++)
+		{
+			quint64 counter = position_ + first + lane;
+			c0[lane] = (quint32) counter;
+			c1[lane] = (quint32) (counter >> 32);
+			c2[lane] = (quint32) stream_;
+			c3[lane] = (quint32) (stream_ >> 32);
+		}
+
+		quint32 k0 = key_[0];
+		quint32 k1 = key_[1];
+
+		for (int round = 0; round < PHILOX_ROUNDS; round++)
+		{
+			for (int lane = 0; lane < PHILOX_LANES; lane++)
+			{
+				quint64 p0 = (quint64) PHILOX_M0 * c0[lane];
+				quint64 p1 = (quint64) PHILOX_M1 * c2[lane];
+
+				c0[lane] = (quint32) (p1 >> 32) ^ c1[lane] ^ k0;
+				c1[lane] = (quint32) p1;
+				c2[lane] = (quint32) (p0 >> 32) ^ c3[lane] ^ k1;
+				c3[lane] = (quint32) p0;
+			}
+
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+
+		int lanes = qMin(PHILOX_LANES, blocks - first);
+		for (int lane = 0; lane < lanes; lane++)
+		{
+			int i = 2 * (first + lane);
+			values[i] = toUniform(c0[lane], c1[lane]);
+
+			if (i + 1 < quantity)
+				values[i + 1] = toUniform(c2[lane], c3[lane]);
+		}
+	}
+
+	position_ += blocks;
+}
+
+void RandomStream::uniform(double* values, int quantity, double min, double max)
+{
+	generate(values, quantity);
+
+	double range = max - min;
+	for (int i = 0; i < quantity; i++)
+		values[i] = min + range * values[i];
+}
+
+void RandomStream::normal(double* values, int quantity, double mean, double sd)
+{
+	int pairs = quantity / 2;
+	generate(values, 2 * pairs);
+
+	for (int i = 0; i < 2 * pairs; i += 2)
+	{
+		double radius = sd * std::sqrt(-2.0 * std::log(values[i]));
+		double angle = TWO_PI * values[i + 1];
+
+		values[i] = mean + radius * std::cos(angle);
+		values[i + 1] = mean + radius * std::sin(angle);
+	}
+
+	if (quantity % 2)
+	{
+		double last[2];
+		generate(last, 2);
+		values[quantity - 1] = mean + sd * std::sqrt(-2.0 * std::log(last[0])) * std::cos(TWO_PI * last[1]);
+	}
+}
+
+void RandomStream::exponential(double* values, int quantity, double lambda)
+{
+	generate(values, quantity);
+
+	for (int i = 0; i < quantity; i++)
+		values[i] = -std::log(values[i]) / lambda;
+}
+
+int cpp_randomfill(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int quantity = (int) luaL_checkinteger(L, 2);
+	quint64 seed = (quint64) luaL_checkinteger(L, 3);
+	quint64 stream = (quint64) luaL_checkinteger(L, 4);
+	quint64 position = (quint64) luaL_checkinteger(L, 5);
+	QString distrib(luaL_checkstring(L, 6));
+	double first = luaL_optnumber(L, 7, 0);
+	double second = luaL_optnumber(L, 8, 1);
+
+	luaL_argcheck(L, quantity > 0, 2, "positive quantity expected");
+
+	QVector<double> values(quantity);
+	RandomStream random(seed, stream, position);
+
+	if (distrib == "uniform")
+		random.uniform(values.data(), quantity, first, second);
+	else if (distrib == "normal")
+		random.normal(values.data(), quantity, first, second);
+	else if (distrib == "exponential")
+		random.exponential(values.data(), quantity, first);
+	else
+		return luaL_argerror(L, 6, "invalid distribution");
+
+	for (int i = 0; i < quantity; i++)
+	{
+		lua_pushnumber(L, values.at(i));
+		lua_rawseti(L, 1, i + 1);
+	}
+
+	lua_pushinteger(L, (lua_Integer) random.position());
+	return 1;
+}
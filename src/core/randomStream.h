@@ -0,0 +1,98 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+/*! \file randomStream.h
+\brief This file contains definitions about the counter-based random number
+	streams used by Random objects with a stream. Each value is a function of
+	the seed, the stream, and its position, so independent streams never
+	overlap and can be drawn in any order.
+*/
+
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <QtCore/QtGlobal>
+
+extern "C"
+{
+	#include <lua.h>
+}
+
+/**
+* \brief
+*  Philox4x32-10 random number stream (Salmon et al., 2011).
+*  The key is the seed and the counter is the pair (position, stream).
+*  Each position generates one block of four 32-bit words, that is,
+*  two uniform numbers with 53 bits.
+*/
+class RandomStream
+{
+public:
+	/// Constructor
+	/// \param seed the seed shared by all the streams
+	/// \param stream the number of the stream
+	/// \param position the first block to be generated
+	RandomStream(quint64 seed, quint64 stream, quint64 position = 0);
+
+	/// Fills values with uniform numbers in the open interval (min, max).
+	/// \param values receives quantity numbers
+	/// \param quantity the number of values
+	/// \param min the lower bound
+	/// \param max the upper bound
+	void uniform(double* values, int quantity, double min, double max);
+
+	/// Fills values with normally distributed numbers, using the Box-Muller method.
+	/// \param values receives quantity numbers
+	/// \param quantity the number of values
+	/// \param mean the mean of the distribution
+	/// \param sd the standard deviation of the distribution
+	void normal(double* values, int quantity, double mean, double sd);
+
+	/// Fills values with exponentially distributed numbers, using the inverse transform method.
+	/// \param values receives quantity numbers
+	/// \param quantity the number of values
+	/// \param lambda the rate of the distribution
+	void exponential(double* values, int quantity, double lambda);
+
+	/// Returns the next block to be generated.
+	quint64 position() const { return position_; }
+
+private:
+	/// Generates the uniform numbers of the next blocks, two per block,
+	/// advancing the position.
+	/// \param values receives quantity numbers in (0, 1)
+	/// \param quantity the number of values
+	void generate(double* values, int quantity);
+
+	quint32 key_[2];
+	quint64 stream_;
+	quint64 position_;
+};
+
+/// Fills a Lua table with random numbers from a stream. Lua arguments: the table,
+/// the quantity of numbers, the seed, the stream, the position, the distribution
+/// ("uniform", "normal", or "exponential"), and its two parameters (min and max,
+/// mean and sd, or lambda). Returns the position after the generated numbers.
+int cpp_randomfill(lua_State *L);
+
+#endif
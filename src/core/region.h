@@ -49,10 +49,16 @@ template <class Indx>
 class Region_ : public CompositeInterface< multimapComposite<Indx, Cell*> >
 {
 public:
-    /// Add a cell to the Region
+    typedef typename CompositeInterface< multimapComposite<Indx, Cell*> >::iterator iterator;
+
+    /// Destructor
+    virtual ~Region_() {}
+
+    /// Add a cell to the Region. The methods that change the cells of the Region are virtual,
+    /// so that regions with other indexes of their cells keep them updated.
     /// \param indx is a generic index representing the n-dimensional cell coordinate
     /// \param cell is a pointer to the cell being inserted into the Region
-    void add(Indx indx, Cell* cell)
+    virtual void add(Indx indx, Cell* cell)
     {
         pair<Indx, Cell*>  indexCellPair;
 
@@ -62,6 +68,26 @@ public:
         CompositeInterface< multimapComposite<Indx, Cell*> >::add(indexCellPair);
     }
 
+    /// Removes the cell with the given index from the Region
+    /// \param indx is a generic index representing the n-dimensional cell coordinate
+    virtual bool erase(Indx indx)
+    {
+        return CompositeInterface< multimapComposite<Indx, Cell*> >::erase(indx);
+    }
+
+    /// Removes the cell pointed by an iterator from the Region
+    /// \param itr is an iterator of the Region
+    virtual iterator erase(iterator itr)
+    {
+        return CompositeInterface< multimapComposite<Indx, Cell*> >::erase(itr);
+    }
+
+    /// Removes all the cells of the Region
+    virtual void clear()
+    {
+        CompositeInterface< multimapComposite<Indx, Cell*> >::clear();
+    }
+
     /// Searches for a cell into the region
     /// \return a Cell pointer is the cell has been found, otherwise returns a NULL pointer
     Cell* operator [](Indx indx)
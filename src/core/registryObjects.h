@@ -158,6 +158,9 @@ Luna<luaCellularSpace>::RegType luaCellularSpace::methods[] = {
 	method(luaCellularSpace, clear),
 	method(luaCellularSpace, size),
 	method(luaCellularSpace, addCell),
+	method(luaCellularSpace, setGrid),
+	method(luaCellularSpace, createStencilNeighborhood),
+	method(luaCellularSpace, synchronizeColumns),
 	method(luaCellularSpace, setWhereClause),
 
 	method(luaCellularSpace, getReference),
@@ -272,6 +275,7 @@ Luna<luaChart>::RegType luaChart::methods[] = {
 	method(luaChart, setObserver),
 	method(luaChart, clear),
 	method(luaChart, restart),
+	method(luaChart, setBuffer),
 	{0, 0}
 };
 
@@ -282,6 +286,7 @@ Luna<luaMap>::RegType luaMap::methods[] = {
 	method(luaMap, setObserver),
 	method(luaMap, setGridVisible),
 	method(luaMap, setTitle),
+	method(luaMap, setProtocolFormat),
 	{0, 0}
 };
 
@@ -305,6 +310,7 @@ const char luaLogFile::className[] = "TeLogFile";
 
 Luna<luaLogFile>::RegType luaLogFile::methods[] = {
         method(luaLogFile, setObserver),
+        method(luaLogFile, flush),
         {0, 0}
 };
 
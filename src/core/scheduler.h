@@ -58,17 +58,198 @@ of this software and its documentation.
 #include "player.h"
 
 #include <float.h>
+#include <vector>
+#include <deque>
 
 extern bool SHOW_GUI;
+extern bool HEADLESS;
 extern bool paused;
 extern bool step;
 
 /**
 * \brief
-*  Event-Message Pair Composite Handle Type.
+*  Event-Message priority queue. It is a contiguous 4-ary heap of plain records ordered by time,
+*  priority, and insertion order, which gives the same order of a multimap of Events: Events with
+*  the same time and priority are served in the order they were added. The Event handles are kept
+*  in slots reused by the next Events, so rescheduling a periodic Event does not allocate memory.
+*  The position of each slot in the heap is kept up to date, so a record is found in constant time.
 *
 */
-typedef CompositeInterface<multimapComposite<Event, Message*> > EventMessagePairCompositeInterf;
+class EventMessageQueue
+{
+public:
+    /// Record of the heap
+    struct Entry
+    {
+        double time; ///< time instant the Event must occur
+        double priority; ///< Event priority. Higher numbers means lower priority
+        unsigned long long seq; ///< insertion order, unique for each Entry
+        Message* message; ///< Message linked to the Event
+        int slot; ///< position of the Event handle in the slots
+    };
+
+    /// Default constructor
+    EventMessageQueue(void) : seq_(0) {}
+
+    /// Return true if the queue is empty.
+    bool empty(void) const { return heap_.empty(); }
+
+    /// Returns the number of Events in the queue.
+    int size(void) const { return (int) heap_.size(); }
+
+    /// Adds a new pair Event-Message to the queue.
+    /// \param event is a reference to the Event being added
+    /// \param message is a pointer to message being linked to the Event
+    void add(Event& event, Message* message)
+    {
+        Entry entry;
+        entry.time = event.getTime();
+        entry.priority = event.getPriority();
+        entry.seq = seq_++;
+        entry.message = message;
+
+        if (free_.empty())
+        {
+            entry.slot = (int) events_.size();
+            events_.push_back(event);
+            positions_.push_back(-1);
+        }
+        else
+        {
+            entry.slot = free_.back();
+            free_.pop_back();
+            events_[entry.slot] = event;
+        }
+
+        heap_.push_back(entry);
+        siftUp((int) heap_.size() - 1);
+    }
+
+    /// Gets the record on the head of the queue. The queue must not be empty.
+    const Entry& top(void) const { return heap_[0]; }
+
+    /// Gets the Event of a record of the queue.
+    Event& getEvent(const Entry& entry) { return events_[entry.slot]; }
+
+    /// Sets the time of an Event of the queue and moves it to its new position, as if it was
+    /// removed and added again. Nothing is done if the record is no longer in the queue.
+    /// \param record is a copy of the record, as returned by top()
+    /// \param time is the new time of the Event
+    void reschedule(const Entry& record, double time)
+    {
+        int position = find(record);
+        if (position < 0) return;
+
+        Entry& entry = heap_[position];
+        Event& event = events_[entry.slot];
+
+        event.setTime(time);
+        entry.time = time;
+        entry.priority = event.getPriority();
+        entry.seq = seq_++;
+
+        siftDown(siftUp(position));
+    }
+
+    /// Removes an Event from the queue. Its slot will be used by the next Event added.
+    /// \param record is a copy of the record, as returned by top()
+    void remove(const Entry& record)
+    {
+        int position = find(record);
+        if (position < 0) return;
+
+        free_.push_back(record.slot);
+        positions_[record.slot] = -1;
+
+        int last = (int) heap_.size() - 1;
+        if (position != last)
+        {
+            heap_[position] = heap_[last];
+            heap_.pop_back();
+            siftDown(siftUp(position));
+        }
+        else
+            heap_.pop_back();
+    }
+
+private:
+    static const int ARITY = 4;
+
+    vector<Entry> heap_; ///< 4-ary heap of records
+    deque<Event> events_; ///< Event handles, deque keeps the references valid when it grows
+    vector<int> free_; ///< slots of the Events already removed
+    vector<int> positions_; ///< position in the heap of the record of each slot, -1 if it is free
+    unsigned long long seq_; ///< insertion order of the next record
+
+    /// Returns true if a must be served before b.
+    static bool before(const Entry& a, const Entry& b)
+    {
+        if (a.time != b.time) return a.time < b.time;
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.seq < b.seq;
+    }
+
+    /// Returns the position of a record in the heap, or -1 if it is not in the heap. The
+    /// insertion order tells a record apart from a later one that reused its slot.
+    int find(const Entry& record) const
+    {
+        if (record.slot < 0 || record.slot >= (int) positions_.size()) return -1;
+
+        int position = positions_[record.slot];
+        if (position < 0 || heap_[position].seq != record.seq) return -1;
+
+        return position;
+    }
+
+    /// Stores a record at a position of the heap.
+    void place(int position, const Entry& entry)
+    {
+        heap_[position] = entry;
+        positions_[entry.slot] = position;
+    }
+
+    /// Moves a record up to its position. Returns the new position.
+    int siftUp(int position)
+    {
+        Entry entry = heap_[position];
+        while (position > 0)
+        {
+            int parent = (position - 1) / ARITY;
+            if (!before(entry, heap_[parent])) break;
+
+            place(position, heap_[parent]);
+            position = parent;
+        }
+        place(position, entry);
+        return position;
+    }
+
+    /// Moves a record down to its position. Returns the new position.
+    int siftDown(int position)
+    {
+        int size = (int) heap_.size();
+        Entry entry = heap_[position];
+        while (true)
+        {
+            int first = position * ARITY + 1;
+            if (first >= size) break;
+
+            int child = first;
+            int last = first + ARITY < size ? first + ARITY : size;
+            for (int i = first + 1; i < last; i++)
+            {
+                if (before(heap_[i], heap_[child])) child = i;
+            }
+
+            if (!before(heap_[child], entry)) break;
+
+            place(position, heap_[child]);
+            position = child;
+        }
+        place(position, entry);
+        return position;
+    }
+};
 
 /**
 * \brief
@@ -111,14 +292,8 @@ public:
     /// \return A copy to the Event object on Event-Message head
     Event getEvent(void)
 	{
-        EventMessagePairCompositeInterf::iterator iterator = eventMessageQueue.begin();
-        pair<Event, Message*> eventMessagePair;
-
-        if (iterator != eventMessageQueue.end())
-        {
-            eventMessagePair.first = iterator->first;
-            return eventMessagePair.first;
-        }
+        if (!eventMessageQueue.empty())
+            return eventMessageQueue.getEvent(eventMessageQueue.top());
 
         return time_;
     }
@@ -132,10 +307,7 @@ public:
     /// \param message is a pointer to message being linked to the Event
     void add(Event& event, Message* message)
 	{
-        pair<Event, Message*> eventMessagePair;
-        eventMessagePair.first = event;
-        eventMessagePair.second = message;
-        eventMessageQueue.add(eventMessagePair);
+        eventMessageQueue.add(event, message);
     }
 
     /// Executes the Scheduler object. Only one simulation time step is executed.
@@ -143,34 +315,12 @@ public:
     /// \return A reference to Event object which has triggered the Message object
     Event& execute()
 	{
-        pair<Event, Message*> eventMessagePair;
-        EventMessagePairCompositeInterf::iterator iterator;
-
-        iterator = eventMessageQueue.begin();
-        if (iterator != eventMessageQueue.end())
-        {
-            Event& event = eventMessagePair.first = iterator->first;
-            Message *message = eventMessagePair.second = iterator->second;
-
-            time_ = event.getTime();
-
-            Message msg = *message; // it's Important to keep the message implementation alive
-            eventMessageQueue.erase(iterator);
-
-            if (message->execute(event))
-			{
-                eventMessagePair.first.setTime(double(time_.getTime() + event.getPeriod()));
-                eventMessageQueue.add(eventMessagePair);
-            }
-
-            iterator = eventMessageQueue.begin();
-        }
+        if (!eventMessageQueue.empty())
+            dispatch();
 
         if (!eventMessageQueue.empty())
-        {
-            Event& event =(Event&)iterator->first;
-            return event;
-        }
+            return eventMessageQueue.getEvent(eventMessageQueue.top());
+
         return time_;
     }
 
@@ -180,38 +330,20 @@ public:
     /// \return A real number meaning the Scheduler internal clock
     double execute(double& finalTime)
 	{
-        Event event;
-        Message *message;
-        pair<Event, Message*> eventMessagePair;
-        EventMessagePairCompositeInterf::iterator iterator;
-
-        iterator = eventMessageQueue.begin();
-        while (iterator != eventMessageQueue.end() && time_.getTime() <= finalTime)
+        while (!eventMessageQueue.empty() && time_.getTime() <= finalTime)
         {
-            while (paused) qApp->processEvents();
-
-            event = eventMessagePair.first = iterator->first;
-            message = eventMessagePair.second = iterator->second;
+            if (!HEADLESS)
+                while (paused) qApp->processEvents();
 
-            if (event.getTime() > finalTime)
+            if (eventMessageQueue.getEvent(eventMessageQueue.top()).getTime() > finalTime)
 			{
-				time_ = finalTime;
+				time_.setTime(finalTime);
 				break;
 			}
 
-            time_ = event.getTime();
-            Message msg = *message; // it's Important to keep the message implementation alive
-            eventMessageQueue.erase(iterator);
-
-            if (message->execute(event))
-			{
-                eventMessagePair.first.setTime(double(time_.getTime() + event.getPeriod()));
-                eventMessageQueue.add(eventMessagePair);
-            }
-
-            iterator = eventMessageQueue.begin();
+            dispatch();
 
-            if (step) paused = true;
+            if (step && !HEADLESS) paused = true;
         }
 		return finalTime;
     }
@@ -227,7 +359,24 @@ public:
     bool empty(void) { return eventMessageQueue.empty(); }
 
 public:
-    EventMessagePairCompositeInterf eventMessageQueue; ///< Event-Message Pair queue
+    EventMessageQueue eventMessageQueue; ///< Event-Message Pair queue
+
+private:
+    /// Executes the Message on the head of the queue. The Event is rescheduled in place
+    /// according to its period if the Message returns true, otherwise it is removed.
+    void dispatch(void)
+    {
+        EventMessageQueue::Entry head = eventMessageQueue.top();
+        Event event = eventMessageQueue.getEvent(head);
+        Message msg = *head.message; // it's Important to keep the message implementation alive
+
+        time_.setTime(event.getTime());
+
+        if (head.message->execute(event))
+            eventMessageQueue.reschedule(head, time_.getTime() + event.getPeriod());
+        else
+            eventMessageQueue.remove(head);
+    }
 };
 
 /**
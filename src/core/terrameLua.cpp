@@ -28,6 +28,7 @@ of this software and its documentation.
 #include <QMessageBox>
 #include <QProcess>
 #include <QLoggingCategory>
+#include <QElapsedTimer>
 
 #include "Downloader.h"
 #include "blackBoard.h"
@@ -59,8 +60,16 @@ extern "C"
 #include "LuaBindingDelegate.h"
 
 #include "hpa/hpa.h"
+#include "hpa/blockTask.h"
+#include "columnarFile.h"
+#include "randomStream.h"
+#include "dataFrameColumn.h"
+#include "csvFile.h"
+#include "neighborhoodFile.h"
+#include "frameWriter.h"
 
 QApplication* app;
+QElapsedTimer startupTimer;
 
 //////////////////////////////////////////////////////////////////////////////
 //// Runs through the widget list closing each
@@ -232,6 +241,14 @@ int cpp_imagecompare(lua_State *L)
 	return 1;
 }
 
+int cpp_flushimage(lua_State *L)
+{
+	const char* s = lua_tostring(L, -1);
+
+	TerraMEObserver::FrameWriter::flush(QString::fromLocal8Bit(s));
+	return 0;
+}
+
 int cpp_listpackages(lua_State* L)
 {
     const char* s1 = lua_tostring(L, -1);
@@ -295,6 +312,13 @@ int cpp_restartobservercounter(lua_State *L)
 	return 0;
 }
 
+// Wall-clock seconds since TerraME started, with sub-millisecond resolution
+int cpp_elapsedtime(lua_State *L)
+{
+	lua_pushnumber(L, startupTimer.nsecsElapsed() / 1.0e9);
+	return 1;
+}
+
 int cpp_putenv(lua_State* L)
 {
 	std::string path = lua_tostring(L, -1);
@@ -360,6 +384,8 @@ int main(int argc, char *argv[])
 	// compatible with the version of the headers we compiled against.
 	GOOGLE_PROTOBUF_VERIFY_VERSION;
 
+	startupTimer.start();
+
 	QLocale::setDefault(QLocale::English);
 
 	Q_INIT_RESOURCE(observerResource);
@@ -377,6 +403,18 @@ int main(int argc, char *argv[])
 	_putenv_s("PATH", p.c_str());
 #endif
 
+	HEADLESS = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-headless"))
+			HEADLESS = true;
+	}
+
+	// Without a display, the application must be created on the offscreen platform
+	if (HEADLESS)
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
 	app = new QApplication(argc, argv); // #79
 	//app.setQuitOnLastWindowClosed(true);
 
@@ -387,7 +425,7 @@ int main(int argc, char *argv[])
 	step = false;
 
 	// Register the message handle of Observer Player
-	if ((argc > 2) && (!strcmp(argv[1], "-gui")))
+	if (!HEADLESS && (argc > 2) && (!strcmp(argv[1], "-gui")))
 	{
 		SHOW_GUI = true;
 
@@ -445,6 +483,9 @@ int main(int argc, char *argv[])
 	lua_pushcfunction(L, cpp_imagecompare);
 	lua_setglobal(L, "cpp_imagecompare");
 
+	lua_pushcfunction(L, cpp_flushimage);
+	lua_setglobal(L, "cpp_flushimage");
+
 	lua_pushcfunction(L, cpp_imagesize);
 	lua_setglobal(L, "cpp_imagesize");
 
@@ -475,6 +516,33 @@ int main(int argc, char *argv[])
 	lua_pushcfunction(L, cpp_hpa_run);
 	lua_setglobal(L, "cpp_hpa_run");
 
+	lua_pushcfunction(L, hpaForEachCell);
+	lua_setglobal(L, "cpp_forEachCell");
+
+	lua_pushcfunction(L, cpp_columnarsave);
+	lua_setglobal(L, "cpp_columnarsave");
+
+	lua_pushcfunction(L, cpp_columnarload);
+	lua_setglobal(L, "cpp_columnarload");
+
+	lua_pushcfunction(L, cpp_randomfill);
+	lua_setglobal(L, "cpp_randomfill");
+
+	lua_pushcfunction(L, cpp_dataframecolumn);
+	lua_setglobal(L, "cpp_dataframecolumn");
+
+	lua_pushcfunction(L, cpp_csvread);
+	lua_setglobal(L, "cpp_csvread");
+
+	lua_pushcfunction(L, cpp_csvformat);
+	lua_setglobal(L, "cpp_csvformat");
+
+	lua_pushcfunction(L, cpp_neighborhoodload);
+	lua_setglobal(L, "cpp_neighborhoodload");
+
+	lua_pushcfunction(L, cpp_elapsedtime);
+	lua_setglobal(L, "cpp_elapsedtime");
+
 	// Execute the lua files
 	if (argc < 2)
 	{
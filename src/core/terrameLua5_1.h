@@ -82,6 +82,12 @@ ExecutionModes execModes;
 /// Shows the TerraME Player
 bool SHOW_GUI;
 
+/// Runs the simulation without the Qt event loop (option -headless)
+/// false - (default) the scheduler and the observers process the pending Qt events;
+/// true - the Player is not available and qApp->processEvents() is never called
+/// while the simulation executes
+bool HEADLESS;
+
 int WORKERS_NUMBER;
 
 /// Pause the simulation execution
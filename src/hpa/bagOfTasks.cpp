@@ -0,0 +1,194 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "bagOfTasks.h"
+
+#include <QThread>
+
+BagOfTasks::BagOfTasks()
+	: queued(0), active(0), pending(0), next(0)
+{
+}
+
+BagOfTasks::~BagOfTasks()
+{
+	for (int i = 0; i < queues.size(); i++)
+		delete queues[i];
+}
+
+void BagOfTasks::setWorkers(int workers)
+{
+	QMutexLocker locker(&lock);
+	QWriteLocker queuesLocker(&queuesLock);
+
+	while (queues.size() < workers)
+		queues.push_back(new Queue());
+
+	//as tarefas dos workers que vao terminar passam para os que continuam
+	if (workers > 0)
+	{
+		for (int i = workers; i < queues.size(); i++)
+		{
+			QMutexLocker from(&queues[i]->lock);
+			while (!queues[i]->tasks.empty())
+			{
+				Queue *to = queues[i % workers];
+				QMutexLocker toLocker(&to->lock);
+				to->tasks.push_back(queues[i]->tasks.front());
+				queues[i]->tasks.pop_front();
+			}
+		}
+	}
+
+	active.store(workers);
+	next = 0;
+	available.wakeAll();
+}
+
+void BagOfTasks::insert(ParamTask& task)
+{
+	QMutexLocker locker(&lock);
+
+	if (queues.empty())
+	{
+		QWriteLocker queuesLocker(&queuesLock);
+		queues.push_back(new Queue());
+	}
+
+	int workers = max(active.load(), 1);
+	Queue *queue = queues[next % workers];
+	next = (next + 1) % workers;
+
+	queue->lock.lock();
+	queue->tasks.push_back(task);
+	queue->lock.unlock();
+
+	//a tarefa so' e' contada depois de estar na fila, para que toda reserva encontre uma tarefa
+	queued.ref();
+	pending++;
+	pendingByName[QString::fromStdString(task.getNameTask())]++;
+	available.wakeOne();
+}
+
+bool BagOfTasks::reserve()
+{
+	int current = queued.load();
+	while (current > 0)
+	{
+		if (queued.testAndSetOrdered(current, current - 1))
+			return true;
+		current = queued.load();
+	}
+	return false;
+}
+
+bool BagOfTasks::pop(int worker, ParamTask& task)
+{
+	QReadLocker queuesLocker(&queuesLock);
+	int size = queues.size();
+
+	//primeiro a propria fila, do inicio, para manter a ordem de insercao
+	Queue *own = queues[worker % size];
+	own->lock.lock();
+	if (!own->tasks.empty())
+	{
+		task = own->tasks.front();
+		own->tasks.pop_front();
+		own->lock.unlock();
+		return true;
+	}
+	own->lock.unlock();
+
+	//depois rouba do fim das filas dos outros workers
+	for (int i = 1; i < size; i++)
+	{
+		Queue *victim = queues[(worker + i) % size];
+		victim->lock.lock();
+		if (!victim->tasks.empty())
+		{
+			task = victim->tasks.back();
+			victim->tasks.pop_back();
+			victim->lock.unlock();
+			return true;
+		}
+		victim->lock.unlock();
+	}
+
+	return false;
+}
+
+bool BagOfTasks::take(int worker, ParamTask& task)
+{
+	while (worker < active.load())
+	{
+		if (reserve())
+		{
+			//a tarefa reservada ja' esta' em alguma fila, mas pode estar sendo
+			//movida por setWorkers; procura ate' encontra-la
+			while (!pop(worker, task))
+				QThread::yieldCurrentThread();
+			return true;
+		}
+
+		//todas as filas vazias: dorme ate' insert ou setWorkers acordar o worker
+		QMutexLocker locker(&lock);
+		while (queued.load() == 0 && worker < active.load())
+			available.wait(&lock);
+	}
+
+	return false;
+}
+
+void BagOfTasks::done(ParamTask& task)
+{
+	QMutexLocker locker(&lock);
+
+	pending--;
+	QString name = QString::fromStdString(task.getNameTask());
+	if (--pendingByName[name] <= 0)
+		pendingByName.remove(name);
+
+	finished.wakeAll();
+}
+
+void BagOfTasks::waitAll()
+{
+	QMutexLocker locker(&lock);
+
+	while (pending > 0 && active.load() > 0)
+		finished.wait(&lock);
+}
+
+void BagOfTasks::wait(const string& nameTask)
+{
+	QMutexLocker locker(&lock);
+	QString name = QString::fromStdString(nameTask);
+
+	while (pendingByName.value(name, 0) > 0 && active.load() > 0)
+		finished.wait(&lock);
+}
+
+int BagOfTasks::size()
+{
+	return queued.load();
+}
@@ -28,60 +28,83 @@ extern "C" {
 	#include <lua.h>
 }
 
+#include <algorithm>
 #include <string>
+#include <deque>
+#include <vector>
+#include <QAtomicInt>
+#include <QHash>
 #include <QMutexLocker>
-#include <list>
+#include <QReadWriteLock>
+#include <QWaitCondition>
 #include "paramsTask.h"
 
 using namespace std;
 
-static list<ParamTask> BAG;
-
-static QMutex LOCK_BAG;
-
-static int bagOfTask(list<ParamTask> *bag_, ParamTask *firtTask) {
-	LOCK_BAG.lock();
-	//neste caso sai um resultado para ser tratado no run (preciso refatorar aqui)
-	if(bag_->empty())
-	{
-		LOCK_BAG.unlock();
-		return 0;
-	}
-	else
-	{
-		firtTask = &bag_->front();
-		bag_->pop_front();
-	}
-	LOCK_BAG.unlock();
-	return 1;
-}
+// Tiago - comentario
+// A classe BagOfTasks guarda as tarefas das diretivas parallel em uma fila (deque) por worker.
+// Cada worker consome a sua fila e, quando ela esta' vazia, rouba tarefas do fim da fila dos outros,
+// de modo que nenhum worker fica parado enquanto houver tarefas na bag.
+// Retirar e roubar tarefas usa apenas os locks das filas e o contador atomico queued;
+// o lock global so' e' usado para dormir quando todas as filas estao vazias e para os contadores de espera.
+class BagOfTasks {
+private:
+	struct Queue {
+		QMutex lock;
+		deque<ParamTask> tasks;
+	};
 
-//para obter quantidade de tasks agurdando execucao
-static int bagSize(list<ParamTask> *bag_){
-	int nTasks;
-	LOCK_BAG.lock();
-		nTasks = bag_->size();
-	LOCK_BAG.unlock();
-	return nTasks;
-}
+	//o vetor so' cresce; e' lido pelos workers e alterado apenas com o lock de escrita
+	vector<Queue*> queues;
+	QReadWriteLock queuesLock;
 
-static void bagInsertion(list<ParamTask> *bag_, string toExec, string nameFunc, vector<string> params, vector<string> returns, lua_State* storeVals){
-	LOCK_BAG.lock();
+	//protege os contadores abaixo e as condicoes de espera
+	QMutex lock;
+	QWaitCondition available;
+	QWaitCondition finished;
 
-	ParamTask toIncludeBagP;
-	toIncludeBagP.setCallTask(toExec);
-	toIncludeBagP.setNameTask(nameFunc);
-	toIncludeBagP.setSetParam(params);
-	toIncludeBagP.setSetRet(returns);
+	QAtomicInt queued; //tarefas nas filas ainda nao reservadas por um worker
+	QAtomicInt active; //quantidade de workers que podem consumir tarefas
+	int pending;       //tarefas nas filas ou em execucao
+	int next;          //proxima fila a receber uma tarefa (round robin)
+	QHash<QString, int> pendingByName;
 
-	if(params.size() == 0)
-		lua_close(storeVals);
-	else
-		toIncludeBagP.set_State(storeVals);
+	//reserva uma das tarefas contadas em queued, sem bloquear
+	bool reserve();
 
-	bag_->push_back(toIncludeBagP);
+	//retira uma tarefa da propria fila ou de outra; so' e' chamado depois de reserve()
+	bool pop(int worker, ParamTask& task);
 
-	LOCK_BAG.unlock();
-}
+public:
+	BagOfTasks();
+	~BagOfTasks();
+
+	//define quantos workers consomem a bag; workers com indice maior ou igual a isso terminam
+	void setWorkers(int workers);
+
+	//insere uma tarefa na fila de um worker e acorda um worker ocioso
+	void insert(ParamTask& task);
+
+	//retira uma tarefa para o worker, da sua fila ou roubando de outra;
+	//bloqueia enquanto a bag estiver vazia e retorna false quando o worker deve terminar
+	bool take(int worker, ParamTask& task);
+
+	//avisa que a tarefa retirada com take terminou de executar
+	void done(ParamTask& task);
+
+	//espera todas as tarefas terminarem
+	void waitAll();
+
+	//espera apenas as tarefas da funcao nameTask terminarem
+	void wait(const string& nameTask);
+
+	//quantidade de tasks aguardando execucao
+	int size();
+};
+
+static BagOfTasks BAG;
+
+//protege as pilhas lua compartilhadas entre o processo principal e os workers
+static QMutex LOCK_LUA;
 
 #endif
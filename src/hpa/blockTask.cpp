@@ -0,0 +1,874 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "blockTask.h"
+
+extern "C" {
+	#include <lauxlib.h>
+	#include <lualib.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+//atributos de controle das celulas que os workers nao podem alterar
+static bool isReadOnly(const string& name)
+{
+	return name == "x" || name == "y" || name == "id";
+}
+
+bool CellValue::operator==(const CellValue& other) const
+{
+	if (type != other.type)
+		return false;
+
+	switch (type)
+	{
+		case LUA_TBOOLEAN:
+			return intValue == other.intValue;
+		case LUA_TNUMBER:
+			if (integer && other.integer)
+				return intValue == other.intValue;
+			return integer == other.integer && number == other.number;
+		default:
+			return text == other.text;
+	}
+}
+
+//le o valor escalar no topo da pilha, retorna false se ele nao for escalar
+static bool readValue(lua_State *L, CellValue& value)
+{
+	value.type = lua_type(L, -1);
+	value.integer = false;
+	value.intValue = 0;
+	value.number = 0;
+
+	switch (value.type)
+	{
+		case LUA_TBOOLEAN:
+			value.intValue = lua_toboolean(L, -1);
+			return true;
+		case LUA_TNUMBER:
+			value.integer = lua_isinteger(L, -1) != 0;
+			if (value.integer)
+				value.intValue = lua_tointeger(L, -1);
+			else
+				value.number = lua_tonumber(L, -1);
+			return true;
+		case LUA_TSTRING:
+			value.text.assign(lua_tostring(L, -1), lua_rawlen(L, -1));
+			return true;
+		default:
+			return false;
+	}
+}
+
+static void pushValue(lua_State *L, const CellValue& value)
+{
+	switch (value.type)
+	{
+		case LUA_TNIL:
+			lua_pushnil(L);
+			break;
+		case LUA_TBOOLEAN:
+			lua_pushboolean(L, (int) value.intValue);
+			break;
+		case LUA_TNUMBER:
+			if (value.integer)
+				lua_pushinteger(L, value.intValue);
+			else
+				lua_pushnumber(L, value.number);
+			break;
+		default:
+			lua_pushlstring(L, value.text.data(), value.text.size());
+	}
+}
+
+//true se o atributo name deve ser copiado para os workers
+static bool isRead(const CellBlocks& blocks, const char *name)
+{
+	return blocks.allAttributes || isReadOnly(name) || blocks.attributes.count(name) > 0;
+}
+
+//le os atributos escalares da tabela em idx que a funcao pode ler
+static void readValues(lua_State *L, int idx, const CellBlocks& blocks, CellValues& values)
+{
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0)
+	{
+		CellValue value;
+		if (lua_type(L, -2) == LUA_TSTRING && isRead(blocks, lua_tostring(L, -2)) && readValue(L, value))
+			values.push_back(make_pair(string(lua_tostring(L, -2)), value));
+
+		lua_pop(L, 1);
+	}
+}
+
+//le os valores da posicao position das colunas da tabela em idx que a funcao pode ler
+static void readColumns(lua_State *L, int idx, int position, const CellBlocks& blocks, CellValues& values)
+{
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0)
+	{
+		CellValue value;
+		if (lua_type(L, -2) == LUA_TSTRING && lua_type(L, -1) == LUA_TTABLE && isRead(blocks, lua_tostring(L, -2)))
+		{
+			lua_rawgeti(L, -1, position);
+			if (readValue(L, value))
+				values.push_back(make_pair(string(lua_tostring(L, -3)), value));
+			lua_pop(L, 1);
+		}
+
+		lua_pop(L, 1);
+	}
+}
+
+//cria na pilha uma tabela com os valores
+static void pushValues(lua_State *L, const CellValues& values)
+{
+	lua_createtable(L, 0, values.size() + 1);
+	for (int i = 0; i < values.size(); i++)
+	{
+		pushValue(L, values[i].second);
+		lua_setfield(L, -2, values[i].first.c_str());
+	}
+}
+
+static int dumpWriter(lua_State *L, const void *b, size_t size, void *B)
+{
+	((string*) B)->append((const char*) b, size);
+	return 0;
+}
+
+// A classe DumpReader percorre o bytecode gerado por lua_dump (formato do Lua 5.3) e junta as
+// constantes string da funcao e das funcoes internas, que sao os unicos nomes de atributos que
+// a funcao consegue ler com cell.name ou cell:name(). Acessos com chaves calculadas (GETTABLE
+// ou SELF com a chave em um registrador) fazem com que todos os atributos sejam copiados.
+class DumpReader {
+private:
+	const string& dump;
+	size_t pos;
+	int intSize, sizetSize, instructionSize, integerSize, numberSize;
+
+	bool skip(size_t n)
+	{
+		if (n > dump.size() - pos)
+			return false;
+
+		pos += n;
+		return true;
+	}
+
+	bool readByte(int& value)
+	{
+		if (pos >= dump.size())
+			return false;
+
+		value = (unsigned char) dump[pos++];
+		return true;
+	}
+
+	bool readInt(int& value)
+	{
+		if (intSize != sizeof(int) || pos + sizeof(int) > dump.size())
+			return false;
+
+		memcpy(&value, dump.data() + pos, sizeof(int));
+		pos += sizeof(int);
+		return value >= 0;
+	}
+
+	bool readString(string* value)
+	{
+		int small;
+		if (!readByte(small))
+			return false;
+
+		size_t size = small;
+		if (small == 0xFF)
+		{
+			if (sizetSize != sizeof(size_t) || pos + sizeof(size_t) > dump.size())
+				return false;
+
+			memcpy(&size, dump.data() + pos, sizeof(size_t));
+			pos += sizeof(size_t);
+		}
+
+		if (size == 0)
+			return true;
+
+		if (size - 1 > dump.size() - pos)
+			return false;
+
+		if (value)
+			value->assign(dump.data() + pos, size - 1);
+
+		pos += size - 1;
+		return true;
+	}
+
+	bool readFunction(set<string>& names, bool& dynamic)
+	{
+		int n;
+
+		//source, linedefined, lastlinedefined, numparams, is_vararg, maxstacksize
+		if (!readString(NULL) || !skip(2 * intSize + 3) || !readInt(n))
+			return false;
+
+		if (instructionSize != 4 || (size_t) n > (dump.size() - pos) / 4)
+			return false;
+
+		for (int i = 0; i < n; i++)
+		{
+			quint32 instruction;
+			memcpy(&instruction, dump.data() + pos + 4 * i, 4);
+
+			int op = instruction & 0x3F;
+			int c = (instruction >> 14) & 0x1FF;
+
+			//OP_GETTABLE e OP_SELF com a chave RK(C) em um registrador
+			if ((op == 7 || op == 12) && !(c & 0x100))
+				dynamic = true;
+		}
+		pos += 4 * n;
+
+		if (!readInt(n))
+			return false;
+
+		for (int i = 0; i < n; i++)
+		{
+			int type;
+			if (!readByte(type))
+				return false;
+
+			switch (type)
+			{
+				case 0: //nil
+					break;
+				case 1: //boolean
+					if (!skip(1)) return false;
+					break;
+				case 3: //float
+					if (!skip(numberSize)) return false;
+					break;
+				case 19: //integer
+					if (!skip(integerSize)) return false;
+					break;
+				case 4: //string curta
+				case 20: //string longa
+				{
+					string name;
+					if (!readString(&name)) return false;
+					names.insert(name);
+					break;
+				}
+				default:
+					return false;
+			}
+		}
+
+		//upvalues
+		if (!readInt(n) || !skip(2 * (size_t) n))
+			return false;
+
+		//funcoes internas
+		if (!readInt(n))
+			return false;
+
+		for (int i = 0; i < n; i++)
+			if (!readFunction(names, dynamic))
+				return false;
+
+		//lineinfo
+		if (!readInt(n) || !skip((size_t) n * intSize))
+			return false;
+
+		//locvars
+		if (!readInt(n))
+			return false;
+
+		for (int i = 0; i < n; i++)
+			if (!readString(NULL) || !skip(2 * intSize))
+				return false;
+
+		//nomes dos upvalues
+		if (!readInt(n))
+			return false;
+
+		for (int i = 0; i < n; i++)
+			if (!readString(NULL))
+				return false;
+
+		return true;
+	}
+
+public:
+	DumpReader(const string& dump_) : dump(dump_), pos(0),
+		intSize(0), sizetSize(0), instructionSize(0), integerSize(0), numberSize(0) {}
+
+	//retorna false se o bytecode nao puder ser lido ou se a funcao acessar tabelas com chaves calculadas
+	bool read(set<string>& names)
+	{
+		//assinatura, versao, formato e LUAC_DATA
+		if (dump.compare(0, 4, LUA_SIGNATURE) != 0 || dump.size() < 18 || dump[4] != 0x53)
+			return false;
+
+		pos = 12;
+		readByte(intSize);
+		readByte(sizetSize);
+		readByte(instructionSize);
+		readByte(integerSize);
+		readByte(numberSize);
+
+		//LUAC_INT, LUAC_NUM e a quantidade de upvalues da funcao principal
+		bool dynamic = false;
+		if (!skip(integerSize + numberSize + 1) || !readFunction(names, dynamic))
+			return false;
+
+		//funcoes que percorrem ou consultam a celula sem usar o nome do atributo
+		return !dynamic && !names.count("pairs") && !names.count("next") && !names.count("rawget");
+	}
+};
+
+//copia um array lua de numeros da tabela no topo da pilha, subtraindo shift de cada valor
+template <class T>
+static void readArray(lua_State *L, const char *field, vector<T>& values, T shift)
+{
+	lua_getfield(L, -1, field);
+	int size = lua_rawlen(L, -1);
+
+	values.resize(size);
+	for (int i = 0; i < size; i++)
+	{
+		lua_rawgeti(L, -1, i + 1);
+		values[i] = (T) lua_tonumber(L, -1) - shift;
+		lua_pop(L, 1);
+	}
+
+	lua_pop(L, 1);
+}
+
+CellBlocks::CellBlocks()
+	: allAttributes(true), blockSize(1), nextBlock(0), failed(0)
+{
+}
+
+//pool de workers do forEachCell paralelo; e' alocado uma vez e nunca destruido, pois os
+//workers podem estar esperando nele quando o programa termina
+struct BlockPool {
+	QMutex lock;
+	QWaitCondition start;
+	QWaitCondition finished;
+	vector<BlockTask*> workers;
+	int running;
+
+	//apenas um forEachCell paralelo usa o pool de cada vez
+	QMutex execution;
+
+	BlockPool() : running(0) {}
+};
+
+static BlockPool* getPool()
+{
+	static BlockPool *pool = NULL;
+	if (!pool)
+	{
+		pool = new BlockPool();
+		qAddPostRoutine(BlockTask::stopWorkers);
+	}
+
+	return pool;
+}
+
+CellBlocks::~CellBlocks()
+{
+	qDeleteAll(neighborhoods);
+}
+
+BlockTask::BlockTask()
+{
+	blocks = NULL;
+	pending = false;
+	stopping = false;
+	result = true;
+
+	state = luaL_newstate();
+	luaL_openlibs(state);
+
+	lua_pushlightuserdata(state, this);
+	lua_pushcclosure(state, BlockTask::forEachNeighbor, 1);
+	lua_setglobal(state, "forEachNeighbor");
+
+	refFunction = LUA_NOREF;
+	refPositions = LUA_NOREF;
+	refNeighbors = LUA_NOREF;
+}
+
+BlockTask::~BlockTask()
+{
+	if (state)
+		lua_close(state);
+}
+
+vector<BlockTask*> BlockTask::execute(CellBlocks *blocks, int workers)
+{
+	BlockPool *pool = getPool();
+	QMutexLocker execution(&pool->execution);
+	QMutexLocker locker(&pool->lock);
+
+	while (pool->workers.size() < workers)
+	{
+		pool->workers.push_back(new BlockTask());
+		pool->workers.back()->start();
+	}
+
+	vector<BlockTask*> used(pool->workers.begin(), pool->workers.begin() + workers);
+	for (int i = 0; i < workers; i++)
+	{
+		used[i]->blocks = blocks;
+		used[i]->pending = true;
+	}
+
+	pool->running = workers;
+	pool->start.wakeAll();
+
+	while (pool->running > 0)
+		pool->finished.wait(&pool->lock);
+
+	return used;
+}
+
+void BlockTask::stopWorkers()
+{
+	BlockPool *pool = getPool();
+	QMutexLocker execution(&pool->execution);
+
+	pool->lock.lock();
+	for (int i = 0; i < pool->workers.size(); i++)
+		pool->workers[i]->stopping = true;
+	pool->start.wakeAll();
+	pool->lock.unlock();
+
+	for (int i = 0; i < pool->workers.size(); i++)
+	{
+		pool->workers[i]->wait();
+		delete pool->workers[i];
+	}
+
+	pool->workers.clear();
+}
+
+bool BlockTask::getResult()
+{
+	return result;
+}
+
+string BlockTask::getError()
+{
+	return error;
+}
+
+vector<pair<int, CellValues> >& BlockTask::getWrites()
+{
+	return writes;
+}
+
+void BlockTask::pushCell(int position)
+{
+	pushValues(state, blocks->current[position]);
+	pushValues(state, blocks->past[position]);
+	lua_setfield(state, -2, "past");
+
+	//posicao da celula para o forEachNeighbor
+	lua_rawgeti(state, LUA_REGISTRYINDEX, refPositions);
+	lua_pushvalue(state, -2);
+	lua_pushinteger(state, position);
+	lua_rawset(state, -3);
+	lua_pop(state, 1);
+}
+
+void BlockTask::pushNeighbor(int position)
+{
+	//as vizinhas sao criadas uma vez por worker e reaproveitadas
+	lua_rawgeti(state, LUA_REGISTRYINDEX, refNeighbors);
+	if (lua_rawgeti(state, -1, position + 1) != LUA_TNIL)
+	{
+		lua_remove(state, -2);
+		return;
+	}
+	lua_pop(state, 1);
+
+	const CellValues& current = blocks->current[position];
+
+	lua_createtable(state, 0, 4);
+	for (int i = 0; i < current.size(); i++)
+	{
+		if (isReadOnly(current[i].first))
+		{
+			pushValue(state, current[i].second);
+			lua_setfield(state, -2, current[i].first.c_str());
+		}
+	}
+
+	pushValues(state, blocks->past[position]);
+	lua_setfield(state, -2, "past");
+
+	lua_pushvalue(state, -1);
+	lua_rawseti(state, -3, position + 1);
+	lua_remove(state, -2);
+}
+
+void BlockTask::collectWrites(int position)
+{
+	const CellValues& current = blocks->current[position];
+	vector<bool> kept(current.size(), false);
+	CellValues changed;
+
+	lua_pushnil(state);
+	while (lua_next(state, -2) != 0)
+	{
+		if (lua_type(state, -2) == LUA_TSTRING)
+		{
+			string name = lua_tostring(state, -2);
+			CellValue value;
+			bool scalar = readValue(state, value);
+			bool found = false;
+
+			for (int i = 0; i < current.size() && !found; i++)
+			{
+				if (current[i].first == name)
+				{
+					found = true;
+					kept[i] = true;
+					if (scalar && !(current[i].second == value) && !isReadOnly(name))
+						changed.push_back(make_pair(name, value));
+				}
+			}
+
+			if (!found && scalar)
+				changed.push_back(make_pair(name, value));
+		}
+
+		lua_pop(state, 1);
+	}
+
+	//atributos apagados pela funcao (cell.name = nil) tambem sao apagados na celula original
+	for (int i = 0; i < current.size(); i++)
+	{
+		if (!kept[i] && !isReadOnly(current[i].first))
+		{
+			CellValue value;
+			value.type = LUA_TNIL;
+			value.integer = false;
+			value.intValue = 0;
+			value.number = 0;
+			changed.push_back(make_pair(current[i].first, value));
+		}
+	}
+
+	if (!changed.empty())
+		writes.push_back(make_pair(position, changed));
+}
+
+//forEachNeighbor(cell, [name], f) dentro dos workers, percorre as vizinhancas de estencil
+int BlockTask::forEachNeighbor(lua_State *L)
+{
+	BlockTask *task = (BlockTask*) lua_touserdata(L, lua_upvalueindex(1));
+	CellBlocks *blocks = task->blocks;
+
+	if (lua_type(L, 2) == LUA_TFUNCTION)
+	{
+		lua_pushstring(L, "1");
+		lua_insert(L, 2);
+	}
+
+	luaL_checktype(L, 1, LUA_TTABLE);
+	const char *name = luaL_checkstring(L, 2);
+	luaL_checktype(L, 3, LUA_TFUNCTION);
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, task->refPositions);
+	lua_pushvalue(L, 1);
+	lua_rawget(L, -2);
+	if (lua_type(L, -1) != LUA_TNUMBER)
+		return luaL_error(L, "forEachNeighbor can only traverse the Cell being processed by forEachCell in parallel.");
+
+	int position = (int) lua_tointeger(L, -1);
+	lua_pop(L, 2);
+
+	StencilNeighborhood *neigh = blocks->neighborhoods.value(name, NULL);
+	if (!neigh)
+		return luaL_error(L, "Neighborhood '%s' cannot be used by forEachCell in parallel. Only neighborhoods of regular CellularSpaces created with strategies 'moore', 'vonneumann', 'diagonal', or 'mxn' without filter, weight, or target are supported.", name);
+
+	double weight = neigh->weights[position];
+	for (int k = neigh->first[position]; k < neigh->first[position + 1]; k++)
+	{
+		lua_pushvalue(L, 3);
+		task->pushNeighbor(neigh->neighbors[k]);
+		lua_pushnumber(L, weight);
+		lua_pushvalue(L, 1);
+		lua_call(L, 3, 1);
+
+		if (lua_type(L, -1) == LUA_TBOOLEAN && !lua_toboolean(L, -1))
+			return 1;
+
+		lua_pop(L, 1);
+	}
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+void BlockTask::run()
+{
+	BlockPool *pool = getPool();
+	QMutexLocker locker(&pool->lock);
+
+	while (true)
+	{
+		while (!pending && !stopping)
+			pool->start.wait(&pool->lock);
+
+		if (stopping)
+			return;
+
+		locker.unlock();
+		process();
+		locker.relock();
+
+		pending = false;
+		if (--pool->running == 0)
+			pool->finished.wakeAll();
+	}
+}
+
+void BlockTask::process()
+{
+	result = true;
+	error.clear();
+	writes.clear();
+
+	//a funcao so' e' carregada de novo quando muda entre as chamadas de forEachCell
+	if (refFunction == LUA_NOREF || function != blocks->function)
+	{
+		luaL_unref(state, LUA_REGISTRYINDEX, refFunction);
+		refFunction = LUA_NOREF;
+		function.clear();
+
+		if (luaL_loadbuffer(state, blocks->function.data(), blocks->function.size(), "=forEachCell") != LUA_OK)
+		{
+			error = lua_tostring(state, -1);
+			blocks->failed.store(1);
+			lua_settop(state, 0);
+			return;
+		}
+
+		refFunction = luaL_ref(state, LUA_REGISTRYINDEX);
+		function = blocks->function;
+	}
+
+	//as posicoes e as vizinhas (que guardam o past) mudam entre as chamadas
+	luaL_unref(state, LUA_REGISTRYINDEX, refPositions);
+	lua_newtable(state);
+	refPositions = luaL_ref(state, LUA_REGISTRYINDEX);
+
+	luaL_unref(state, LUA_REGISTRYINDEX, refNeighbors);
+	lua_newtable(state);
+	refNeighbors = luaL_ref(state, LUA_REGISTRYINDEX);
+
+	int size = blocks->current.size();
+
+	while (!blocks->failed.load())
+	{
+		int begin = blocks->nextBlock.fetchAndAddOrdered(1) * blocks->blockSize;
+		if (begin >= size)
+			break;
+
+		int end = min(begin + blocks->blockSize, size);
+
+		for (int position = begin; position < end; position++)
+		{
+			pushCell(position);
+
+			lua_rawgeti(state, LUA_REGISTRYINDEX, refFunction);
+			lua_pushvalue(state, -2);
+			lua_pushinteger(state, position + 1);
+
+			if (lua_pcall(state, 2, 1, 0) != LUA_OK)
+			{
+				error = lua_tostring(state, -1);
+				blocks->failed.store(1);
+				lua_settop(state, 0);
+				return;
+			}
+
+			if (lua_type(state, -1) == LUA_TBOOLEAN && !lua_toboolean(state, -1))
+				result = false;
+
+			lua_pop(state, 1);
+			collectWrites(position);
+
+			lua_rawgeti(state, LUA_REGISTRYINDEX, refPositions);
+			lua_pushvalue(state, -2);
+			lua_pushnil(state);
+			lua_rawset(state, -3);
+			lua_settop(state, 0);
+		}
+	}
+}
+
+int hpaForEachCell(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+	int workers = (int) luaL_optinteger(L, 3, 0);
+
+	if (workers <= 0)
+		workers = std::thread::hardware_concurrency();
+
+	if (workers <= 0)
+		workers = 1;
+
+	CellBlocks blocks;
+
+	lua_pushvalue(L, 2);
+	if (lua_dump(L, dumpWriter, &blocks.function, 0) != 0)
+		return luaL_error(L, "Function used by forEachCell in parallel cannot be copied to the workers.");
+	lua_pop(L, 1);
+
+	//apenas os atributos que a funcao pode ler sao copiados
+	blocks.allAttributes = !DumpReader(blocks.function).read(blocks.attributes);
+
+	lua_getfield(L, 1, "cells");
+	int cells = lua_gettop(L);
+	int size = lua_rawlen(L, cells);
+
+	blocks.current.resize(size);
+	blocks.past.resize(size);
+
+	//colunas do synchronize(values, true), onde o past das celulas nao guarda os valores
+	int columns = 0;
+	if (lua_getfield(L, 1, "past_") == LUA_TTABLE && lua_getfield(L, -1, "columns") == LUA_TTABLE)
+		columns = lua_gettop(L);
+
+	//os workers usam as copias dos atributos, a pilha principal nao e' acessada por eles
+	for (int i = 0; i < size; i++)
+	{
+		lua_rawgeti(L, cells, i + 1);
+		readValues(L, lua_gettop(L), blocks, blocks.current[i]);
+
+		if (lua_getfield(L, -1, "past") == LUA_TTABLE)
+		{
+			if (columns && lua_getmetatable(L, -1))
+			{
+				lua_pop(L, 1);
+				readColumns(L, columns, i + 1, blocks, blocks.past[i]);
+			}
+			else
+				readValues(L, lua_gettop(L), blocks, blocks.past[i]);
+		}
+
+		lua_pop(L, 2);
+	}
+
+	//vizinhancas de estencil: todas as celulas compartilham o mesmo indice
+	if (size > 0)
+	{
+		lua_rawgeti(L, cells, 1);
+		if (lua_getfield(L, -1, "neighborhoods") == LUA_TTABLE)
+		{
+			int neighborhoods = lua_gettop(L);
+			lua_pushnil(L);
+			while (lua_next(L, neighborhoods) != 0)
+			{
+				if (lua_type(L, -2) == LUA_TSTRING && lua_type(L, -1) == LUA_TTABLE)
+				{
+					lua_getfield(L, -1, "first");
+					bool isIndex = lua_type(L, -1) == LUA_TTABLE;
+					lua_pop(L, 1);
+
+					if (isIndex)
+					{
+						StencilNeighborhood *neigh = new StencilNeighborhood();
+						readArray<int>(L, "first", neigh->first, 1);
+						readArray<int>(L, "neighbors", neigh->neighbors, 1);
+						readArray<double>(L, "weights", neigh->weights, 0);
+
+						if (neigh->first.size() == size + 1 && neigh->weights.size() == size)
+							blocks.neighborhoods.insert(lua_tostring(L, -2), neigh);
+						else
+							delete neigh;
+					}
+				}
+
+				lua_pop(L, 1);
+			}
+		}
+		lua_pop(L, 2);
+	}
+
+	//blocos menores que size / workers para que os workers mais rapidos peguem mais blocos
+	blocks.blockSize = max(1, size / (workers * 4));
+	workers = max(1, min(workers, (size + blocks.blockSize - 1) / blocks.blockSize));
+
+	vector<BlockTask*> tasks = BlockTask::execute(&blocks, workers);
+
+	string error;
+	bool result = true;
+
+	for (int i = 0; i < workers; i++)
+	{
+		if (error.empty())
+			error = tasks[i]->getError();
+
+		result = result && tasks[i]->getResult();
+	}
+
+	//cada worker so' altera as suas celulas, entao a ordem das copias nao importa
+	if (error.empty())
+	{
+		for (int i = 0; i < workers; i++)
+		{
+			vector<pair<int, CellValues> >& writes = tasks[i]->getWrites();
+			for (int w = 0; w < writes.size(); w++)
+			{
+				lua_rawgeti(L, cells, writes[w].first + 1);
+				const CellValues& values = writes[w].second;
+
+				for (int v = 0; v < values.size(); v++)
+				{
+					pushValue(L, values[v].second);
+					lua_setfield(L, -2, values[v].first.c_str());
+				}
+
+				lua_pop(L, 1);
+			}
+		}
+	}
+
+	if (!error.empty())
+		return luaL_error(L, "%s", error.c_str());
+
+	lua_pushboolean(L, result);
+	return 1;
+}
@@ -0,0 +1,148 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef BLOCK_TASK_H
+#define BLOCK_TASK_H
+
+extern "C" {
+	#include <lua.h>
+}
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <QtCore>
+
+using namespace std;
+
+//valor escalar (boolean, number ou string) de um atributo de uma celula, ou nil quando
+//ele foi apagado pela funcao de um worker
+struct CellValue {
+	int type;
+	bool integer;
+	lua_Integer intValue;
+	lua_Number number;
+	string text;
+
+	bool operator==(const CellValue& other) const;
+};
+
+typedef vector<pair<string, CellValue> > CellValues;
+
+//vizinhanca de estencil de um espaco celular regular, na forma CSR criada por
+//CellularSpace:createNeighborhood(), com as posicoes comecando em zero
+struct StencilNeighborhood {
+	vector<int> first;
+	vector<int> neighbors;
+	vector<double> weights;
+};
+
+//dados de um forEachCell paralelo, lidos da pilha principal antes dos workers comecarem
+//e apenas consultados por eles
+struct CellBlocks {
+	//bytecode da funcao aplicada a cada celula
+	string function;
+
+	//nomes que a funcao pode ler das celulas; se allAttributes for true (acesso com chaves
+	//calculadas, pairs, next ou rawget), todos os atributos sao copiados
+	set<string> attributes;
+	bool allAttributes;
+
+	//atributos atuais e do passado (synchronize) de cada celula, apenas os que a funcao le
+	vector<CellValues> current;
+	vector<CellValues> past;
+
+	QHash<QString, StencilNeighborhood*> neighborhoods;
+
+	int blockSize;
+	QAtomicInt nextBlock;
+	QAtomicInt failed;
+
+	CellBlocks();
+	~CellBlocks();
+};
+
+// A classe BlockTask implementa os workers do forEachCell paralelo. Os workers formam um pool
+// que continua vivo entre as chamadas de forEachCell; cada um tem a sua propria pilha lua, criada
+// uma vez, e retira blocos de celulas de CellBlocks ate' que eles acabem. As celulas vistas pela
+// funcao sao copias com os atributos atuais e o past da celula original; as vizinhas so' tem o
+// past. Os atributos alterados sao guardados e copiados para as celulas originais pela pilha
+// principal depois que todos os workers terminam.
+class BlockTask : public QThread {
+private:
+	CellBlocks *blocks;
+
+	lua_State *state;
+
+	//bytecode da funcao carregada em refFunction, reaproveitada enquanto for a mesma
+	string function;
+
+	int refFunction;
+	int refPositions;
+	int refNeighbors;
+
+	//protegidos pelo lock do pool
+	bool pending;
+	bool stopping;
+
+	bool result;
+	string error;
+
+	//atributos alterados de cada celula processada pelo worker
+	vector<pair<int, CellValues> > writes;
+
+	void process();
+	void pushCell(int position);
+	void pushNeighbor(int position);
+	void collectWrites(int position);
+
+	static int forEachNeighbor(lua_State *L);
+
+public:
+	BlockTask();
+	~BlockTask();
+
+	void run();
+
+	//executa os blocos com os primeiros workers do pool, criando os que faltam,
+	//e espera todos terminarem; retorna os workers usados
+	static vector<BlockTask*> execute(CellBlocks *blocks, int workers);
+
+	//termina os workers do pool
+	static void stopWorkers();
+
+	//false se alguma chamada da funcao retornou false
+	bool getResult();
+
+	//mensagem de erro, vazia se a funcao executou sem erros
+	string getError();
+
+	vector<pair<int, CellValues> >& getWrites();
+};
+
+//forEachCell(cs, f, workers): aplica f a todas as celulas de cs usando workers threads
+//(todos os nu'cleos se for zero) e retorna false se alguma chamada retornou false
+int hpaForEachCell(lua_State *L);
+
+#endif
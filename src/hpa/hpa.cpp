@@ -29,16 +29,25 @@ void HPA::createWorkers(){
 	//lua_settop(ModeloMain, 0);
 	//lua_gc(ModeloMain, LUA_GCCOLLECT, 0);
 
-	//iniciando os workers
-	for(int i = 0; i < getNumCpu(); i++){
-		workers.push_back(new ProcTask()); // tiago - outra fonte de leak!
-		workers.at(workers.size()-1)->set_State(lua_newthread(ModeloMain));
-		workers.at(workers.size()-1)->setRefThread(luaL_ref(ModeloMain, LUA_REGISTRYINDEX));
+	int first = workers.size();
+
+	//iniciando apenas os workers que faltam, os que ja' existem continuam vivos
+	for(int i = first; i < getNumCpu(); i++){
+		workers.push_back(new ProcTask(i, ModeloMain)); // tiago - outra fonte de leak!
+		workers.at(i)->set_State(lua_newthread(ModeloMain));
+		workers.at(i)->setRefThread(luaL_ref(ModeloMain, LUA_REGISTRYINDEX));
 		//setamos aqui o recurso compartilhado entre o processo principal hpa e os trabalhadores
 		//(e' preciso efetuar o controle de acesso as tasks)
-		workers.at(workers.size()-1)->setBag(&BAG);
-		workers.at(workers.size()-1)->setControlQMut(&LOCK_BAG);
-		lua_gc(workers.at(workers.size()-1)->getState(), LUA_GCSTOP, 0);
+		workers.at(i)->setBag(&BAG);
+		workers.at(i)->setControlQMut(&LOCK_LUA);
+		lua_gc(workers.at(i)->getState(), LUA_GCSTOP, 0);
+	}
+
+	BAG.setWorkers(getNumCpu());
+
+	//os workers ficam esperando por tasks na bag ate' serem retirados
+	for(int i = first; i < workers.size(); i++){
+		workers.at(i)->start();
 	}
 }
 
@@ -56,17 +65,24 @@ void HPA::createWorkers(){
 //									// Mais doido ainda quando vemos que o vetor workers eh estatico'
 // }
 
-void HPA::removeWorkers(lua_State *L){
-	vector<ProcTask*>::iterator it;
+//mantem apenas os primeiros quant workers, as tasks dos demais passam para eles
+void HPA::retireWorkers(lua_State *L, int quant){
+	BAG.setWorkers(quant);
 
-	for(it = workers.begin(); it != workers.end(); it++){
-		luaL_unref(L, (*it)->getRefThread(), LUA_REGISTRYINDEX);
+	for(int i = quant; i < workers.size(); i++){
+		workers.at(i)->wait();
+		luaL_unref(L, LUA_REGISTRYINDEX, workers.at(i)->getRefThread());
 
 		// Tiago -- necessario para remover leak de memoria geraso pelo saulo
-		delete *it;
+		delete workers.at(i);
 	}
 
-	workers.clear();
+	if(quant < workers.size())
+		workers.resize(quant);
+}
+
+void HPA::removeWorkers(lua_State *L){
+	retireWorkers(L, 0);
 }
 
 void HPA::removeLockSections( void ){
@@ -113,7 +129,7 @@ HPA::HPA(lua_State* L){
 
 	//aqui setamos o recurso compartilhado para o processo ou a pilha principal(dessa forma economizamos memo'ria)
 	setBag(&BAG);
-	setControlQMut(&LOCK_BAG);
+	setControlQMut(&LOCK_LUA);
 
 	// Tiago - linha necessaria para resolver leak
 	mainStack = NULL;
@@ -183,6 +199,9 @@ HPA::HPA(string pathModel, lua_State *L){
 
 	mainStack->set_State(ModeloMain);
 
+	setBag(&BAG);
+	setControlQMut(&LOCK_LUA);
+
 	setNumCpu(std::thread::hardware_concurrency());
 
 	createWorkers();
@@ -225,27 +244,8 @@ int HPA::execute(){
 // Tiago - comentei linha abaixo para manter coerencia com a nomenclarura adotada no TerraME
 //int HPA::HPA_JOINALL(lua_State* L){
 int HPA::joinall(lua_State* L){
-	while(!Bag->empty()){
-		for (int i = 0; i < getNumCpu(); i++) {
-			if (!workers.at(i)->isRunning() && !Bag->empty())
-                workers.at(i)->start();
-		}
-
-		for (int i = 0; i < getNumCpu(); i++){
-			if (workers.at(i)->isRunning())
-				workers.at(i)->wait();
-		}
-    }
-
-	for (int i = 0; i < getNumCpu(); i++){
-		if (!workers.at(i)->isRunning() && !Bag->empty())
-			workers.at(i)->start();
-	}
-
-	for (int i = 0; i < getNumCpu(); i++){
-		if (workers.at(i)->isRunning())
-			workers.at(i)->wait();
-	}
+	//os workers sao persistentes, basta esperar a bag ficar sem tasks pendentes
+	Bag->waitAll();
 
 	/*
 	if(lua_status(L) != 0 && lua_status(L) != 1){
@@ -266,10 +266,13 @@ int HPA::np(lua_State* L){
 		lua_pushinteger(L, numCPU);
 		return 1;
 	}
-	//e' preciso esperar todas as threads terminarem pois estas serao destrui'das para a criacao de novas
+	//as tasks pendentes terminam com a quantidade antiga de workers
 	HPA::joinall(L);
 
-	removeWorkers(L);
+	//apenas os workers que sobram sao destrui'dos ou os que faltam criados
+	if(newQuantProc < numCPU)
+		retireWorkers(L, newQuantProc);
+
 	numCPU = newQuantProc;
 
 	createWorkers();
@@ -320,33 +323,8 @@ int HPA::release(lua_State *L){
 int HPA::join(lua_State* L){
 	string nameFuncJoin = lua_tostring(L, 1);
 
-	//dos workers que estao executando existe algum qeu esta a executar esta funcao?
-	for(int i = 0; i < workers.size(); i++){
-		if(!workers.at(i)->getName().compare(nameFuncJoin)){
-			workers.at(i)->wait();
-		}
-	}
-
-	bool thereATask = false;
-	//agora preciso verificar se a bag recebeu alguma chamada dessa funcao
-
-	justOne.lock();
-	int sizeBag = Bag->size();
-
-	for (std::list<ParamTask>::iterator it = Bag->begin(); it != Bag->end(); it++){
-		if(!it->getNameTask().compare(nameFuncJoin)){
-			thereATask = true;
-			break;
-		}
-	}
-	justOne.unlock();
-
-	//existe processo na bag com este nome e temos que aguardar a sua execucao
-	if(thereATask){
-		for(int i = 0; i < workers.size(); i++){
-			workers.at(i)->wait();
-		}
-	}
+	//espera apenas as tasks desta funcao, que estejam na bag ou executando
+	Bag->wait(nameFuncJoin);
 
 	if(lua_status(L) != 0 && lua_status(L) != 1){
 		cerr << "error in main stack \n";
@@ -458,8 +436,6 @@ int HPA::parallel(lua_State* L){
 	//bagInsertion(to_execute, nameFuncToExec, namesOfPar, varReturn, tempStackVals);
 
 	//isso aqui faz parte do metodo de baginsertion
-	lock_bag->lock();
-
 	ParamTask toIncludeBagP;
 	toIncludeBagP.setCallTask(to_execute);
 	toIncludeBagP.setNameTask(nameFuncToExec);
@@ -471,19 +447,11 @@ int HPA::parallel(lua_State* L){
 	else
 		toIncludeBagP.set_State(tempStackVals);
 
-	Bag->push_back(toIncludeBagP);
-	lock_bag->unlock();
+	//a bag acorda um worker ocioso para tratar a requisicao
+	Bag->insert(toIncludeBagP);
 
 	//fim do metodo insertion aqui
 
-	//aqui verificamos se existe algum worker parado e efetuamos a inicializacao de algum deles para tratar a requisicao caso algum esteja ocioso
-	for(int i = 0; i < workers.size(); i++){
-		if(!workers.at(i)->isRunning()){
-			workers.at(i)->start();
-			break;
-		}
-	}
-
 	return 0;
 }
 
@@ -535,18 +503,18 @@ int HPA::HPATests(lua_State * now){
 }
 
 //metodos para setar e acessar os recursos da bag
-void HPA::setBag(list<ParamTask>* Bag_){
+void HPA::setBag(BagOfTasks* Bag_){
 	Bag = Bag_;
 }
 
 void HPA::setControlQMut(QMutex* controlMutex_){
-	lock_bag = controlMutex_;
+	lock_lua = controlMutex_;
 }
 
-list<ParamTask>* HPA::getBag(){
+BagOfTasks* HPA::getBag(){
 	return Bag;
 }
 
 QMutex* HPA::getControlQMut(){
-	return lock_bag;
+	return lock_lua;
 }
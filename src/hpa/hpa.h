@@ -61,8 +61,8 @@ private:
 	ProcHPA *mainStack;
 	string pathModel;
 
-	list<ParamTask> *Bag;
-	QMutex *lock_bag;
+	BagOfTasks *Bag;
+	QMutex *lock_lua;
 
 	//Hash para criacao das secoes criticas lembrar de utilizalos com o wait condition
 	QHash<QString, QMutex*> lockSection;
@@ -70,6 +70,7 @@ private:
 	QMutex justOne;
 
 	void createWorkers();
+	void retireWorkers(lua_State *, int);
 	void removeWorkers(lua_State *);
 	void removeLockSections(void); // Tiago - remover leak
 	lua_State* Read_Parameters(lua_State*, vector<string>);
@@ -78,10 +79,10 @@ private:
 
 	//metodos para acessar e setar a bag para fora(public, like interface) para o controle de acesso tambe'm uma vez
 	//que ele e' compartilhado
-	void setBag(list<ParamTask>*);
+	void setBag(BagOfTasks*);
 	void setControlQMut(QMutex* controlMutex);
 
-	list<ParamTask>* getBag();
+	BagOfTasks* getBag();
 	QMutex* getControlQMut();
 
 	//QHash<QString, QMutex*> getLockSec();
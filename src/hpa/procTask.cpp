@@ -24,7 +24,9 @@ of this software and its documentation.
 #include "procTask.h"
 #include "envHPA.h"
 
-ProcTask::ProcTask(){
+ProcTask::ProcTask(int id_, lua_State *mainState_){
+	id = id_;
+	mainState = mainState_;
 	isRunning_ = 0;
 }
 
@@ -117,33 +119,15 @@ void ProcTask::setParms(vector<string> param_of_cham_, vector<string> param_of_r
 }
 
 void ProcTask::run() {
-	bool just_one = false;
+	ParamTask tempParam;
 
-	//thread comecou a consumir
-	this->isRunning_ = 1;
+	//o worker nao termina quando a bag esvazia: ele espera em take() por novas tasks
+	//(da sua fila ou roubadas dos outros) ate' ser retirado pelo HPA
+	while(Bag->take(id, tempParam)){
+		//thread comecou a consumir
+		this->isRunning_ = 1;
 
-	while(!Bag->empty()){
-		lock_bag->lock();
-
-		if(Bag->size() <= getNumCpu()){
-			just_one = true;
-		}
-
-		ParamTask tempParam;
-
-		//SAULO
-		//bagOfTask(tempParam);
-		//neste caso sai um resultado para ser tratado no run (preciso refatorar aqui)
-
-		if(Bag->empty()){
-			lock_bag->unlock();
-			return;
-		}else{
-			tempParam = Bag->front();
-			//primeira task a ser tratada
-			Bag->pop_front();
-		}
-		//lock_bag->unlock();
+		lock_lua->lock();
 
 		//lockAcess.lock();
 		this->setName(tempParam.getNameTask());
@@ -183,7 +167,7 @@ void ProcTask::run() {
 		}
 
 		//lockAcess.unlock();
-		lock_bag->unlock();
+		lock_lua->unlock();
 
 		//lua_call(funcLua, tempParam.getSetParam().size(), 1);
 		int that_ok = lua_resume(this->funcLua, this->funcLua, tempParam.getSetParam().size()); //(funcLua, tempParam.getSetParam().size(), 1);
@@ -217,32 +201,32 @@ void ProcTask::run() {
 			cerr.flush();
 			lua_yield(getState(), 0);
 			//lua_settop(Func_Lua, 0);
-			luaL_unref(getState(), getRefThread(), LUA_REGISTRYINDEX);
-			set_State(lua_newthread(ModeloMain));
-			setRefThread(luaL_ref(ModeloMain, LUA_REGISTRYINDEX));
+			luaL_unref(mainState, LUA_REGISTRYINDEX, getRefThread());
+			set_State(lua_newthread(mainState));
+			setRefThread(luaL_ref(mainState, LUA_REGISTRYINDEX));
+			lua_gc(getState(), LUA_GCSTOP, 0);
 		}
 
 		lockAcess.unlock();
-		if(just_one){
-			break;
-		}
+
+		setRunState(0);
+		Bag->done(tempParam);
 	}
-	setRunState(0);
 }
 
 //metodos para setar e acessar os recursos da bag
-void ProcTask::setBag(list<ParamTask>* Bag_){
+void ProcTask::setBag(BagOfTasks* Bag_){
 	Bag = Bag_;
 }
 
 void ProcTask::setControlQMut(QMutex* controlMutex_){
-	lock_bag = controlMutex_;
+	lock_lua = controlMutex_;
 }
 
-list<ParamTask>* ProcTask::getBag(){
+BagOfTasks* ProcTask::getBag(){
 	return Bag;
 }
 
 QMutex* ProcTask::getControlQMut(){
-	return lock_bag;
+	return lock_lua;
 }
@@ -62,12 +62,18 @@ private:
 	//referencia para enganar garbage collector
 	int refThread;
 
-	list<ParamTask> *Bag;
+	//posicao do worker na bag, define a fila que ele consome primeiro
+	int id;
 
-	QMutex *lock_bag;
+	//pilha principal, usada para recriar a co-routine do worker em caso de erro
+	lua_State *mainState;
+
+	BagOfTasks *Bag;
+
+	QMutex *lock_lua;
 
 public:
-	ProcTask();
+	ProcTask(int id_, lua_State *mainState_);
 
     //quando um a funcao terminou
     void set_State(lua_State *Func);
@@ -92,7 +98,7 @@ public:
 
 	void w_stack();
 
-	//thread
+	//thread: consome a bag ate' o worker ser retirado pelo HPA
 	void run();
 
 	//set o estado corrente da task em execucao
@@ -105,10 +111,10 @@ public:
 
 	//metodos para acessar e setar a bag para fora(public, like interface) para o controle de acesso tambe'm uma vez
 	//que ele e' compartilhado
-	void setBag(list<ParamTask>*);
+	void setBag(BagOfTasks*);
 	void setControlQMut(QMutex* controlMutex);
 
-	list<ParamTask>* getBag();
+	BagOfTasks* getBag();
 	QMutex* getControlQMut();
 };
 
@@ -65,29 +65,89 @@ end
 
 _Gtme.loadLibraryPath()
 
-_Gtme.terralib_mod_binding_lua = nil
+local startupTimes = {}
 
-local function initializeTerraLib()
-	if _Gtme.terralib_mod_binding_lua == nil then
-		require("terralib_mod_binding_lua")
-		local binding = terralib_mod_binding_lua
-		binding.TeSingleton.getInstance():initialize()
-		binding.InitializePluginSystem()
-		binding.LoadAll()
-		_Gtme.terralib_mod_binding_lua = terralib_mod_binding_lua
+-- Execute a function that loads a component of TerraME, recording the wall-clock
+-- time it takes to be shown by option -startup.
+function _Gtme.loadComponent(name, func)
+	local clock = cpp_elapsedtime()
+	local result = func()
+
+	table.insert(startupTimes, {name = name, time = cpp_elapsedtime() - clock})
+	return result
+end
+
+local terralib
+local terralibPlugins = false
+
+-- Initialize TerraLib on its first use, as it takes most of the time to start TerraME
+-- and many models do not use it. Its plugins, which give access to the data sources,
+-- are loaded only when plugins is true.
+function _Gtme.loadTerraLib(plugins)
+	if terralib == nil then
+		_Gtme.loadComponent("TerraLib", function()
+			require("terralib_mod_binding_lua")
+			terralib = terralib_mod_binding_lua
+			terralib.TeSingleton.getInstance():initialize()
+			terralib.InitializePluginSystem()
+		end)
+	end
+
+	if plugins and not terralibPlugins then
+		_Gtme.loadComponent("TerraLib plugins", function()
+			terralib.LoadAll()
+		end)
+
+		terralibPlugins = true
 	end
+
+	return terralib
+end
+
+-- The binding used by package gis. It initializes TerraLib and its plugins when
+-- any of its elements is used for the first time.
+local function lazyBinding(binding)
+	setmetatable(binding, {__index = function(_, idx)
+		local loaded = _Gtme.loadTerraLib(true)
+
+		setmetatable(binding, {__index = loaded})
+		return loaded[idx]
+	end})
 end
 
+_Gtme.terralib_mod_binding_lua = {}
+lazyBinding(_Gtme.terralib_mod_binding_lua)
+
 local function finalizeTerraLib()
-	if _Gtme.terralib_mod_binding_lua ~= nil then
-		local binding = terralib_mod_binding_lua
-		binding.FinalizePluginSystem()
-		binding.TeSingleton.getInstance():finalize()
-		_Gtme.terralib_mod_binding_lua = nil
+	if terralib ~= nil then
+		terralib.FinalizePluginSystem()
+		terralib.TeSingleton.getInstance():finalize()
+		terralib = nil
+		terralibPlugins = false
+		lazyBinding(_Gtme.terralib_mod_binding_lua)
 	end
 end
 
-initializeTerraLib()
+local function startupReport()
+	local loaded = {}
+	local total = 0
+
+	print("Startup report (wall-clock time):")
+
+	for _, component in ipairs(startupTimes) do
+		print(string.format("  %-20s %8.3fs", component.name, component.time))
+		loaded[component.name] = true
+		total = total + component.time
+	end
+
+	for _, name in ipairs{"TerraLib", "TerraLib plugins", "QGIS support"} do
+		if not loaded[name] then
+			print(string.format("  %-20s %9s", name, "not used"))
+		end
+	end
+
+	print(string.format("  %-20s %8.3fs", "Total", total))
+end
 
 local function checkUnnecessaryArguments(arguments, argCount)
 	if #arguments > argCount then
@@ -599,6 +659,10 @@ local function usage()
 	print("                         internal lines from TerraME and loaded packages).")
 	print("-gui                     Show the player for the application (it works only")
 	print("                         when an Environment or a Timer object is used.")
+	print("-headless                Run the simulation without processing graphical events.")
+	print("                         The player is disabled and observers do not refresh")
+	print("                         their windows while the simulation runs. Maps of")
+	print("                         CellularSpaces are drawn only into images.")
 	print("-ide                     Configure TerraME for running from IDEs in Windows.")
 	print("-install <pkg>           Install a package stored in TerraME's repository.")
 	print("                         It can also be a local .zip file.")
@@ -624,6 +688,9 @@ local function usage()
 	print("                         executed.")
 	print("  -uninstall             Remove an installed package.")
 	print("-silent                  print() does not show any text on the screen.")
+	print("-startup                 Show the time spent loading each component of TerraME")
+	print("                         after running the script. TerraLib and its plugins are")
+	print("                         loaded only when the script uses them.")
 	print("-version                 Show TerraME general information.")
 	print("-zb <dir>                Configures ZeroBrane to run TerraME. It uses the")
 	print("                         default installation directory or <dir>.")
@@ -990,7 +1057,9 @@ local function runScript(script)
 	end
 
 	if not _Gtme.isLoaded("base") then
-		_Gtme.import("base")
+		_Gtme.loadComponent("Package base", function()
+			_Gtme.import("base")
+		end)
 	end
 
 	_Gtme.loadTmeFile(script)
@@ -1034,6 +1103,10 @@ local function runScript(script)
 		_Gtme.printError(result)
 		os.exit(1)
 	end
+
+	if info_.startup then
+		startupReport()
+	end
 end
 
 function _Gtme.execExample(example, packageName)
@@ -1630,6 +1703,10 @@ function _Gtme.execute(arguments) -- 'arguments' is a vector of strings
 				os.exit(numIssues)
 			elseif arg == "-hpa" then
 				info_.hpa = true
+			elseif arg == "-headless" then
+				info_.headless = true
+			elseif arg == "-startup" then
+				info_.startup = true
 			else
 				_Gtme.printError("Option not recognized: '"..arg.."'.")
 				os.exit(1)
@@ -24,6 +24,7 @@ of this software and its documentation.
 #include "cellSpaceSubjectInterf.h"
 
 #include "types/agentObserverMap.h"
+#include "types/observerImage.h"
 #include "types/observerUDPSender.h"
 
 #include "types/observerTextScreen.h"
@@ -61,6 +62,10 @@ Observer * CellSpaceSubjectInterf::createObserver(TypesOfObservers type)
             obs = new AgentObserverMap(this);
             break;
 
+        case TObsImage:
+            obs = new ObserverImage(this);
+            break;
+
         case TObsTextScreen:
         default:
             obs = new ObserverTextScreen(this);
@@ -110,6 +115,11 @@ bool CellSpaceSubjectInterf::kill(int id)
             delete(AgentObserverMap *)obs;
             break;
 
+        case TObsImage:
+           ((ObserverImage *)obs)->close();
+            delete(ObserverImage *)obs;
+            break;
+
         default:
             delete obs;
             break;
@@ -0,0 +1,140 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "legendLookup.h"
+
+#include <algorithm>
+
+#include "legendAttributes.h"
+
+using namespace TerraMEObserver;
+
+namespace {
+
+struct Slice
+{
+    double from;
+    double to;
+    int order;
+    QRgb color;
+
+    bool operator<(const Slice &other) const
+    {
+        return (from < other.from) || ((from == other.from) && (order < other.order));
+    }
+};
+
+bool legendOrder(const Slice &a, const Slice &b)
+{
+    return a.order < b.order;
+}
+
+} // namespace
+
+LegendLookup::LegendLookup(Attributes *attrib)
+    : uniqueValue(attrib->getGroupMode() == TObsUniqueValue), disjoint(true),
+    white(qPremultiply(QColor(Qt::white).rgba()))
+{
+    const QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    QVector<Slice> slices;
+
+    for (int j = 0; j < vecLegend->size(); j++)
+    {
+        const ObsLegend &leg = vecLegend->at(j);
+        QRgb color = qPremultiply(leg.getColor().rgba());
+
+        // the first slice of a repeated value wins, as in a linear scan
+        if (!textColors.contains(leg.getFrom()))
+            textColors.insert(leg.getFrom(), color);
+
+        if (uniqueValue)
+        {
+            if (!numberColors.contains(leg.getToNumber()))
+                numberColors.insert(leg.getToNumber(), color);
+        }
+        else if (leg.getFromNumber() < leg.getToNumber())
+        {
+            // empty (or NaN) slices never match and are dropped
+            Slice slice = { leg.getFromNumber(), leg.getToNumber(), j, color };
+            slices.append(slice);
+        }
+    }
+
+    std::sort(slices.begin(), slices.end());
+
+    froms.reserve(slices.size());
+    tos.reserve(slices.size());
+    colors.reserve(slices.size());
+
+    for (int i = 0; i < slices.size(); i++)
+    {
+        if ((i > 0) && (slices.at(i).from < tos.last()))
+            disjoint = false;
+
+        froms.append(slices.at(i).from);
+        tos.append(slices.at(i).to);
+        colors.append(slices.at(i).color);
+    }
+
+    if (!disjoint)
+    {
+        // keeps the legend order so that the first matching slice wins
+        std::sort(slices.begin(), slices.end(), legendOrder);
+
+        for (int i = 0; i < slices.size(); i++)
+        {
+            froms[i] = slices.at(i).from;
+            tos[i] = slices.at(i).to;
+            colors[i] = slices.at(i).color;
+        }
+    }
+}
+
+QRgb LegendLookup::getColor(double v) const
+{
+    if (uniqueValue)
+        return numberColors.value(v, white);
+
+    if (disjoint)
+    {
+        const double *first = froms.constData();
+        const double *pos = std::upper_bound(first, first + froms.size(), v);
+        int idx = int(pos - first) - 1;
+
+        if ((idx >= 0) && (v < tos.at(idx)))
+            return colors.at(idx);
+        return white;
+    }
+
+    for (int i = 0; i < froms.size(); i++)
+    {
+        if ((froms.at(i) <= v) && (v < tos.at(i)))
+            return colors.at(i);
+    }
+    return white;
+}
+
+QRgb LegendLookup::getColor(const QString &v) const
+{
+    return textColors.value(v, white);
+}
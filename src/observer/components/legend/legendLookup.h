@@ -0,0 +1,84 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef OBSERVER_LEGEND_LOOKUP_H
+#define OBSERVER_LEGEND_LOOKUP_H
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtGui/QColor>
+
+namespace TerraMEObserver {
+
+class Attributes;
+
+/**
+ * \brief Compiled form of the legend of an Attributes
+ *
+ * Converts the legend slices into premultiplied colors that can be looked
+ * up without scanning the whole legend for each cell. Unique values and
+ * texts are hashed; numeric slices are sorted by their lower bound and
+ * found with a binary search. Overlapping slices keep the original
+ * first-match order through a linear scan of the compiled slices.
+ * \see Attributes, \see ObsLegend
+ * \file legendLookup.h
+ */
+class LegendLookup
+{
+public:
+    /**
+     * Constructor
+     * \param attrib a pointer to the Attributes whose legend will be compiled
+     */
+    LegendLookup(Attributes *attrib);
+
+    /**
+     * Gets the premultiplied color of a numeric value \a v.
+     * Values out of every slice are white.
+     */
+    QRgb getColor(double v) const;
+
+    /**
+     * Gets the premultiplied color of a text value \a v.
+     * Values out of the legend are white.
+     */
+    QRgb getColor(const QString &v) const;
+
+private:
+    bool uniqueValue;
+    bool disjoint;
+
+    QVector<double> froms;
+    QVector<double> tos;
+    QVector<QRgb> colors;
+
+    QHash<double, QRgb> numberColors;
+    QHash<QString, QRgb> textColors;
+
+    QRgb white;
+};
+
+} // namespace TerraMEObserver
+
+#endif // OBSERVER_LEGEND_LOOKUP_H
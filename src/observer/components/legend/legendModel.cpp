@@ -0,0 +1,645 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "legendModel.h"
+#include "legendStatistics.h"
+#include "core/LuaSystem.h"
+
+#include <QtCore/QMap>
+#include <QtCore/QtAlgorithms>
+#include <QDebug>
+
+#include <cmath>
+#include <limits>
+#include "terrameGlobals.h"
+
+///< Gobal variabel: Lua stack used for comunication with C++ modules.
+extern lua_State * L;
+extern ExecutionModes execModes;
+
+using namespace TerraMEObserver;
+
+const QString LegendModel::MEAN = "mean";
+
+LegendModel::LegendModel() : mapAttributes(0)
+{
+}
+
+LegendModel::~LegendModel()
+{
+}
+
+void LegendModel::setValues(QHash<QString, Attributes*> *mapAttribs)
+{
+    mapAttributes = mapAttribs;
+}
+
+void LegendModel::makeLegend()
+{
+    QList<Attributes *> attribs = mapAttributes->values();
+
+    for (int i = 0; i < attribs.size(); i++)
+        makeLegend(attribs.at(i));
+}
+
+void LegendModel::makeLegend(Attributes *attrib)
+{
+    GroupingMode mode = attrib->getGroupMode();
+
+    if ((attrib->getDataType() == TObsText) && (mode != TObsUniqueValue))
+    {
+        if (execModes != Quiet)
+        {
+            QString msg = QString("Warning: The attribute '%1' is not a numerical value.")
+                .arg(attrib->getName());
+            std::string errOut = msg.toLatin1().constData();
+            terrame::lua::LuaSystem::getInstance().getLuaApi()->callWarning(L, errOut);
+        }
+        return;
+    }
+
+    // a precisao e as fatias contam com o zero, como nos comboBoxes da LegendWindow
+    int precision = attrib->getPrecisionNumber() + 1;
+    std::vector<ColorBar> colorBar = attrib->getColorBar();
+    std::vector<TeColor> colors;
+    int rows = 0;
+
+    switch (mode)
+    {
+        case TObsEqualSteps:
+        case TObsQuantil:
+        {
+            int slices = attrib->getSlices();
+            if (slices <= 0)
+                slices = 4;
+            attrib->setSlices(slices);
+
+            rows = slices + 1;
+            colors = getColors(colorBar, rows);
+
+            if (mode == TObsEqualSteps)
+                groupByEqualStep(attrib, rows, precision, colors);
+            else
+                groupByQuantil(attrib, rows, precision, colors);
+
+            countElementsBySlices(attrib, mode, colors);
+            attrib->setStdDeviation(TObsNone);
+            break;
+        }
+
+        case TObsStdDeviation:
+        {
+            static const double ndevs[] = {1.0, 0.5, 0.25};
+
+            int stdDev = attrib->getStdDeviation();
+            if ((stdDev < TObsFull) || (stdDev > TObsQuarter))
+                stdDev = TObsFull;
+
+            groupByStdDeviation(attrib, ndevs[stdDev], precision);
+            colors = stdDeviationColors(attrib, colorBar, attrib->getStdColorBar());
+            countElementsBySlices(attrib, mode, colors);
+            break;
+        }
+
+        case TObsUniqueValue:
+        default:
+            if (!groupByUniqueValue(attrib))
+            {
+                if (execModes != Quiet)
+                {
+                    qWarning("Warning: The \"%s\" attribute has been configured incorrectly. "
+                        "An error might have occurred when this attribute was defined in the legend.",
+                        qPrintable(attrib->getName()));
+                }
+                return;
+            }
+
+            // Corre??o de bug: divis?o por zero no m?todo getColors do TeColorUtils.cpp
+            rows = attrib->getLegend()->size();
+            if (rows == 1)
+                rows++;
+
+            colors = getColors(colorBar, rows);
+            colorUniqueValues(attrib, colors);
+            attrib->setStdDeviation(TObsNone);
+            break;
+    }
+}
+
+void LegendModel::groupByEqualStep(Attributes *attrib, int rows, int precision,
+                                   const std::vector<TeColor> &colors)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    vecLegend->clear();
+
+    // corre??o para mais e para menos...
+    double fix = 1 / pow(10, precision);
+
+    double maxValue = attrib->getMaxValue();
+    double minValue = attrib->getMinValue();
+    double slice =(maxValue - minValue) /(rows * 1.0);
+
+    for (int row = 0; row < rows; ++row)
+    {
+        QString from, to;
+
+        if ((row != 0) && (row != rows - 1))
+        {
+            from = QString("%1").arg(minValue + double(row) * slice,
+                                     0, 'f', precision);
+            to = QString("%1").arg(minValue + double(row + 1) * slice,
+                                   0, 'f', precision);
+        }
+        else // Corrige a legenda para o primeiro e ultimo valor
+        {
+            if (row == 0)
+            {
+                from = QString("%1").arg(minValue + double(row) * slice - fix,
+                                         0, 'f', precision);
+                to = QString("%1").arg(minValue + double(row + 1) * slice,
+                                       0, 'f', precision);
+            }
+            else
+            {
+                from = QString("%1").arg(minValue + double(row) * slice,
+                                         0, 'f', precision);
+                to = QString("%1").arg(minValue + double(row + 1) * slice  + fix,
+                                       0, 'f', precision);
+            }
+        }
+
+        QString label = QString("%1 ~ %2").arg(from).arg(to);
+
+        ObsLegend leg;
+        leg.setFrom(from);
+        leg.setTo(to);
+        leg.setLabel(label);
+        leg.setOccurrence(0);
+
+        // recupera a cor j? dividida entre os slices
+        leg.setColor(colors.at(row).red_,
+                colors.at(row).green_,
+                colors.at(row).blue_);
+
+        vecLegend->append(leg);
+    }
+}
+
+void LegendModel::groupByQuantil(Attributes *attrib, int rows, int precision,
+                                 const std::vector<TeColor> &colors)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    vecLegend->clear();
+
+    // Os valores do atributo nao sao modificados: apenas as posicoes
+    // usadas pela legenda sao selecionadas, sem ordenar todo o vetor
+    const QVector<double> *values = attrib->getNumericValues();
+    int size = values->size();
+
+    if (size == 0)
+        return;
+
+    double fix = 1 / pow(10, precision);
+    double step = size /(rows * 1.0);
+
+    // posicoes do inicio de cada fatia e do ultimo valor
+    QVector<int> positions;
+    positions.append(0);
+    for (int n = 1; ; n++)
+    {
+        int p =(int)(step *(double)n + 0.5);
+        if (p >= size)
+            break;
+        positions.append(p);
+    }
+    positions.append(size - 1);
+
+    QVector<double> quantiles = LegendStatistics::quantiles(*values, positions);
+    double last = quantiles.last();
+
+#ifdef DEBUB_OBSERVER
+    qDebug() << "values.end(): " << size;
+    qDebug() << "colors.size(): " << colors.size();
+    qDebug() << "step: " << step;
+#endif
+
+    for (int n = 1; n < positions.size(); n++)
+    {
+        QString from;
+
+        if (positions.at(n - 1) == 0)
+            from = QString("%1").arg(quantiles.at(n - 1) - fix , 0, 'f', precision);
+        else
+            from = QString("%1").arg(quantiles.at(n - 1), 0, 'f', precision);
+
+        int p =(int)(step *(double)n + 0.5);
+
+        QString to;
+        if (p < size)
+        {
+            to = QString("%1").arg(quantiles.at(n), 0, 'f', precision);
+        }
+        else
+        {
+            if (p != size)
+                to = QString("%1").arg(last, 0, 'f', precision);
+            else
+                to = QString("%1").arg(last + fix , 0, 'f', precision);
+        }
+
+        QString label = QString("%1 ~ %2").arg(from).arg(to);
+
+        ObsLegend leg;
+        leg.setFrom(from);
+        leg.setTo(to);
+        leg.setLabel(label);
+        leg.setOccurrence(0);
+
+        // recupera a cor j? dividida entre os slices
+        leg.setColor(colors.at(n - 1).red_,
+                colors.at(n - 1).green_,
+                colors.at(n - 1).blue_);
+        vecLegend->append(leg);
+    }
+}
+
+void LegendModel::groupByStdDeviation(Attributes *attrib, double ndev, int precision)
+{
+    // Compute mim, max and mean
+    LegendStatistics::Summary summary = LegendStatistics::summarize(*attrib->getNumericValues());
+
+    double min = summary.min;
+    double max = summary.max;
+    double mean = summary.mean;
+    double sdev = summary.stdDev;
+
+    double fix = 1 / pow(10, precision);
+    double slice = sdev * ndev;
+    double val = mean;
+    int idxColor = 0;
+
+    QString strMean = QString("%1").arg(mean , 0, 'f', precision);
+
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    QVector<ObsLegend> auxVecLegend;
+    vecLegend->clear();
+
+    while (val - slice > min - slice)
+    {
+        double v = val - slice;
+
+        ObsLegend leg;
+        leg.setFrom(QString("%1").arg(v, 0, 'f', precision));
+        leg.setTo(QString("%1").arg(val, 0, 'f', precision));
+        leg.setLabel(QString("%1 ~ %2").arg(leg.getFrom()).arg(leg.getTo()));
+
+        auxVecLegend.append(leg);
+        val = v;
+    }
+
+    for (int i = auxVecLegend.size() - 1; i >= 0; i--)
+    {
+        ObsLegend leg = auxVecLegend.at(i);
+
+        leg.setIdxColor(idxColor);
+        idxColor++;
+        vecLegend->append(leg);
+    }
+
+    QString media = QString("%1 = %2").arg(MEAN).arg(strMean);
+
+    ObsLegend leg;
+    leg.setFrom(media);
+    leg.setTo("");
+    leg.setLabel(media);
+
+    leg.setIdxColor(idxColor);
+    idxColor++;
+
+    vecLegend->append(leg);
+
+    val = mean;
+    while (val + slice < max + slice)
+    {
+        double v = val + slice;
+
+        ObsLegend leg;
+        leg.setFrom(QString("%1").arg(val, 0, 'f', precision));
+        leg.setTo(QString("%1").arg(v, 0, 'f', precision));
+        leg.setLabel(QString("%1 ~ %2")
+                      .arg(leg.getFrom()).arg(leg.getTo()));
+
+        leg.setIdxColor(idxColor);
+        idxColor++;
+
+        vecLegend->append(leg);
+        val = v;
+    }
+
+    if (vecLegend->size() > 2)
+    {
+        // Corrige o valor minimo
+        ObsLegend leg = vecLegend->at(0);
+        leg.setFrom(QString("%1").arg(min - fix, 0, 'f', precision));
+
+        if (!leg.getFrom().contains(MEAN))
+        {
+            leg.setLabel(QString("%1 ~ %2")
+                          .arg(leg.getFrom()).arg(leg.getTo()));
+        }
+        vecLegend->replace(0, leg);
+
+        // Corrige o valor maximo
+        leg = vecLegend->at(vecLegend->size() - 1);
+        leg.setTo(QString("%1").arg(max + fix, 0, 'f', precision));
+
+        if (!leg.getFrom().contains(MEAN))
+        {
+            leg.setLabel(QString("%1 ~ %2")
+                          .arg(leg.getFrom()).arg(leg.getTo()));
+        }
+        vecLegend->replace(vecLegend->size() - 1, leg);
+    }
+}
+
+bool LegendModel::groupByUniqueValue(Attributes *attrib)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    vecLegend->clear();
+
+    std::vector<double> numValues;
+    std::vector<QString> txtValues;
+
+    switch (attrib->getDataType())
+    {
+        case TObsNumber:
+            numValues = attrib->getNumericValues()->toStdVector();
+            qStableSort(numValues.begin(), numValues.end());
+
+            for (unsigned int i = 0; i < numValues.size(); i++)
+                txtValues.push_back(QString::number(numValues.at(i)));
+
+            break;
+
+        case TObsText:
+            txtValues = attrib->getTextValues()->toStdVector();
+            qStableSort(txtValues.begin(), txtValues.end());
+            break;
+
+        default:
+            break;
+    }
+
+    if ((txtValues.empty()) && (attrib->getType() != TObsAgent)
+            && (attrib->getType() != TObsAutomaton) && (attrib->getType() != TObsTrajectory))
+        return false;
+
+    int i = 0, count = 1, vecLegendPos = 0;
+    QString from;
+
+    QStringList & valuesList = attrib->getValueList();
+
+    for (i = 0; i < valuesList.size(); i++)
+    {
+        ObsLegend leg;
+        from = valuesList.at(i);
+
+        leg.setIdxColor((unsigned int) i);
+        leg.setFrom(from);
+        leg.setLabel(from);
+        leg.setTo(from);
+        leg.setOccurrence(0);
+        vecLegend->append(leg);
+    }
+
+    bool noValues = valuesList.isEmpty();
+
+    // conta a ocorrencia dos valores
+    for (i = 1; i <(int) txtValues.size(); i++)
+    {
+        if (txtValues.at(i - 1) == txtValues.at(i))
+        {
+            count++;
+        }
+        else
+        {
+            from = txtValues.at(i - 1);
+
+            // adiciona o item e retorna o indice
+            // caso j? contenha o item retorna o indice
+            vecLegendPos = attrib->addValueListItem(from);
+
+            // o valor nao foi informado na legenda
+            if ((!noValues) && (vecLegendPos >= vecLegend->size()))
+                break;
+
+            ObsLegend leg;
+            leg.setIdxColor(vecLegendPos);
+            leg.setFrom(from);
+            leg.setLabel(from);
+            leg.setTo(from);
+            leg.setOccurrence(count);
+
+            if (noValues)
+            {
+                vecLegend->append(leg);
+            }
+            else
+            {
+                // Override the leg in the position vecLegendPos
+                vecLegend->replace(vecLegendPos, leg);
+            }
+            count = 1;
+        }
+    }
+
+    if (!txtValues.empty())
+    {
+        // Verif. as posi??es ?ltima e pen?ltima
+        from = txtValues.at(i - 1);
+        vecLegendPos = attrib->addValueListItem(from);
+
+        ObsLegend leg;
+        leg.setIdxColor(vecLegendPos);
+        leg.setFrom(from);
+        leg.setLabel(from);
+        leg.setTo(from);
+
+        if ((i > 1) && (txtValues.at(i - 2) == txtValues.at(i - 1)))
+            leg.setOccurrence(count);
+        else
+            leg.setOccurrence(1);
+
+        // Override the leg in the position vecLegendPos
+        if (vecLegendPos < vecLegend->size())
+            vecLegend->replace(vecLegendPos, leg);
+    }
+
+    return true;
+}
+
+void LegendModel::colorUniqueValues(Attributes *attrib, const std::vector<TeColor> &colors)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    QStringList & valuesList = attrib->getValueList();
+    QStringList & labelsList = attrib->getLabelList();
+
+    for (int i = 0; i < vecLegend->size(); i++)
+    {
+        ObsLegend leg = vecLegend->at(i);
+
+        // Recupera o label na lista de labels
+        if ((labelsList.size() == vecLegend->size()) && (valuesList.size() == vecLegend->size()))
+        {
+            leg.setLabel(labelsList.at(i));
+            leg.setFrom(valuesList.at(i));
+            leg.setIdxColor(i);
+        }
+
+        if (leg.getIdxColor() < colors.size())
+        {
+            leg.setColor(colors.at(leg.getIdxColor()).red_,
+                    colors.at(leg.getIdxColor()).green_,
+                    colors.at(leg.getIdxColor()).blue_);
+        }
+
+        vecLegend->replace(i, leg);
+    }
+}
+
+// em caso de duvida ver c?digo no arquivo
+// TeQtLegendSource.cpp, linha 526, m?todo putColorOnLegend
+std::vector<TeColor> LegendModel::stdDeviationColors(Attributes *attrib,
+    std::vector<ColorBar> colorBar, std::vector<ColorBar> stdColorBar)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    std::vector<TeColor> colors;
+
+    int leftColors = 0, rightColors = 0;
+    int ii;
+    for (ii = 0; ii < vecLegend->size(); ii++)
+    {
+        if (vecLegend->at(ii).getLabel().contains(MEAN))
+            break;
+    }
+    leftColors = ii;
+    rightColors = vecLegend->size() - ii - 1;
+
+    // Corre??o de bug: divis?o por zero no m?todo getColors do TeColorUtils.cpp
+    if (leftColors == 1)
+        leftColors++;
+
+    // Corre??o de bug: divis?o por zero no m?todo getColors do TeColorUtils.cpp
+    if (rightColors == 1)
+        rightColors++;
+
+    std::vector<TeColor> leftColorVec = getColors(colorBar, leftColors);
+    std::vector<TeColor> rightColorVec = getColors(stdColorBar, rightColors);
+
+    colors.insert(colors.end(), leftColorVec.begin(), leftColorVec.end());
+
+    // a fatia da media repete a ultima cor abaixo dela
+    if (!leftColorVec.empty())
+        colors.push_back(leftColorVec.back());
+
+    colors.insert(colors.end(), rightColorVec.begin(), rightColorVec.end());
+    return colors;
+}
+
+void LegendModel::countElementsBySlices(Attributes *attrib, GroupingMode mode,
+                                        const std::vector<TeColor> &colors)
+{
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
+
+    // conta a ocorrencia dos valores em todas as fatias de uma vez;
+    // a fatia da media nao tem valores e fica vazia, mantendo a ordem
+    QVector<double> froms, tos;
+    for (int i = 0; i < vecLegend->size(); ++i)
+    {
+        const ObsLegend &leg = vecLegend->at(i);
+
+        if ((mode == TObsStdDeviation) && leg.getLabel().contains(MEAN))
+        {
+            double bound = tos.isEmpty() ? -std::numeric_limits<double>::max() : tos.last();
+            froms.append(bound);
+            tos.append(bound);
+        }
+        else
+        {
+            froms.append(leg.getFromNumber());
+            tos.append(leg.getToNumber());
+        }
+    }
+
+    QVector<int> counts;
+
+    //@RAIAN: Para a Vizinhanca
+    if (attrib->getType() == TObsNeighborhood)
+    {
+        counts.fill(0, vecLegend->size());
+
+        // Percorre o vetor de vizinhancas pegando cada uma e contando as ocorrencias dos pesos
+        QVector<QMap<QString, QList<double> > > *elements = attrib->getNeighValues();
+        QVector<QMap<QString, QList<double> > >::iterator itElem;
+
+        for (itElem = elements->begin(); itElem != elements->end(); itElem++)
+        {
+            QMap<QString, QList<double> >::iterator itNeigh;
+            for (itNeigh = itElem->begin(); itNeigh != itElem->end(); itNeigh++)
+            {
+                // Recupera o peso(posicao 2 na lista)
+                double weight = itNeigh.value().at(2);
+
+                for (int i = 0; i < froms.size(); ++i)
+                {
+                    if ((weight >= froms.at(i)) && (weight < tos.at(i)))
+                        counts[i]++;
+                }
+            }
+        }
+    }
+    //@RAIAN: FIM
+    else
+    {
+        counts = LegendStatistics::count(*attrib->getNumericValues(), froms, tos);
+    }
+
+    for (int i = 0; i < vecLegend->size(); ++i)
+    {
+        ObsLegend leg = vecLegend->at(i);
+
+        if ((counts.at(i) == 0)
+            || ((mode == TObsStdDeviation) && leg.getLabel().contains(MEAN)))
+            continue;
+
+        leg.setOccurrence(counts.at(i));
+
+        if ((mode == TObsStdDeviation) && (leg.getIdxColor() < colors.size()))
+        {
+            leg.setColor(colors.at(leg.getIdxColor()).red_,
+                    colors.at(leg.getIdxColor()).green_,
+                    colors.at(leg.getIdxColor()).blue_);
+        }
+        vecLegend->replace(i, leg);
+    }
+}
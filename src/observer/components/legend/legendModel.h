@@ -0,0 +1,154 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef OBSERVER_LEGEND_MODEL_H
+#define OBSERVER_LEGEND_MODEL_H
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <vector>
+
+#include "legendAttributes.h"
+#include "legendColorUtils.h"
+
+namespace TerraMEObserver {
+
+/**
+ * \brief Slices the legend of the observed attributes, without any widget
+ *
+ * Groups the values of each attribute in the slices of its legend and
+ * colors them, using the grouping mode, slices, precision and standard
+ * deviation defined in the attribute. The LegendWindow uses the same
+ * algorithms with the values chosen in its comboBoxes.
+ * \see Attributes, \see ObsLegend, \see LegendWindow
+ * \file legendModel.h
+ */
+class LegendModel
+{
+public:
+    /**
+     * Label of the slice that contains the mean in the standard deviation mode
+     */
+    static const QString MEAN;
+
+    /**
+     * Constructor
+     */
+    LegendModel();
+
+    /**
+     * Destructor
+     */
+    virtual ~LegendModel();
+
+    /**
+     * Sets the hash of attributes under observation
+     * \param mapAttributes a pointer to a QHash of attributes
+     * \see Attributes
+     * \see QHash, \see QString
+     */
+    void setValues(QHash<QString, Attributes*> *mapAttributes);
+
+    /**
+     * Makes the legend for every attribute
+     */
+    void makeLegend();
+
+    /**
+     * Makes the legend of an attribute according to its own parameters
+     * \param attrib a pointer to an attribute
+     */
+    static void makeLegend(Attributes *attrib);
+
+    /**
+     * Groups attribute values by equal steps
+     * \param attrib the attribute under observation
+     * \param rows the number of slices
+     * \param precision the number of decimal digits of the slices
+     * \param colors the colors of the slices, one for each row
+     */
+    static void groupByEqualStep(Attributes *attrib, int rows, int precision,
+                                 const std::vector<TeColor> &colors);
+
+    /**
+     * Groups attribute values by quantil
+     * \param attrib the attribute under observation
+     * \param rows the number of slices
+     * \param precision the number of decimal digits of the slices
+     * \param colors the colors of the slices, one for each row
+     */
+    static void groupByQuantil(Attributes *attrib, int rows, int precision,
+                               const std::vector<TeColor> &colors);
+
+    /**
+     * Groups attribute values by standard deviation. The slices are
+     * colored by countElementsBySlices
+     * \param attrib the attribute under observation
+     * \param ndev the fraction of the standard deviation of each slice
+     * \param precision the number of decimal digits of the slices
+     */
+    static void groupByStdDeviation(Attributes *attrib, double ndev, int precision);
+
+    /**
+     * Groups attribute values by unique value. The slices are
+     * colored by colorUniqueValues
+     * \param attrib the attribute under observation
+     * \return boolean, \a false if the attribute does not have values
+     * to be grouped
+     */
+    static bool groupByUniqueValue(Attributes *attrib);
+
+    /**
+     * Sets the labels and the colors of the slices grouped by unique value
+     * \param attrib the attribute under observation
+     * \param colors the colors of the slices
+     */
+    static void colorUniqueValues(Attributes *attrib, const std::vector<TeColor> &colors);
+
+    /**
+     * Creates the colors of the slices grouped by standard deviation:
+     * \a colorBar below the mean and \a stdColorBar above it
+     * \param attrib the attribute under observation
+     * \param colorBar the colorBar of the attribute
+     * \param stdColorBar the standard deviation colorBar of the attribute
+     */
+    static std::vector<TeColor> stdDeviationColors(Attributes *attrib,
+        std::vector<ColorBar> colorBar, std::vector<ColorBar> stdColorBar);
+
+    /**
+     * Counts the elements number by legend slices
+     * \param attrib the attribute under observation
+     * \param mode the grouping mode of the slices
+     * \param colors the colors of the slices grouped by standard deviation
+     */
+    static void countElementsBySlices(Attributes *attrib, GroupingMode mode,
+                                      const std::vector<TeColor> &colors);
+
+private:
+    QHash<QString, Attributes*> *mapAttributes;
+};
+
+} // namespace TerraMEObserver
+
+#endif // OBSERVER_LEGEND_MODEL_H
@@ -0,0 +1,187 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "legendStatistics.h"
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+using namespace TerraMEObserver;
+
+namespace {
+
+// Numero de acumuladores independentes, para o compilador vetorizar o laco
+const int LANES = 4;
+
+/**
+ * Selects the sorted positions [pos, posEnd) of the range [first, last),
+ * partitioning around the middle position and recursing on each side.
+ */
+void select(double *base, double *first, double *last, const int *pos, const int *posEnd)
+{
+    if ((pos == posEnd) || (first >= last))
+        return;
+
+    const int *mid = pos + (posEnd - pos) / 2;
+    double *nth = base + *mid;
+
+    std::nth_element(first, nth, last);
+
+    select(base, first, nth, pos, mid);
+    select(base, nth + 1, last, mid + 1, posEnd);
+}
+
+} // namespace
+
+LegendStatistics::Summary LegendStatistics::summarize(const QVector<double> &values)
+{
+    Summary summary;
+    summary.count = values.size();
+    summary.min = 0;
+    summary.max = 0;
+    summary.mean = 0;
+    summary.stdDev = 0;
+
+    if (values.isEmpty())
+        return summary;
+
+    const double *v = values.constData();
+    int size = values.size();
+
+    double mins[LANES], maxs[LANES], sums[LANES], squares[LANES];
+    for (int j = 0; j < LANES; j++)
+    {
+        mins[j] = v[0];
+        maxs[j] = v[0];
+        sums[j] = 0;
+        squares[j] = 0;
+    }
+
+    int i = 0;
+    for (; i + LANES <= size; i += LANES)
+    {
+        for (int j = 0; j < LANES; j++)
+        {
+            double x = v[i + j];
+            mins[j] = x < mins[j] ? x : mins[j];
+            maxs[j] = x > maxs[j] ? x : maxs[j];
+            sums[j] += x;
+            squares[j] += x * x;
+        }
+    }
+
+    for (; i < size; i++)
+    {
+        double x = v[i];
+        mins[0] = x < mins[0] ? x : mins[0];
+        maxs[0] = x > maxs[0] ? x : maxs[0];
+        sums[0] += x;
+        squares[0] += x * x;
+    }
+
+    double sum = 0, sm2 = 0;
+    summary.min = mins[0];
+    summary.max = maxs[0];
+    for (int j = 0; j < LANES; j++)
+    {
+        summary.min = std::min(summary.min, mins[j]);
+        summary.max = std::max(summary.max, maxs[j]);
+        sum += sums[j];
+        sm2 += squares[j];
+    }
+
+    summary.mean = sum / size;
+
+    double var = (sm2 / size) - (summary.mean * summary.mean);
+    summary.stdDev = var > 0 ? sqrt(var) : 0;
+
+    return summary;
+}
+
+QVector<double> LegendStatistics::quantiles(const QVector<double> &values, const QVector<int> &positions)
+{
+    QVector<double> result;
+    if (values.isEmpty())
+        return result;
+
+    std::vector<int> sorted(positions.constBegin(), positions.constEnd());
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::vector<double> copy(values.constBegin(), values.constEnd());
+    double *base = &copy[0];
+
+    select(base, base, base + copy.size(), &sorted[0], &sorted[0] + sorted.size());
+
+    result.reserve(positions.size());
+    for (int i = 0; i < positions.size(); i++)
+        result.append(copy[positions.at(i)]);
+
+    return result;
+}
+
+QVector<int> LegendStatistics::count(const QVector<double> &values, const QVector<double> &froms,
+                                     const QVector<double> &tos)
+{
+    int slices = froms.size();
+    QVector<int> counts(slices, 0);
+
+    const double *v = values.constData();
+    int size = values.size();
+
+    bool disjoint = true;
+    for (int s = 1; s < slices; s++)
+    {
+        if (!(tos.at(s - 1) <= froms.at(s)) || !(froms.at(s - 1) <= tos.at(s - 1)))
+            disjoint = false;
+    }
+
+    if (disjoint && (slices > 0))
+    {
+        // uma unica passada: busca binaria pelo limite inferior de cada valor
+        const double *first = froms.constData();
+        const double *last = first + slices;
+
+        for (int i = 0; i < size; i++)
+        {
+            int s = int(std::upper_bound(first, last, v[i]) - first) - 1;
+            if ((s >= 0) && (v[i] < tos.at(s)))
+                counts[s]++;
+        }
+        return counts;
+    }
+
+    for (int s = 0; s < slices; s++)
+    {
+        double from = froms.at(s);
+        double to = tos.at(s);
+        int n = 0;
+
+        for (int i = 0; i < size; i++)
+            n += (v[i] >= from) & (v[i] < to);
+
+        counts[s] = n;
+    }
+    return counts;
+}
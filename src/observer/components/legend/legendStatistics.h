@@ -0,0 +1,86 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef OBSERVER_LEGEND_STATISTICS_H
+#define OBSERVER_LEGEND_STATISTICS_H
+
+#include <QtCore/QVector>
+
+namespace TerraMEObserver {
+
+/**
+ * \brief Statistics used to slice the legend of an Attributes
+ *
+ * Works directly on the contiguous array of numeric values of the
+ * attribute. The summary is computed in a single pass with independent
+ * accumulators that the compiler can vectorize, quantiles are selected
+ * with std::nth_element instead of sorting all the values, and the
+ * elements of every slice are counted in a single pass when the slices
+ * are disjoint.
+ * \see LegendModel, \see Attributes
+ * \file legendStatistics.h
+ */
+class LegendStatistics
+{
+public:
+    /**
+     * Minimum, maximum, mean and standard deviation of a set of values
+     */
+    struct Summary
+    {
+        int count;
+        double min;
+        double max;
+        double mean;
+        double stdDev;
+    };
+
+    /**
+     * Computes the summary of \a values in a single pass
+     * \param values the numeric values of an attribute
+     */
+    static Summary summarize(const QVector<double> &values);
+
+    /**
+     * Gets the values that would be in the given \a positions if
+     * \a values were sorted, without sorting them
+     * \param values the numeric values of an attribute, they are not changed
+     * \param positions positions between zero and the number of values minus one
+     * \return the selected values, in the same order of \a positions
+     */
+    static QVector<double> quantiles(const QVector<double> &values, const QVector<int> &positions);
+
+    /**
+     * Counts the values that belong to each slice [\a froms[i], \a tos[i])
+     * \param values the numeric values of an attribute
+     * \param froms the lower bounds of the slices
+     * \param tos the upper bounds of the slices, with the same size of \a froms
+     * \return the number of values in each slice
+     */
+    static QVector<int> count(const QVector<double> &values, const QVector<double> &froms,
+                              const QVector<double> &tos);
+};
+
+} // namespace TerraMEObserver
+
+#endif // OBSERVER_LEGEND_STATISTICS_H
@@ -22,6 +22,7 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "legendWindow.h"
+#include "legendModel.h"
 #include "core/LuaSystem.h"
 
 class ObsLegend;
@@ -42,8 +43,6 @@ class ObsLegend;
 extern lua_State * L;
 extern ExecutionModes execModes;
 
-static const QString MEAN = "mean";
-
 using namespace TerraMEObserver;
 
 LegendWindow::LegendWindow(QWidget *parent)
@@ -543,209 +542,68 @@ void LegendWindow::createColorVector()
     if (teColorVec)
         delete teColorVec;
     teColorVec = new std::vector<TeColor>();
-    std::vector<TeColor> leftColorVec;
 
     if (rows == 1)
         rows++;
 
     if (groupingModeComboBox->currentIndex() != TObsStdDeviation)
     {
-        leftColorVec = getColors(colorVec, rows);
-
-        for (unsigned i = 0; i < leftColorVec.size(); ++i)
-            teColorVec->push_back(leftColorVec.at(i));
+        *teColorVec = getColors(colorVec, rows);
     }
     else	// desvio padr?o
     {
         Attributes *attrib = mapAttributes->value(attributesComboBox->currentText());
-        QVector<ObsLegend> *vecLegend = attrib->getLegend();
-
-        int leftColors = 0, rightColors = 0;
-        int ii;
-        for (ii = 0; ii < vecLegend->size(); ii++)
-        {
-            if (vecLegend->at(ii).getLabel().contains(MEAN))
-                break;
-        }
-        leftColors = ii;
-        rightColors = vecLegend->size() - ii - 1;
-
-        // Corre??o de bug: divis?o por zero no m?todo getColors do TeColorUtils.cpp
-        if (leftColors == 1)
-            leftColors++;
-
-        // Corre??o de bug: divis?o por zero no m?todo getColors do TeColorUtils.cpp
-        if (rightColors == 1)
-            rightColors++;
-
-        leftColorVec = getColors(colorVec, leftColors);
-        std::vector<TeColor> rightColorVec = getColors(stdColorVec, rightColors);
-		std::cout << "legendWindow " << 3 << std::endl;
-        unsigned ui;
-
-        for (ui = 0; ui < leftColorVec.size(); ++ui)
-            teColorVec->push_back(leftColorVec.at(ui));
-
-        // if (ui > 0)
-        teColorVec->push_back(leftColorVec.at(ui-1));
-
-        for (ui = 0; ui < rightColorVec.size(); ++ui)
-            teColorVec->push_back(rightColorVec.at(ui));
+        *teColorVec = LegendModel::stdDeviationColors(attrib, colorVec, stdColorVec);
     }
 }
 
 void LegendWindow::countElementsBySlices()
 {
-    QVector<double>::iterator it;
-    double from, to;
-    int occurrence;
-
     QAbstractItemModel *model = legendTable->model();
 
     Attributes *attrib = mapAttributes->value(attributesComboBox->currentText());
-    QVector<double> *values = attrib->getNumericValues();
+    GroupingMode mode = (GroupingMode) groupingModeComboBox->currentIndex();
+
+    LegendModel::countElementsBySlices(attrib, mode, *teColorVec);
+
     QVector<ObsLegend> *vecLegend = attrib->getLegend();
     legendTable->setRowCount(vecLegend->size());
 
-    if (groupingModeComboBox->currentIndex() == TObsStdDeviation)  // desvio padr?o
+    for (int i = 0; i < vecLegend->size(); ++i)
     {
-        for (int i = 0; i < vecLegend->size(); ++i)
-        {
-            ObsLegend leg = vecLegend->at(i);
-            occurrence = 0;
-            from = leg.getFromNumber();
-            to = leg.getToNumber();
+        const ObsLegend &leg = vecLegend->at(i);
 
-            if (!leg.getLabel().contains(MEAN))
+        if ((mode == TObsStdDeviation) && leg.getLabel().contains(LegendModel::MEAN))
+        {
+            model->setData(model->index(i, 0, QModelIndex()), QString(""),
+                        Qt::DecorationRole); // N?o exibe a cor
+            model->setData(model->index(i, 4, QModelIndex()), QString(""),
+                        Qt::DisplayRole);
+        }
+        else
+        {
+            //@RAIAN: Para a Vizinhanca
+            if (attrib->getType() == TObsNeighborhood)
             {
-                // conta a ocorrencia dos mesmos valores
-                for (it = values->begin(); it != values->end(); ++it)
-                {
-                    if (*it >= from && *it < to)
-                    {
-                        occurrence++;
-                        leg.setOccurrence(occurrence);
-                        leg.setColor(teColorVec->at(leg.getIdxColor()).red_,
-                                teColorVec->at(leg.getIdxColor()).green_,
-                                teColorVec->at(leg.getIdxColor()).blue_);
-						std::cout << "legendWindow " << 4 << std::endl;
-                        vecLegend->replace(i, leg);
-                    }
-                }
-
-                model->setData(model->index(i, 0, QModelIndex()), color2Pixmap(leg.getColor()),
-                            Qt::DecorationRole);
-                model->setData(model->index(i, 4, QModelIndex()), leg.getOcurrence(),
-                            Qt::DisplayRole);
+                model->setData(model->index(i, 0, QModelIndex()),
+                            color2PixmapLine(leg.getColor(), attrib->getWidth()), Qt::DecorationRole);
             }
             else
             {
-                model->setData(model->index(i, 0, QModelIndex()), QString(""),
-                            Qt::DecorationRole); // N?o exibe a cor
-                model->setData(model->index(i, 4, QModelIndex()), QString(""),
-                            Qt::DisplayRole);
+                model->setData(model->index(i, 0, QModelIndex()), color2Pixmap(leg.getColor()),
+                            Qt::DecorationRole);
             }
-            // exibe na tabela
-            model->setData(model->index(i, 1, QModelIndex()), leg.getFrom(),
-                        Qt::DisplayRole);
-            model->setData(model->index(i, 2, QModelIndex()), leg.getTo(),
+            model->setData(model->index(i, 4, QModelIndex()), leg.getOcurrence(),
                         Qt::DisplayRole);
-            model->setData(model->index(i, 3, QModelIndex()), leg.getLabel(),
-                           Qt::DisplayRole);
-        }
-    }
-    else
-    {
-        for (int i = 0; i < vecLegend->size(); ++i)
-        {
-            ObsLegend leg = vecLegend->at(i);
-            occurrence = 0;
-            from = leg.getFromNumber();
-            to = leg.getToNumber();
-
-            // conta a ocorrencia dos mesmos valores
-			//@RAIAN: Para a Vizinhanca
-			if (attrib->getType() == TObsNeighborhood)
-			{
-				// Pega o vetor de vizinhancas
-				QVector<QMap<QString, QList<double> > > *elements = attrib->getNeighValues();
-				QVector<QMap<QString, QList<double> > >::iterator itElem;
-
-				// Percorre o vetor de vizinhancas pegando cada uma e contando as ocorrencias dos pesos
-				for (itElem = elements->begin(); itElem != elements->end(); itElem++)
-				{
-					QMap<QString, QList<double> >::iterator itNeigh;
-					for (itNeigh = itElem->begin(); itNeigh != itElem->end(); itNeigh++)
-					{
-						// Recupera o peso(posicao 2 na lista)
-						double weight = itNeigh.value().at(2);
-						// verifica se o peso est? dentro do intervalo e incrementa o contador
-						if (weight >= from && weight < to)
-						{
-							occurrence++;
-							leg.setOccurrence(occurrence);
-							vecLegend->replace(i, leg);
-						}
-					}
-				}
-
-				// exibe na tabela
-				model->setData(model->index(i, 0, QModelIndex()), color2PixmapLine(leg.getColor(), attrib->getWidth()),
-					Qt::DecorationRole);
-
-				model->setData(model->index(i, 1, QModelIndex()), leg.getFrom(),
-					Qt::DisplayRole);
-				model->setData(model->index(i, 2, QModelIndex()), leg.getTo(),
-					Qt::DisplayRole);
-				model->setData(model->index(i, 3, QModelIndex()), leg.getLabel(),
-					Qt::DisplayRole);
-				model->setData(model->index(i, 4, QModelIndex()), leg.getOcurrence(),
-					Qt::DisplayRole);
-			}
-			//@RAIAN: FIM
-			else
-			{
-				for (it = values->begin(); it != values->end(); ++it)
-				{
-					if (*it >= from && *it < to)
-					{
-						occurrence++;
-						leg.setOccurrence(occurrence);
-						vecLegend->replace(i, leg);
-					}
-				}
-				// exibe na tabela
-				model->setData(model->index(i, 0, QModelIndex()), color2Pixmap(leg.getColor()),
-							   Qt::DecorationRole);
-
-				model->setData(model->index(i, 1, QModelIndex()), leg.getFrom(),
-							   Qt::DisplayRole);
-				model->setData(model->index(i, 2, QModelIndex()), leg.getTo(),
-							   Qt::DisplayRole);
-				model->setData(model->index(i, 3, QModelIndex()), leg.getLabel(),
-							   Qt::DisplayRole);
-				model->setData(model->index(i, 4, QModelIndex()), leg.getOcurrence(),
-							   Qt::DisplayRole);
-			}
         }
 
-        // Apresenta o item "does not belong"
-        //if (attrib->getType() == TObsTrajectory)
-        //{
-        //    int row = legendTable->rowCount() + 1;
-        //    legendTable->setRowCount(row);
-
-        //    model->setData(model->index(row - 1, 0, QModelIndex()), color2Pixmap(Qt::white),
-        //                   Qt::DecorationRole);	// color
-        //    model->setData(model->index(row - 1, 1, QModelIndex()), "-",
-        //                   Qt::DisplayRole);		// from
-        //    model->setData(model->index(row - 1, 2, QModelIndex()), "-",
-        //                   Qt::DisplayRole);		// to
-        //    model->setData(model->index(row - 1, 3, QModelIndex()), TRAJECTORY_LABEL,
-        //                   Qt::DisplayRole);		// label
-        //    model->setData(model->index(row - 1, 4, QModelIndex()), TRAJECTORY_COUNT,
-        //                   Qt::DisplayRole);	// count
-        //}
+        // exibe na tabela
+        model->setData(model->index(i, 1, QModelIndex()), leg.getFrom(),
+                    Qt::DisplayRole);
+        model->setData(model->index(i, 2, QModelIndex()), leg.getTo(),
+                    Qt::DisplayRole);
+        model->setData(model->index(i, 3, QModelIndex()), leg.getLabel(),
+                       Qt::DisplayRole);
     }
 }
 
@@ -754,28 +612,27 @@ void LegendWindow::groupingAttribute(Attributes *attrib)
     attrib->setColorBar(frameTeQtColorBar->getInputColorVec());
     attrib->setStdColorBar(frameTeQtStdColorBar->getInputColorVec());
 
-    // corre??o para mais e para menos...
-    double fix = pow(10, precisionComboBox->currentText().toDouble());
-    fix = 1 / fix;
+    int precision = precisionComboBox->currentText().toInt();
 
     // m?todos baseado no terraView
     switch (groupingModeComboBox->currentIndex())
     {
         case 0: // TObsEqualSteps
             // ver m?todo TeGroupByEqualStep em TeGroupingAlgorithms.(h, cpp)
-            groupByEqualStep(fix, attrib);
+            LegendModel::groupByEqualStep(attrib, rows, precision, *teColorVec);
             countElementsBySlices();
             break;
 
         case 1: // TObsQuantil
             // ver m?todo TeGroupByQuantil em TeGroupingAlgorithms.(h, cpp)
-            groupByQuantil(fix, attrib);
+            LegendModel::groupByQuantil(attrib, rows, precision, *teColorVec);
             countElementsBySlices();
             break;
 
         case 2: // TObsStdDeviation
             // ver m?todo TeGroupByStdDev em TeGroupingAlgorithms.(h, cpp)
-            groupByStdDeviation(fix, attrib);
+            LegendModel::groupByStdDeviation(attrib,
+                stdDevComboBox->currentText().toDouble(), precision);
             createColorVector();
             countElementsBySlices();
             break;
@@ -784,250 +641,7 @@ void LegendWindow::groupingAttribute(Attributes *attrib)
         case 3:
         default:
             // ver m?todo TeGroupByUniqueValue em TeGroupingAlgorithms.(h, cpp)
-            groupByUniqueValue(fix, attrib);
-    }
-}
-
-void LegendWindow::groupByEqualStep(double fix, Attributes *attrib)
-{
-    QVector<ObsLegend> *vecLegend = attrib->getLegend();
-    vecLegend->clear();
-
-    int precision = precisionComboBox->currentText().toInt();
-
-    double maxValue = attrib->getMaxValue();
-    double minValue = attrib->getMinValue();
-    double slice =(maxValue - minValue) /(rows * 1.0);
-
-    for (int row = 0; row < rows; ++row)
-    {
-        QString from, to;
-
-        if ((row != 0) && (row != rows - 1))
-        {
-            from = QString("%1").arg(minValue + double(row) * slice,
-                                     0, 'f', precision);
-            to = QString("%1").arg(minValue + double(row + 1) * slice,
-                                   0, 'f', precision);
-        }
-        else // Corrige a legenda para o primeiro e ultimo valor
-        {
-            if (row == 0)
-            {
-                from = QString("%1").arg(minValue + double(row) * slice - fix,
-                                         0, 'f', precision);
-                to = QString("%1").arg(minValue + double(row + 1) * slice,
-                                       0, 'f', precision);
-            }
-            else
-            {
-                from = QString("%1").arg(minValue + double(row) * slice,
-                                         0, 'f', precision);
-                to = QString("%1").arg(minValue + double(row + 1) * slice  + fix,
-                                       0, 'f', precision);
-            }
-        }
-
-        QString label = QString("%1 ~ %2").arg(from).arg(to);
-
-        ObsLegend leg;
-        leg.setFrom(from);
-        leg.setTo(to);
-        leg.setLabel(label);
-        leg.setOccurrence(0);
-
-        // recupera a cor j? dividida entre os slices
-        leg.setColor(teColorVec->at(row).red_,
-                teColorVec->at(row).green_,
-                teColorVec->at(row).blue_);
-
-        vecLegend->append(leg);
-    }
-}
-
-void LegendWindow::groupByQuantil(double fix, Attributes *attrib)
-{
-    QVector<ObsLegend> *vecLegend = attrib->getLegend();
-    vecLegend->clear();
-
-    // Causava modifica??es permanentes na estrutura, fato que
-    // gerava discord?ncia nos dados ap?s altera??es na legenda
-    // quando feitas depois do t?rmino do modelo
-    //QVector<double> *values = attrib->getNumericValues();
-    std::vector<double> values = attrib->getNumericValues()->toStdVector();
-    qStableSort(values.begin(), values.end());
-
-    int precision = precisionComboBox->currentText().toInt();
-
-    double step = values.size() /(rows * 1.0);
-
-    int	n = 0;
-    std::vector<double>::iterator it = values.begin();
-
-#ifdef DEBUB_OBSERVER
-    qDebug() << "values.end(): " << values.size();
-    qDebug() << "teColorVec->size(): " << teColorVec->size();
-    qDebug() << "step: " << step;
-#endif
-
-    while (it < values.end())
-    {
-        QString from;
-
-        if (it == values.begin())
-            from = QString("%1").arg(*it - fix , 0, 'f', precision);
-        else
-            from = QString("%1").arg(*it, 0, 'f', precision);
-
-        int p =(int)(step *(double)++n + 0.5);
-        it = values.begin() + p;
-
-        QString to;
-        if (it < values.end())
-        {
-            to = QString("%1").arg(*it, 0, 'f', precision);
-        }
-        else
-        {
-            if (it != values.end())
-                to = QString("%1").arg(*(it-1), 0, 'f', precision);
-            else
-                to = QString("%1").arg(*(it-1) + fix , 0, 'f', precision);
-        }
-
-        QString label = QString("%1 ~ %2").arg(from).arg(to);
-
-        ObsLegend leg;
-        leg.setFrom(from);
-        leg.setTo(to);
-        leg.setLabel(label);
-        leg.setOccurrence(0);
-
-        // recupera a cor j? dividida entre os slices
-        // n - 1 pq o "n" ? pre-incrementado(++n)
-        leg.setColor(teColorVec->at(n - 1).red_,
-                teColorVec->at(n - 1).green_,
-                teColorVec->at(n - 1).blue_);
-        vecLegend->append(leg);
-    }
-}
-
-void LegendWindow::groupByStdDeviation(double fix, Attributes *attrib)
-{
-    // Compute mim, max and mean
-	double	min = FLT_MAX;
-	double	max = FLT_MIN;
-    float	sum = 0.0, sm2 = 0.0;
-
-    QVector<double>* values = attrib->getNumericValues();
-    QVector<double>::iterator it = values->begin();
-
-    while (it < values->end())
-    {
-        min = MIN(min, *it);
-        max = MAX(max, *it);
-        sum +=(*it);
-        sm2 +=((*it) *(*it));
-        it++;
-    }
-
-    double cont =(double) values->size();
-    double mean = sum / cont;
-    long double var =(sm2 / cont) -(mean * mean);
-    double sdev = sqrt(var);
-
-    double ndev = stdDevComboBox->currentText().toDouble();
-    int precision = precisionComboBox->currentText().toInt();
-
-    double slice = sdev * ndev;
-    double val = mean;
-    int idxColor = 0;
-
-    QString strMean = QString("%1").arg(mean , 0, 'f', precision);
-
-    QVector<ObsLegend> *vecLegend = attrib->getLegend();
-    QVector<ObsLegend> *auxVecLegend = new QVector<ObsLegend>();
-    vecLegend->clear();
-    auxVecLegend->clear();
-
-    while (val - slice > min - slice)
-    {
-        double v = val - slice;
-
-        ObsLegend leg;
-        leg.setFrom(QString("%1").arg(v, 0, 'f', precision));
-        leg.setTo(QString("%1").arg(val, 0, 'f', precision));
-        leg.setLabel(QString("%1 ~ %2").arg(leg.getFrom()).arg(leg.getTo()));
-
-        auxVecLegend->append(leg);
-        val = v;
-    }
-
-    if (auxVecLegend->size())
-    {
-        for (int i = auxVecLegend->size() - 1; i >= 0; i--)
-        {
-            ObsLegend leg = auxVecLegend->at(i);
-
-            leg.setIdxColor(idxColor);
-            idxColor++;
-            vecLegend->append(leg);
-        }
-    }
-
-    QString media = QString("%1 = %2").arg(MEAN).arg(strMean);
-
-    ObsLegend leg;
-    leg.setFrom(media);
-    leg.setTo("");
-    leg.setLabel(media);
-
-    leg.setIdxColor(idxColor);
-    idxColor++;
-
-    vecLegend->append(leg);
-
-    val = mean;
-    while (val + slice < max + slice)
-    {
-        double v = val + slice;
-
-        ObsLegend leg;
-        leg.setFrom(QString("%1").arg(val, 0, 'f', precision));
-        leg.setTo(QString("%1").arg(v, 0, 'f', precision));
-        leg.setLabel(QString("%1 ~ %2")
-                      .arg(leg.getFrom()).arg(leg.getTo()));
-
-        leg.setIdxColor(idxColor);
-        idxColor++;
-
-        vecLegend->append(leg);
-        val = v;
-    }
-
-    if (vecLegend->size() > 2)
-    {
-        // Corrige o valor minimo
-        ObsLegend leg = vecLegend->at(0);
-        leg.setFrom(QString("%1").arg(min - fix, 0, 'f', precision));
-
-        if (!leg.getFrom().contains(MEAN))
-        {
-            leg.setLabel(QString("%1 ~ %2")
-                          .arg(leg.getFrom()).arg(leg.getTo()));
-        }
-        vecLegend->replace(0, leg);
-
-        // Corrige o valor maximo
-        leg = vecLegend->at(vecLegend->size() - 1);
-        leg.setTo(QString("%1").arg(max + fix, 0, 'f', precision));
-
-        if (!leg.getFrom().contains(MEAN))
-        {
-            leg.setLabel(QString("%1 ~ %2")
-                          .arg(leg.getFrom()).arg(leg.getTo()));
-        }
-        vecLegend->replace(vecLegend->size() - 1, leg);
+            groupByUniqueValue(attrib);
     }
 }
 
@@ -1273,42 +887,9 @@ void LegendWindow::groupByStdDeviation(double fix, Attributes *attrib)
 //    //}
 //}
 
-void LegendWindow::groupByUniqueValue(double /*fix*/, Attributes *attrib)
+void LegendWindow::groupByUniqueValue(Attributes *attrib)
 {
-    // Correcao do bug apresentado quando se altera a posicao
-    // das cores definidas na legenda pois os resultados do map/image
-    // s?o diferentes(Ticket 85).
-    // if (attrib->getDataType() == TObsNumber)
-    //      attrib->getValueList().clear();
-
-    QVector<ObsLegend> *vecLegend = attrib->getLegend();
-    vecLegend->clear();
-
-    std::vector<double> numValues;
-    std::vector<QString> txtValues;
-
-    switch (attrib->getDataType())
-    {
-        case TObsNumber:
-            numValues = attrib->getNumericValues()->toStdVector();
-            qStableSort(numValues.begin(), numValues.end());
-
-            for (unsigned int i = 0; i < numValues.size(); i++)
-                txtValues.push_back(QString::number(numValues.at(i)));
-
-            break;
-
-        case TObsText:
-            txtValues = attrib->getTextValues()->toStdVector();
-            qStableSort(txtValues.begin(), txtValues.end());
-            break;
-
-        default:
-            break;
-    }
-
-    if ((txtValues.empty()) && (attrib->getType() != TObsAgent)
-            && (attrib->getType() != TObsAutomaton) && (attrib->getType() != TObsTrajectory))
+    if (!LegendModel::groupByUniqueValue(attrib))
     {
         QString msg;
         msg = tr("The \"%1\" attribute has been configured incorrectly. An error might "
@@ -1329,164 +910,20 @@ void LegendWindow::groupByUniqueValue(double /*fix*/, Attributes *attrib)
         return;
     }
 
-    int i = 0, count = 1, vecLegendPos = 0;
-    QString from;
-
-    QStringList & valuesList = attrib->getValueList();
-
-    for (i = 0; i < valuesList.size(); i++)
-    {
-        ObsLegend leg;
-        from = valuesList.at(i);
-
-        leg.setIdxColor((unsigned int) i);
-        leg.setFrom(from);
-        leg.setLabel(from);
-        leg.setTo(from);
-        leg.setOccurrence(0);
-        vecLegend->append(leg);
-    }
-
-    bool noValues = valuesList.isEmpty();
-
-    // conta a ocorrencia dos valores
-    for (i = 1; i < txtValues.size(); i++)
-    {
-        if (txtValues.at(i - 1) == txtValues.at(i))
-        {
-            count++;
-        }
-        else
-        {
-            from = txtValues.at(i - 1);
-
-            // adiciona o item e retorna o indice
-            // caso j? contenha o item retorna o indice
-            vecLegendPos = attrib->addValueListItem(from);
-
-            if ((!noValues) && (vecLegendPos >= vecLegend->size()))
-            {
-/* 
-               QString msg;
-                msg = tr("Was found the value \"%1\" in the model but it was not reported in the legend for "
-                    "\"%2\". Please, check the legend for this attribute.")
-                    .arg(from).arg(attrib->getName());
-				cout << vecLegendPos << endl;
-                
-                if (isVisible())
-                {
-                    QMessageBox::information(this, windowTitle(), msg);
-                }
-                else
-                {
-                    if (execModes != Quiet)
-                    {
-                        qWarning("Warning: %s", qPrintable(msg));
-                    }
-                }
-*/
-                break;
-            }
-
-            ObsLegend leg;
-            leg.setIdxColor(vecLegendPos);
-            leg.setFrom(from);
-            leg.setLabel(from);
-            leg.setTo(from);
-            leg.setOccurrence(count);
-
-            if (noValues)
-            {
-                vecLegend->append(leg);
-            }
-            else
-            {
-                // Override the leg in the position vecLegendPos
-                vecLegend->replace(vecLegendPos, leg);
-            }
-            count = 1;
-        }
-    }
-
-    //qDebug() << "i: " << i;
-    //qDebug() << "txtValues.size(): " << txtValues.size();
-    //qDebug() << "(i-2): " << txtValues.at(i - 2) << "(i-1): " << txtValues.at(i - 1);
-
-    if (!txtValues.empty())
-    {
-        // Verif. as posi??es ?ltima e pen?ltima
-        if ((i > 1) && (txtValues.at(i - 2) == txtValues.at(i - 1)))
-        {
-            from = txtValues.at(i - 1);
-            vecLegendPos = attrib->addValueListItem(from);
-
-            ObsLegend leg;
-            leg.setIdxColor(vecLegendPos);
-            leg.setFrom(from);
-            leg.setLabel(from);
-            leg.setTo(from);
-            leg.setOccurrence(count);
-
-            // Override the leg in the position vecLegendPos
-            if (vecLegendPos < vecLegend->size())
-                vecLegend->replace(vecLegendPos, leg);
-        }
-        else
-        {
-            from = txtValues.at(i - 1);
-            vecLegendPos = attrib->addValueListItem(from);
-
-            ObsLegend leg;
-            leg.setIdxColor(vecLegendPos);
-            leg.setFrom(from);
-            leg.setLabel(from);
-            leg.setTo(from);
-            leg.setOccurrence(1);
-
-            if (vecLegendPos < vecLegend->size())
-            {
-                vecLegend->replace(vecLegendPos, leg);
-            }
-            //else
-            //{
-            //    // qWarning() << "out of range -- " << from;
-            //    leg.setLabel("out of range");
-
-            //    vecLegend->push_back(leg);
-            //    rows++;
-            //    createView(rows);
-            //}
-        }
-    }
+    QVector<ObsLegend> *vecLegend = attrib->getLegend();
 
     rows = vecLegend->size();
     createView(rows);
     createColorVector();
 
+    LegendModel::colorUniqueValues(attrib, *teColorVec);
+
     // Mostra na GUI os valores encontrados
     QAbstractItemModel *model = legendTable->model();
 
-    QStringList & labelsList = attrib->getLabelList();
-
-    for (i = 0; i <(unsigned int) vecLegend->size(); i++)
+    for (int i = 0; i < vecLegend->size(); i++)
     {
-        ObsLegend leg = vecLegend->at(i);
-        QColor color;
-
-        // Recupera o label na lista de labels
-        if ((labelsList.size() == vecLegend->size()) && (valuesList.size() == vecLegend->size()))
-        {
-            leg.setLabel(labelsList.at(i));
-            leg.setFrom(valuesList.at(i));
-            leg.setIdxColor(i);
-        }
-
-        if (leg.getIdxColor() < teColorVec->size())
-        {
-            leg.setColor(teColorVec->at(leg.getIdxColor()).red_,
-                    teColorVec->at(leg.getIdxColor()).green_,
-                    teColorVec->at(leg.getIdxColor()).blue_);
-        }
+        const ObsLegend &leg = vecLegend->at(i);
 
         model->setData(model->index(i, 0, QModelIndex()), color2Pixmap(leg.getColor()),
                        Qt::DecorationRole);	// color
@@ -1496,22 +933,7 @@ void LegendWindow::groupByUniqueValue(double /*fix*/, Attributes *attrib)
                        Qt::DisplayRole);		// label
         model->setData(model->index(i, 3, QModelIndex()), leg.getOcurrence(),
                        Qt::DisplayRole);	// count
-
-        vecLegend->replace(i, leg);
     }
-
-    // Apresenta o item "does not belong" na legenda
-    //if (attrib->getType() == TObsTrajectory)
-    //{
-    //    model->setData(model->index(rows - 1, 0, QModelIndex()), color2Pixmap(Qt::white),
-    //                   Qt::DecorationRole);	// color
-    //    model->setData(model->index(rows - 1, 1, QModelIndex()), "-",
-    //                   Qt::DisplayRole);		// value
-    //    model->setData(model->index(rows - 1, 2, QModelIndex()), TRAJECTORY_LABEL,
-    //                   Qt::DisplayRole);		// label
-    //    model->setData(model->index(rows - 1, 3, QModelIndex()), TRAJECTORY_COUNT,
-    //                   Qt::DisplayRole);	// count
-    //}
 }
 
 void LegendWindow::rollbackChanges(const QString & name)
@@ -259,32 +259,11 @@ private:
     void groupingAttribute(Attributes *attrib);
 
     /**
-     * Groups attribute values by equal steps
-     * \param fix correction for every slice of the legend
+     * Groups attribute values by unique value and shows them in the table
      * \param attrib the attribute under observation
+     * \see LegendModel::groupByUniqueValue
      */
-    void groupByEqualStep(double fix, Attributes *attrib);
-
-    /**
-     * Groups attribute values by quantil
-     * \param fix correction for every slice of the legend
-     * \param attrib the attribute under observation
-     */
-    void groupByQuantil(double fix, Attributes *attrib);
-
-    /**
-     * Groups attribute values by standard deviation
-     * \param fix correction for every slice of the legend
-     * \param attrib the attribute under observation
-     */
-    void groupByStdDeviation(double fix, Attributes *attrib);
-
-    /**
-     * Groups attribute values by unique value
-     * \param fix correction for every slice of the legend
-     * \param attrib the attribute under observation
-     */
-    void groupByUniqueValue(double fix, Attributes *attrib);
+    void groupByUniqueValue(Attributes *attrib);
 
     /**
      * Saves the attributes under observation in the legend.tol file
@@ -0,0 +1,186 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "frameWriter.h"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <cstdlib>
+
+#include "terrameGlobals.h"
+
+extern ExecutionModes execModes;
+
+using namespace TerraMEObserver;
+
+// Numero maximo de quadros aguardando para serem escritos
+static const int MAX_QUEUED_FRAMES = 16;
+static const int JPEG_QUALITY = 90;
+
+static FrameWriter *writer = 0;
+
+FrameWriter & FrameWriter::getInstance()
+{
+    if (!writer)
+    {
+        writer = new FrameWriter();
+        writer->start(QThread::LowPriority);
+        atexit(FrameWriter::stop);
+    }
+    return *writer;
+}
+
+FrameWriter::FrameWriter() : QThread()
+{
+    writing = false;
+    stopped = false;
+}
+
+FrameWriter::~FrameWriter()
+{
+    closeStreams();
+}
+
+void FrameWriter::write(const QImage &image, const QString &fileName, const QString &format)
+{
+    QMutexLocker locker(&mutex);
+
+    while (frames.size() >= MAX_QUEUED_FRAMES)
+        frameWritten.wait(&mutex);
+
+    Frame frame;
+    frame.image = image;
+    frame.fileName = fileName;
+    frame.format = format.toUpper();
+
+    frames.enqueue(frame);
+    frameQueued.wakeOne();
+}
+
+void FrameWriter::flush()
+{
+    QMutexLocker locker(&mutex);
+
+    while (!frames.isEmpty() || writing)
+        frameWritten.wait(&mutex);
+
+    closeStreams();
+}
+
+void FrameWriter::flush(const QString &fileName)
+{
+    if (!writer)
+        return;
+
+    QMutexLocker locker(&writer->mutex);
+
+    while (writer->isPending(fileName))
+        writer->frameWritten.wait(&writer->mutex);
+}
+
+bool FrameWriter::isPending(const QString &fileName) const
+{
+    if (writing && (writingFile == fileName))
+        return true;
+
+    foreach(const Frame &frame, frames)
+    {
+        if (frame.fileName == fileName)
+            return true;
+    }
+    return false;
+}
+
+void FrameWriter::stop()
+{
+    FrameWriter &writer = getInstance();
+
+    writer.flush();
+
+    writer.mutex.lock();
+    writer.stopped = true;
+    writer.frameQueued.wakeOne();
+    writer.mutex.unlock();
+
+    writer.wait();
+}
+
+void FrameWriter::run()
+{
+    forever
+    {
+        mutex.lock();
+        while (frames.isEmpty() && !stopped)
+            frameQueued.wait(&mutex);
+
+        if (frames.isEmpty())
+        {
+            mutex.unlock();
+            return;
+        }
+
+        Frame frame = frames.dequeue();
+        writingFile = frame.fileName;
+        writing = true;
+        mutex.unlock();
+
+        if (!writeFrame(frame) && (execModes != Quiet))
+            qWarning("Warning: Could not save the image '%s'.", qPrintable(frame.fileName));
+
+        mutex.lock();
+        writing = false;
+        frameWritten.wakeAll();
+        mutex.unlock();
+    }
+}
+
+bool FrameWriter::writeFrame(const Frame &frame)
+{
+    if (frame.format != "MJPEG")
+        return frame.image.save(frame.fileName, qPrintable(frame.format));
+
+    // os quadros de um Motion JPEG sao concatenados em um unico arquivo
+    QFile *file = streams.value(frame.fileName, 0);
+    if (!file)
+    {
+        file = new QFile(frame.fileName);
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            delete file;
+            return false;
+        }
+        streams.insert(frame.fileName, file);
+    }
+
+    return frame.image.save(file, "JPG", JPEG_QUALITY);
+}
+
+void FrameWriter::closeStreams()
+{
+    foreach(QFile *file, streams.values())
+    {
+        file->close();
+        delete file;
+    }
+    streams.clear();
+}
@@ -0,0 +1,144 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QHash>
+#include <QImage>
+#include <QString>
+
+class QFile;
+
+namespace TerraMEObserver {
+
+/**
+ * \brief Writes the images saved by the maps in a separate thread
+ *
+ * The simulation only enqueues a copy of the image and continues. Each
+ * frame is written in its own file, or appended to a single Motion JPEG
+ * stream when the format is MJPEG. The queue is bounded, so a slow disk
+ * eventually makes the simulation wait instead of exhausting the memory.
+ * Code that reads a saved image must call flush() for its file first.
+ * \see QThread, \see QImage
+ * \file frameWriter.h
+ */
+class FrameWriter : public QThread
+{
+public:
+    /**
+     * Gets the unique instance of the writer, starting it if necessary
+     */
+    static FrameWriter & getInstance();
+
+    /**
+     * Enqueues an image to be written
+     * \param image the image, it is implicitly shared and never changed
+     * \param fileName the name of the file
+     * \param format the format of the image, such as PNG or MJPEG
+     * \see QImage, \see QString
+     */
+    void write(const QImage &image, const QString &fileName, const QString &format);
+
+    /**
+     * Waits until all the enqueued frames are written and closes the
+     * Motion JPEG streams
+     */
+    void flush();
+
+    /**
+     * Waits until the enqueued frames of a file are written, as before reading
+     * an image that could still be in the queue. It does nothing if no frame
+     * was ever enqueued. Motion JPEG streams are kept open
+     * \param fileName the name of the file
+     * \see QString
+     */
+    static void flush(const QString &fileName);
+
+protected:
+    /**
+     * Runs the thread
+     * \see QThread
+     */
+    void run();
+
+private:
+    /**
+     * Constructor
+     */
+    FrameWriter();
+
+    /**
+     * Destructor
+     */
+    virtual ~FrameWriter();
+
+    /**
+     * Stops the thread after writing all the enqueued frames
+     */
+    static void stop();
+
+    /**
+     * An image waiting to be written
+     */
+    struct Frame
+    {
+        QImage image;
+        QString fileName;
+        QString format;
+    };
+
+    /**
+     * Writes a frame
+     * \return boolean, \a true if the frame could be written
+     */
+    bool writeFrame(const Frame &frame);
+
+    /**
+     * Checks if a file has frames enqueued or being written, must be called
+     * with the mutex locked
+     * \return boolean, \a true if the file is not complete yet
+     */
+    bool isPending(const QString &fileName) const;
+
+    /**
+     * Closes all the Motion JPEG streams
+     */
+    void closeStreams();
+
+    QQueue<Frame> frames;
+    QHash<QString, QFile *> streams;
+
+    QMutex mutex;
+    QWaitCondition frameQueued, frameWritten;
+    QString writingFile;
+    bool writing, stopped;
+};
+
+} // namespace TerraMEObserver
+
+#endif // FRAME_WRITER_H
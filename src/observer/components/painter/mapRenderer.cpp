@@ -0,0 +1,304 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "mapRenderer.h"
+
+#include <QPainter>
+#include <math.h>
+
+#include "../legend/legendAttributes.h"
+
+using namespace TerraMEObserver;
+
+MapRenderer::MapRenderer(QHash<QString, Attributes*> *mapAttrib)
+    : mapAttributes(mapAttrib)
+{
+    gridEnabled = false;
+    existAgent = false;
+
+    heightProportion = 1.0;
+    widthProportion = 1.0;
+
+    resultImage = QImage(IMAGE_SIZE, QImage::Format_ARGB32_Premultiplied);
+
+    painterThread.start();
+}
+
+MapRenderer::~MapRenderer() {}
+
+void MapRenderer::plotMap(Attributes *attrib)
+{
+    QPainter p;
+    painterThread.drawAttrib(&p, attrib);
+}
+
+void MapRenderer::plotMap(const QList<Attributes *> &attribs)
+{
+    QPainter p;
+
+    for (int i = 0; i < attribs.size(); i++)
+        painterThread.drawAttrib(&p, attribs.at(i));
+}
+
+void MapRenderer::replotMap()
+{
+    plotMap(mapAttributes->values());
+}
+
+void MapRenderer::calculateResult(const QSize &size)
+{
+    QList<Attributes *> attribs = mapAttributes->values();
+    qStableSort(attribs.begin(), attribs.end(), sortAttribByType);
+
+    painterThread.composite(resultImage, attribs);
+
+    // resultImageBkp = QImage(resultImage.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    resultImageBkp = QImage(resultImage.scaled(size));
+
+    if (existAgent)
+        drawAgent();
+
+    if (gridEnabled)
+        drawGrid();
+}
+
+bool MapRenderer::rescale(const QSize &size)
+{
+    QImage img = QImage(resultImage.scaled(size/*, Qt::IgnoreAspectRatio, Qt::SmoothTransformation*/));
+
+    if (img.isNull())
+        return false;
+
+    resultImageBkp = img;
+
+    if (gridEnabled)
+        drawGrid();
+
+    return true;
+}
+
+void MapRenderer::resizeImage(const QSize &newSize)
+{
+    resultImage = QImage(newSize, QImage::Format_ARGB32_Premultiplied);
+
+    widthProportion = newSize.width() / SIZE_CELL;
+    heightProportion = newSize.height() / SIZE_CELL;
+}
+
+const QImage & MapRenderer::getImage() const
+{
+    return resultImageBkp;
+}
+
+QSize MapRenderer::getResultSize() const
+{
+    return resultImage.size();
+}
+
+void MapRenderer::setGridEnabled(bool on)
+{
+    gridEnabled = on;
+}
+
+bool MapRenderer::isGridEnabled() const
+{
+    return gridEnabled;
+}
+
+void MapRenderer::drawGrid()
+{
+    double w = resultImageBkp.width() / widthProportion;
+    double h = resultImageBkp.height() / heightProportion;
+
+    painterThread.drawGrid(resultImageBkp, w, h);
+}
+
+void MapRenderer::setExistAgent(bool exist)
+{
+    existAgent = exist;
+}
+
+void MapRenderer::close()
+{
+    painterThread.exit(0);
+}
+
+void MapRenderer::drawAgent()
+{
+    QPainter painter(&resultImageBkp);
+
+    double orig2destW =(double) resultImageBkp.width() / resultImage.width();
+    double orig2destH =(double) resultImageBkp.height() / resultImage.height();
+
+    double sizeCellPropW = orig2destW * SIZE_CELL;
+    double sizeCellPropH = orig2destH * SIZE_CELL;
+
+    QRectF rec, recCell;
+    double x, y;
+
+    recCell = QRectF(0 - sizeCellPropW * 0.5, 0 - sizeCellPropH * 0.5,
+                     sizeCellPropW, sizeCellPropH);
+
+    //recCell = QRectF(0 - SIZE_CELL * 0.5, 0 - SIZE_CELL * 0.5,
+    //                 SIZE_CELL, SIZE_CELL);
+
+    foreach(Attributes * attrib, mapAttributes->values())
+    {
+        if ((attrib->getType() == TObsAgent) && (attrib->getVisible()))
+        {
+            QVector<ObsLegend> *vecLegend = attrib->getLegend();
+
+            // TO-DO: Necessita otimiza??o
+            if (attrib->getDataType() == TObsText)
+            {
+                QVector<QString> *values = attrib->getTextValues();
+
+                for (int pos = 0; pos < values->size(); pos++)
+                {
+                    const QString & v = values->at(pos);
+
+                    // Corrige o bug gerando quando um agente morre
+                    if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
+                        break;
+
+                    x = attrib->getXsValue()->at(pos) * SIZE_CELL;
+                    y = attrib->getYsValue()->at(pos) * SIZE_CELL;
+
+                    rec = QRectF(x * orig2destW , y * orig2destH, sizeCellPropW, sizeCellPropH);
+
+                    painter.save();
+
+                    for (int j = 0; j < vecLegend->size(); j++)
+                    {
+                        const ObsLegend &leg = vecLegend->at(j);
+                        if (v == leg.getFrom())
+                        {
+                            painter.setPen(leg.getColor());
+                            break;
+                        }
+                    }
+                    painter.setFont(attrib->getFont());
+                    painter.translate(rec.center());
+
+                    // painter.rotate(attrib->getDirection(pos, x, y)); // future use issue #411
+
+                    double xPos = recCell.x();
+                    double yPos = -recCell.y();
+
+                    int fontSize = attrib->getFont().pointSize();
+
+                    if (fontSize == 1)
+                    {
+                        QFont font = attrib->getFont();
+#ifdef Q_OS_MAC
+                        font.setPixelSize((int)floor(recCell.width())*1.3334); // 1.333 == 96/72
+#else
+                        font.setPixelSize((int)floor(recCell.width()));
+#endif
+                        painter.setFont(font);
+                    }
+                    else if (fontSize <= recCell.height())
+                    {
+                        double range = floor(recCell.height() - fontSize);
+                        double randx =((double)qrand() / RAND_MAX) * range;
+                        double randy =((double)qrand() / RAND_MAX) * range;
+                        xPos += randx;
+                        yPos -= randy;
+                    }
+                    else
+                    {
+                        xPos = -fontSize * 0.5;
+                        yPos = fontSize * 0.5;
+                    }
+
+                    QPointF position = QPointF(xPos, yPos);
+                    painter.drawText(position, attrib->getSymbol());
+                    painter.restore();
+                }
+            }
+            else
+            {
+                QVector<double> *values = attrib->getNumericValues();
+
+                for (int pos = 0; pos < values->size(); pos++)
+                {
+                    const double & v = values->at(pos);
+
+                    // Corrige o bug gerando quando um agente morre
+                    if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
+                        break;
+
+                    x = attrib->getXsValue()->at(pos) * SIZE_CELL;
+                    y = attrib->getYsValue()->at(pos) * SIZE_CELL;
+
+                    rec = QRectF(x * orig2destW , y * orig2destH, sizeCellPropW, sizeCellPropH);
+
+                    painter.save();
+
+                    for (int j = 0; j < vecLegend->size(); j++)
+                    {
+                        const ObsLegend &leg = vecLegend->at(j);
+                        if (v == leg.getFromNumber())
+                        {
+                            painter.setPen(leg.getColor());
+                            break;
+                        }
+                    }
+                    painter.setFont(attrib->getFont());
+                    painter.translate(rec.center());
+
+                    // painter.rotate(attrib->getDirection(pos, x, y)); // future use issue #411
+
+                    double xPos = recCell.x();
+                    double yPos = -recCell.y();
+
+                    int fontSize = attrib->getFont().pointSize();
+
+                    if (fontSize == 1)
+                    {
+                        QFont font = attrib->getFont();
+                        font.setPointSize((int)floor(recCell.width()));
+                        painter.setFont(font);
+                    }
+                    else if (fontSize < recCell.height())
+                    {
+                        double range = floor(recCell.height() - fontSize);
+                        double rand =((double)qrand() / RAND_MAX) * range;
+                        xPos += rand;
+                        yPos -= rand;
+                    }
+                    else
+                    {
+                        xPos = -fontSize * 0.5;
+                        yPos = fontSize * 0.5;
+                    }
+
+                    QPointF position = QPointF(xPos, yPos);
+                    painter.drawText(position, attrib->getSymbol());
+                    painter.restore();
+                }
+            }
+        }
+    }
+    painter.end();
+}
@@ -0,0 +1,161 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef MAP_RENDERER_H
+#define MAP_RENDERER_H
+
+#include <QImage>
+#include <QHash>
+#include <QString>
+#include <QSize>
+
+#include "painterThread.h"
+
+namespace TerraMEObserver {
+
+/**
+ * \brief Draws the cellular space state into images, without any widget
+ *
+ * Keeps the image of the observed attributes composited in the cellular
+ * space resolution and the scaled image that is exhibited or saved, with
+ * the agents and the grid. It is used by the PainterWidget and by the
+ * ObserverImage.
+ * \see PainterThread, \see PainterWidget
+ * \file mapRenderer.h
+ */
+class MapRenderer
+{
+public:
+    /**
+     * Constructor
+     * \param mapAttributes a pointer to a hash of attributes
+     * \see Attributes
+     * \see QHash, \see QString
+     */
+    MapRenderer(QHash<QString, Attributes*> *mapAttributes);
+
+    /**
+     * Destructor
+     */
+    virtual ~MapRenderer();
+
+    /**
+     * Draws the image of an attribute
+     * \param attrib a pointer to a attribute
+     * \see Attributes
+     */
+    void plotMap(Attributes *attrib);
+
+    /**
+     * Draws the images of a list of attributes
+     * \param attribs a list of attributes
+     */
+    void plotMap(const QList<Attributes *> &attribs);
+
+    /**
+     * Draws the images of all attributes
+     */
+    void replotMap();
+
+    /**
+     * Composites the attribute images and scales the result to \a size,
+     * drawing the agents and the grid over it
+     * \see QSize
+     */
+    void calculateResult(const QSize &size);
+
+    /**
+     * Scales the last composited image to \a size
+     * \return boolean, \a false if the scaled image is null
+     * \see QSize
+     */
+    bool rescale(const QSize &size);
+
+    /**
+     * Resizes the composited image to \a size, usually the cellular space
+     * size in pixels
+     * \see QSize
+     */
+    void resizeImage(const QSize &size);
+
+    /**
+     * Gets the scaled image, with the agents and the grid
+     * \see QImage
+     */
+    const QImage & getImage() const;
+
+    /**
+     * Gets the size of the composited image
+     * \see QSize
+     */
+    QSize getResultSize() const;
+
+    /**
+     * Activates the grid draw
+     * \param on if \a true the grid will be draw. Otherwise, will not draw.
+     */
+    void setGridEnabled(bool on);
+
+    /**
+     * Checks if the grid is drawn
+     */
+    bool isGridEnabled() const;
+
+    /**
+     * Draws the grid over the scaled image
+     */
+    void drawGrid();
+
+    /**
+     * Sets if there are agents to be drawn over the cells
+     */
+    void setExistAgent(bool exist);
+
+    /**
+     * Stops the painter thread
+     */
+    void close();
+
+private:
+    /**
+     * Draws the Subject Agent
+     */
+    void drawAgent();
+
+    double heightProportion, widthProportion;
+
+    // atributos em observacao
+    QImage resultImage;
+    QImage resultImageBkp;
+
+    QHash<QString, Attributes*> *mapAttributes;
+
+    PainterThread painterThread;
+
+    bool gridEnabled;
+    bool existAgent;
+};
+
+} // namespace TerraMEObserver
+
+#endif // MAP_RENDERER_H
@@ -27,9 +27,11 @@ of this software and its documentation.
 #include <QDebug>
 #include <time.h>
 #include <math.h>
+#include <algorithm>
 #include "terrameGlobals.h"
 
 #include "../legend/legendAttributes.h"
+#include "../legend/legendLookup.h"
 
 ///< Gobal variabel: Lua stack used for comunication with C++ modules.
 extern lua_State * L;
@@ -37,11 +39,46 @@ extern ExecutionModes execModes;
 
 using namespace TerraMEObserver;
 
+// Numero de faixas por thread, para equilibrar faixas com poucas celulas
+static const int TILES_PER_THREAD = 4;
+// Altura minima, em pixels, de cada faixa desenhada em paralelo
+static const int MIN_TILE_HEIGHT = 64;
+
+namespace {
+
+/**
+ * Draws one horizontal tile of the current job of a PainterThread
+ */
+class TileTask : public QRunnable
+{
+public:
+    TileTask(PainterThread *painter, PainterThread::TileJob job, int tile)
+        : painter(painter), job(job), tile(tile) {}
+
+    void run()
+    {
+        painter->runTile(job, tile);
+    }
+
+private:
+    PainterThread *painter;
+    PainterThread::TileJob job;
+    int tile;
+};
+
+} // namespace
+
 PainterThread::PainterThread(QObject *parent)
     : QThread(parent)
 {
     restart = false;
     abort = false;
+
+    tileHeight = MIN_TILE_HEIGHT;
+    tileAttrib = 0;
+    tileLookup = 0;
+    tileResult = 0;
+    tileBits = 0;
     // defaultPen = QPen(Qt::NoPen);		// n?o desenha a grade
 
     //posicionar randomicamente os agentes na c?lula
@@ -108,14 +145,13 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
     if (attrib->getType() == TObsAgent)
         return;
 
-    //---- Desenha o atributo
-    p->begin(attrib->getImage());
-
-    p->setPen(Qt::NoPen); //defaultPen);
-
 	//@RAIAN: Desenhando a vizinhanca
 	if (attrib->getType() == TObsNeighborhood)
 	{
+        //---- Desenha o atributo
+        p->begin(attrib->getImage());
+        p->setPen(Qt::NoPen); //defaultPen);
+
 		QColor color(Qt::white);
                 QVector<QMap<QString, QList<double> > > *neighborhoods = attrib->getNeighValues();
 		QVector<ObsLegend> *vecLegend = attrib->getLegend();
@@ -196,124 +232,263 @@ void PainterThread::drawAttrib(QPainter *p, Attributes *attrib)
 				}
 			}
 		}
+
+        p->end();
 	}
 	//@RAIAN: FIM
-	else
-	{
-		if (attrib->getDataType() == TObsNumber)
-		{
-			QColor color(Qt::white);
-			QVector<double> *values = attrib->getNumericValues();
-			QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    else if ((attrib->getDataType() == TObsNumber) || (attrib->getDataType() == TObsText))
+    {
+        QImage *image = attrib->getImage();
+        const QVector<double> *xs = attrib->getXsValue();
+        const QVector<double> *ys = attrib->getYsValue();
+        int size = qMin(xs->size(), ys->size());
+
+        if (attrib->getDataType() == TObsNumber)
+            size = qMin(size, attrib->getNumericValues()->size());
+        else
+            size = qMin(size, attrib->getTextValues()->size());
+
+        int cellSize = (attrib->getType() == TObsAutomaton) ? SIZE_AUTOMATON : SIZE_CELL;
+        int tiles = splitTiles(image->height());
+
+        // distribui as celulas pelas faixas que elas cobrem, mantendo
+        // a ordem original dentro de cada faixa
+        tileFirst.fill(0, tiles + 1);
+        for (int pos = 0; pos < size; pos++)
+        {
+            int first, last;
+            if (cellTiles(xs->at(pos), ys->at(pos), cellSize, image->height(), first, last))
+            {
+                for (int tile = first; tile <= last; tile++)
+                    tileFirst[tile + 1]++;
+            }
+        }
 
-			double x = -1.0, y = -1.0, v = 0.0;
+        for (int tile = 0; tile < tiles; tile++)
+            tileFirst[tile + 1] += tileFirst[tile];
 
-			int vSize = values->size();
-			int xSize = attrib->getXsValue()->size();
-			int ySize = attrib->getYsValue()->size();
+        QVector<int> next = tileFirst;
+        tileCells.resize(tileFirst[tiles]);
+        for (int pos = 0; pos < size; pos++)
+        {
+            int first, last;
+            if (cellTiles(xs->at(pos), ys->at(pos), cellSize, image->height(), first, last))
+            {
+                for (int tile = first; tile <= last; tile++)
+                    tileCells[next[tile]++] = pos;
+            }
+        }
 
-			for (int pos = 0; (pos < vSize && pos < xSize && pos < ySize); pos++)
-			{
-				v = values->at(pos);
+        LegendLookup lookup(attrib);
+        int random = qrand() % 256;
 
-				// Corrige o bug gerando quando um agente morre
-				if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-					break;
+        tileAttrib = attrib;
+        tileLookup = &lookup;
+        textGray = qRgb(random, random, random);
 
-				x = attrib->getXsValue()->at(pos);
-				y = attrib->getYsValue()->at(pos);
+        runTiles(CellsJob, tiles);
 
-				if (vecLegend->isEmpty())
-				{
-					v = v - attrib->getMinValue();
+        tileAttrib = 0;
+        tileLookup = 0;
+    }
+}
 
-					double c = v * attrib->getVal2Color();
-					if ((c >= 0) && (c <= 255))
-					{
-						color.setRgb(c, c, c);
-					}
-					else
-					{
-						color.setRgb(255, 255, 255);
-					}
-					p->setBrush(color);
-				}
-				else
-				{
-					for (int j = 0; j < vecLegend->size(); j++)
-					{
-						p->setBrush(Qt::white);
+void PainterThread::composite(QImage &result, const QList<Attributes *> &layers)
+{
+    int tiles = splitTiles(result.height());
 
-						const ObsLegend &leg = vecLegend->at(j);
-						if (attrib->getGroupMode() == TObsUniqueValue) // valor ?nico 3
-						{
-							if (v == leg.getToNumber())
-							{
-								p->setBrush(leg.getColor());
-								break;
-							}
-						}
-						else
-						{
-							if ((leg.getFromNumber() <= v) && (v < leg.getToNumber()))
-							{
-								p->setBrush(leg.getColor());
-								break;
-							}
-						}
-					}
-				}
-				if ((x >= 0) && (y >= 0))
-					draw(p, attrib->getType(), x, y);
-			}
-		}
-		else if (attrib->getDataType() == TObsText)
-		{
-			QVector<QString> *values = attrib->getTextValues();
-			QVector<ObsLegend> *vecLegend = attrib->getLegend();
+    // as faixas compartilham os scanlines da imagem resultante
+    tileResult = &result;
+    tileBits = result.bits();
+    tileLayers = layers;
 
-            int random = qrand() % 256;
-			double x = -1.0, y = -1.0;
+    runTiles(CompositeJob, tiles);
 
-			int vSize = values->size();
-			int xSize = attrib->getXsValue()->size();
-			int ySize = attrib->getYsValue()->size();
+    tileResult = 0;
+    tileBits = 0;
+    tileLayers.clear();
+}
 
-			for (int pos = 0; (pos < vSize && pos < xSize && pos < ySize); pos++)
-			{
-				const QString & v = values->at(pos);
+int PainterThread::splitTiles(int height)
+{
+    int tiles = qMax(1, pool.maxThreadCount() * TILES_PER_THREAD);
 
-				// Corrige o bug gerando quando um agente morre
-				if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-					break;
+    tileHeight = qMax(MIN_TILE_HEIGHT, (height + tiles - 1) / tiles);
+    return qMax(1, (height + tileHeight - 1) / tileHeight);
+}
 
-				x = attrib->getXsValue()->at(pos);
-				y = attrib->getYsValue()->at(pos);
+bool PainterThread::cellTiles(double x, double y, int cellSize, int height, int &first, int &last)
+{
+    if ((x < 0) || (y < 0))
+        return false;
 
-				if (vecLegend->isEmpty())
-				{
-					p->setBrush(QColor(random, random, random));
-				}
-				else
-				{
-					p->setBrush(Qt::white);
-					for (int j = 0; j < vecLegend->size(); j++)
-					{
-						const ObsLegend &leg = vecLegend->at(j);
-						if (v == leg.getFrom())
-						{
-							p->setBrush(leg.getColor());
-							break;
-						}
-					}
-				}
+    int top = SIZE_CELL * y;
+    int bottom = qMin(top + cellSize, height);
 
-				if ((x >= 0) && (y >= 0))
-					draw(p, attrib->getType(), x, y);
+    if (top >= bottom)
+        return false;
+
+    first = top / tileHeight;
+    last = (bottom - 1) / tileHeight;
+    return true;
+}
+
+void PainterThread::runTiles(TileJob job, int tiles)
+{
+    if (tiles == 1)
+    {
+        runTile(job, 0);
+        return;
+    }
+
+    for (int tile = 0; tile < tiles; tile++)
+        pool.start(new TileTask(this, job, tile));
+
+    pool.waitForDone();
+}
+
+void PainterThread::runTile(TileJob job, int tile)
+{
+    if (job == CellsJob)
+        drawCellsTile(tile);
+    else
+        compositeTile(tile);
+}
+
+void PainterThread::drawCellsTile(int tile)
+{
+    Attributes *attrib = tileAttrib;
+    QImage *image = attrib->getImage();
+    const QVector<double> *xs = attrib->getXsValue();
+    const QVector<double> *ys = attrib->getYsValue();
+    TypesOfSubjects type = attrib->getType();
+
+    int top = tile * tileHeight;
+    int bottom = qMin(top + tileHeight, image->height());
+
+    if (attrib->getDataType() == TObsNumber)
+    {
+        const QVector<double> *values = attrib->getNumericValues();
+
+        bool grayScale = attrib->getLegend()->isEmpty();
+        QRgb white = qRgb(255, 255, 255);
+        QRgb color = white;
+        double minValue = attrib->getMinValue();
+        double val2Color = attrib->getVal2Color();
+
+        for (int i = tileFirst.at(tile); i < tileFirst.at(tile + 1); i++)
+        {
+            int pos = tileCells.at(i);
+            double v = values->at(pos);
+
+            if (grayScale)
+            {
+                double c = (v - minValue) * val2Color;
+                color = ((c >= 0) && (c <= 255)) ? qRgb(c, c, c) : white;
+            }
+            else
+            {
+                color = tileLookup->getColor(v);
+            }
+
+            fillCell(image, type, xs->at(pos), ys->at(pos), color, top, bottom);
+        }
+    }
+    else
+    {
+        const QVector<QString> *values = attrib->getTextValues();
+        bool randomGray = attrib->getLegend()->isEmpty();
+
+        for (int i = tileFirst.at(tile); i < tileFirst.at(tile + 1); i++)
+        {
+            int pos = tileCells.at(i);
+
+            fillCell(image, type, xs->at(pos), ys->at(pos),
+                randomGray ? textGray : tileLookup->getColor(values->at(pos)), top, bottom);
+        }
+    }
+}
+
+void PainterThread::compositeTile(int tile)
+{
+    int top = tile * tileHeight;
+    int height = qMin(tileHeight, tileResult->height() - top);
+
+    QImage band(tileBits + top * tileResult->bytesPerLine(), tileResult->width(), height,
+        tileResult->bytesPerLine(), tileResult->format());
+    band.fill(0);
+
+    QPainter painter(&band);
+
+    foreach(Attributes * attrib, tileLayers)
+    {
+        if (attrib->getVisible() && (attrib->getType() != TObsAgent))
+        {
+            painter.fillRect(band.rect(), Qt::white);
+
+            if (attrib->getType() == TObsCell)
+                painter.setCompositionMode(QPainter::CompositionMode_Multiply);
+            else
+			{
+				//@RAIAN
+				if (attrib->getType() == TObsNeighborhood)
+					painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+				else
+				//@RAIAN: FIM
+					painter.setCompositionMode(QPainter::CompositionMode_HardLight);
 			}
-		}
-	}
-    p->end();
+
+            painter.drawImage(QPoint(0, 0), *attrib->getImage(),
+                QRect(0, top, tileResult->width(), height));
+        }
+    }
+
+    painter.end();
+}
+
+void PainterThread::fillCell(QImage *image, TypesOfSubjects type, double x, double y, QRgb color,
+                             int minRow, int maxRow)
+{
+    if (type == TObsAgent)
+        return;
+
+    // same truncation QPainter::drawRect(int, int, int, int) applied
+    int size = (type == TObsAutomaton) ? SIZE_AUTOMATON : SIZE_CELL;
+    int left = SIZE_CELL * x;
+    int top = SIZE_CELL * y;
+    int right = qMin(left + size, image->width());
+    int bottom = qMin(top + size, maxRow);
+
+    left = qMax(left, 0);
+    top = qMax(top, minRow);
+
+    if ((left >= right) || (top >= bottom))
+        return;
+
+    int alpha = qAlpha(color);
+
+    for (int row = top; row < bottom; row++)
+    {
+        QRgb *line = reinterpret_cast<QRgb *>(image->scanLine(row));
+
+        if (alpha == 255)
+        {
+            std::fill(line + left, line + right, color);
+        }
+        else
+        {
+            // source over composition of a premultiplied color
+            int inverse = 255 - alpha;
+            for (int col = left; col < right; col++)
+            {
+                QRgb dst = line[col];
+                line[col] = qRgba(qRed(color) + qRed(dst) * inverse / 255,
+                    qGreen(color) + qGreen(dst) * inverse / 255,
+                    qBlue(color) + qBlue(dst) * inverse / 255,
+                    alpha + qAlpha(dst) * inverse / 255);
+            }
+        }
+    }
 }
 
 
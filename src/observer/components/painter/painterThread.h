@@ -29,6 +29,10 @@ of this software and its documentation.
 #include <QtCore/QWaitCondition>
 #include <QtGui/QImage>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QVector>
+#include <QtCore/QList>
 #include <QtGui/QPainter>
 
 #include "../../observer.h"
@@ -42,6 +46,7 @@ extern "C"
 namespace TerraMEObserver {
 
 class Attributes;
+class LegendLookup;
 
 /**
  * \brief Auxiliary class to draws the cellular space state
@@ -54,6 +59,15 @@ class PainterThread : public QThread
     Q_OBJECT
 
 public:
+    /**
+     * Kinds of work split in horizontal tiles
+     */
+    enum TileJob
+    {
+        CellsJob,       //!< colors the cells of an attribute image
+        CompositeJob    //!< composites the attribute images
+    };
+
     /**
      * Constructor
      * \param parent a pointer to a QObject
@@ -67,7 +81,8 @@ public:
     virtual ~PainterThread();
 
     /**
-     * Draws an Attributes \a attrib using a QPainter \a p
+     * Draws an Attributes \a attrib. Neighborhoods use the QPainter \a p,
+     * cells and automata are written directly into the attribute image.
      * \param p a pointer to a QPainter
      * \param attrib a pointer to an attribute
      * \see Attributes, \see QPainter
@@ -84,6 +99,24 @@ public:
      */
     void drawGrid(QImage &image, double &width, double &height);
 
+    /**
+     * Composites the images of the visible attributes \a layers into
+     * \a result. The image is split in horizontal tiles composited
+     * in parallel
+     * \param result reference to the resulting QImage
+     * \param layers the attributes sorted in the drawing order
+     * \see QImage, \see Attributes
+     */
+    void composite(QImage &result, const QList<Attributes *> &layers);
+
+    /**
+     * Runs the \a job on the tile \a tile. It is called by the
+     * tasks of the thread pool
+     * \param job the kind of work
+     * \param tile the index of the tile
+     */
+    void runTile(TileJob job, int tile);
+
 signals:
     //void teste();
     //void renderedImage(const QImage &image, double scaleFactor);
@@ -109,6 +142,52 @@ private:
      */
     void draw(QPainter *p, TypesOfSubjects subjType , double &x, double &y);
 
+    /**
+     * Fills the block of a subject type \a subjType in the coordenate
+     * (\a x, \a y) writing the premultiplied \a color straight into
+     * the scanlines of \a image between the rows \a minRow and \a maxRow
+     * \param image a pointer to the attribute image
+     * \param subjType type of subject
+     * \param x axis position
+     * \param y axis position
+     * \param color premultiplied color
+     * \param minRow first row that can be written
+     * \param maxRow row after the last one that can be written
+     * \see LegendLookup
+     */
+    void fillCell(QImage *image, TypesOfSubjects subjType, double x, double y, QRgb color,
+                  int minRow, int maxRow);
+
+    /**
+     * Splits an image with \a height rows in horizontal tiles,
+     * setting the tile height
+     * \return the number of tiles
+     */
+    int splitTiles(int height);
+
+    /**
+     * Gets the tiles \a first to \a last covered by the cell in the
+     * coordenate (\a x, \a y)
+     * \return \a false if the cell is out of the image
+     */
+    bool cellTiles(double x, double y, int cellSize, int height, int &first, int &last);
+
+    /**
+     * Runs the \a job on \a tiles tiles using the thread pool and
+     * waits until all of them are done
+     */
+    void runTiles(TileJob job, int tiles);
+
+    /**
+     * Colors the cells of the current attribute that cover the tile \a tile
+     */
+    void drawCellsTile(int tile);
+
+    /**
+     * Composites the layers in the tile \a tile of the current result image
+     */
+    void compositeTile(int tile);
+
 	//@RAIAN: Desenha a vizinhanca
 		/// Draws a Neighborhood object
 		/// \author Raian Vargas Maretto
@@ -122,6 +201,18 @@ private:
 
     QPainter *p;
     // QPen defaultPen;
+
+    QThreadPool pool;
+    int tileHeight;
+    QVector<int> tileFirst, tileCells;   // celulas de cada faixa, no formato CSR
+
+    Attributes *tileAttrib;
+    LegendLookup *tileLookup;
+    QRgb textGray;
+
+    QImage *tileResult;
+    uchar *tileBits;
+    QList<Attributes *> tileLayers;
 };
 
 } // namespace TerraMEObserver
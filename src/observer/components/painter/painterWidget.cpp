@@ -42,15 +42,11 @@ static const QString COMPLEMENT("000000");
 using namespace TerraMEObserver;
 
 PainterWidget::PainterWidget(QHash<QString, Attributes*> *mapAttrib, QWidget *parent)
-    : mapAttributes(mapAttrib), QWidget(parent)
+    : mapAttributes(mapAttrib), QWidget(parent), renderer(mapAttrib)
 {
     // zoom
     handTool = false;
     zoomWindow = false;
-    gridEnabled = false;
-
-    heightProportion = 1.0;
-    widthProportion = 1.0;
 
     countSave = 0;
     pixmapScale = 0.;
@@ -61,65 +57,19 @@ PainterWidget::PainterWidget(QHash<QString, Attributes*> *mapAttrib, QWidget *pa
     zoomInCursor = QCursor(QPixmap(":icons/zoomIn.png").scaled(ICON_SIZE));
     zoomOutCursor = QCursor(QPixmap(":icons/zoomOut.png").scaled(ICON_SIZE));
 
-    resultImage = QImage(IMAGE_SIZE, QImage::Format_ARGB32_Premultiplied);
-
     setGeometry(0, 0, 1010, 1010);
 
     imageOffset = QPoint();
     showRectZoom = false;
-    existAgent = false;
 
     // connect(this, SIGNAL(gridOn(bool)), &painterThread, SLOT(gridOn(bool)));
-    painterThread.start();
 }
 
 PainterWidget::~PainterWidget() {}
 
 void PainterWidget::calculateResult()
 {
-    resultImage.fill(0);
-    QPainter painter(&resultImage);
-
-    QPoint point(0, 0);
-
-    // qDebug() << mapAttributes->keys();
-
-    QList<Attributes *> attribs = mapAttributes->values();
-    qStableSort(attribs.begin(), attribs.end(), sortAttribByType);
-
-    foreach(Attributes * attrib, attribs)
-    {
-        if (attrib->getVisible() && (attrib->getType() != TObsAgent))
-        {
-            painter.fillRect(resultImage.rect(), Qt::white);
-
-            if (attrib->getType() == TObsCell)
-                painter.setCompositionMode(QPainter::CompositionMode_Multiply);
-            else
-			{
-				//@RAIAN
-				if (attrib->getType() == TObsNeighborhood)
-					painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-				else
-				//@RAIAN: FIM
-					painter.setCompositionMode(QPainter::CompositionMode_HardLight);
-			}
-
-            painter.drawImage(point, *attrib->getImage());
-        }
-    }
-
-    painter.end();
-
-    // resultImageBkp = QImage(resultImage.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    resultImageBkp = QImage(resultImage.scaled(size()));
-
-    if (existAgent)
-        drawAgent();
-
-    if (gridEnabled)
-        drawGrid();
-
+    renderer.calculateResult(size());
     update();
 }
 
@@ -133,21 +83,22 @@ void PainterWidget::plotMap(Attributes *attrib)
     if (!attrib)
         qFatal("\nErro: PainterWidget::plotMap - Invalid attribute!!\n");
 
-    QPainter p;
-
-    painterThread.drawAttrib(&p, attrib);
+    renderer.plotMap(attrib);
     calculateResult();
 }
 
-void PainterWidget::replotMap()
+void PainterWidget::plotMap(const QList<Attributes *> &attribs)
 {
-    QPainter p;
-
-    QList<Attributes *> listAttribs = mapAttributes->values();
+    if (attribs.isEmpty())
+        return;
 
-    for (int i = 0; i < listAttribs.size(); i++)
-        painterThread.drawAttrib(&p, listAttribs.at(i));
+    renderer.plotMap(attribs);
+    calculateResult();
+}
 
+void PainterWidget::replotMap()
+{
+    renderer.replotMap();
     calculateResult();
 }
 
@@ -158,20 +109,13 @@ void PainterWidget::replotMap()
 
 bool PainterWidget::rescale(QSize size)
 {
-    QImage img = QImage(resultImage.scaled(size/*, Qt::IgnoreAspectRatio, Qt::SmoothTransformation*/));
-
-    if (img.isNull())
+    if (!renderer.rescale(size))
     {
         QMessageBox::information(this, "Map",
                                  tr("This zoom level generated a null image."));
         return false;
     }
 
-    resultImageBkp = img;
-
-    if (gridEnabled)
-        drawGrid();
-
     update();
     return true;
 }
@@ -179,7 +123,7 @@ bool PainterWidget::rescale(QSize size)
 void PainterWidget::paintEvent(QPaintEvent * /* event */)
 {
     QPainter painter(this);
-    painter.drawPixmap(QPoint(0, 0), QPixmap::fromImage(resultImageBkp));
+    painter.drawPixmap(QPoint(0, 0), QPixmap::fromImage(renderer.getImage()));
 
     // drawAgent();
 
@@ -203,11 +147,8 @@ void PainterWidget::resizeEvent(QResizeEvent * /*event*/)
 
 void PainterWidget::resizeImage(const QSize &newSize)
 {
-    resultImage = QImage(newSize, QImage::Format_ARGB32_Premultiplied);
+    renderer.resizeImage(newSize);
     resize(newSize);
-
-    widthProportion = newSize.width() / SIZE_CELL;
-    heightProportion = newSize.height() / SIZE_CELL;
 }
 
 void PainterWidget::mousePressEvent(QMouseEvent *event)
@@ -376,7 +317,7 @@ bool PainterWidget::save(const QString & path)
     aux.append(countString);
 
     QString name =  path + aux + ".png";
-    return resultImageBkp.save(name);
+    return renderer.getImage().save(name);
 
     //// bool ret = resultImage.save(name);
 
@@ -408,11 +349,11 @@ bool PainterWidget::save(const QString & path)
 
 void PainterWidget::gridOn(bool on)
 {
-    gridEnabled = on;
+    renderer.setGridEnabled(on);
 
-    if (gridEnabled)
+    if (on)
     {
-        drawGrid();
+        renderer.drawGrid();
         update();
     }
     else
@@ -421,182 +362,14 @@ void PainterWidget::gridOn(bool on)
     }
 }
 
-void PainterWidget::drawGrid()
-{
-    double w = resultImageBkp.width() / widthProportion;
-    double h = resultImageBkp.height() / heightProportion;
-
-    painterThread.drawGrid(resultImageBkp, w, h);
-}
-
-void PainterWidget::drawAgent()
-{
-    QPainter painter(&resultImageBkp);
-
-    double orig2destW =(double) resultImageBkp.width() / resultImage.width();
-    double orig2destH =(double) resultImageBkp.height() / resultImage.height();
-
-    double sizeCellPropW = orig2destW * SIZE_CELL;
-    double sizeCellPropH = orig2destH * SIZE_CELL;
-
-    QRectF rec, recCell;
-    double x, y;
-
-    recCell = QRectF(0 - sizeCellPropW * 0.5, 0 - sizeCellPropH * 0.5,
-                     sizeCellPropW, sizeCellPropH);
-
-    //recCell = QRectF(0 - SIZE_CELL * 0.5, 0 - SIZE_CELL * 0.5,
-    //                 SIZE_CELL, SIZE_CELL);
-
-    foreach(Attributes * attrib, mapAttributes->values())
-    {
-        if ((attrib->getType() == TObsAgent) && (attrib->getVisible()))
-        {
-            QVector<ObsLegend> *vecLegend = attrib->getLegend();
-
-            // TO-DO: Necessita otimiza??o
-            if (attrib->getDataType() == TObsText)
-            {
-                QVector<QString> *values = attrib->getTextValues();
-
-                for (int pos = 0; pos < values->size(); pos++)
-                {
-                    const QString & v = values->at(pos);
-
-                    // Corrige o bug gerando quando um agente morre
-                    if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-                        break;
-
-                    x = attrib->getXsValue()->at(pos) * SIZE_CELL;
-                    y = attrib->getYsValue()->at(pos) * SIZE_CELL;
-
-                    rec = QRectF(x * orig2destW , y * orig2destH, sizeCellPropW, sizeCellPropH);
-
-                    painter.save();
-
-                    for (int j = 0; j < vecLegend->size(); j++)
-                    {
-                        const ObsLegend &leg = vecLegend->at(j);
-                        if (v == leg.getFrom())
-                        {
-                            painter.setPen(leg.getColor());
-                            break;
-                        }
-                    }
-                    painter.setFont(attrib->getFont());
-                    painter.translate(rec.center());
-
-                    // painter.rotate(attrib->getDirection(pos, x, y)); // future use issue #411
-
-                    double xPos = recCell.x();
-                    double yPos = -recCell.y();
-
-                    int fontSize = attrib->getFont().pointSize();
-
-                    if (fontSize == 1)
-                    {
-                        QFont font = attrib->getFont();
-#ifdef Q_OS_MAC
-                        font.setPixelSize((int)floor(recCell.width())*1.3334); // 1.333 == 96/72
-#else
-                        font.setPixelSize((int)floor(recCell.width()));
-#endif
-                        painter.setFont(font);
-                    }
-                    else if (fontSize <= recCell.height())
-                    {
-                        double range = floor(recCell.height() - fontSize);
-                        double randx =((double)qrand() / RAND_MAX) * range;
-                        double randy =((double)qrand() / RAND_MAX) * range;
-                        xPos += randx;
-                        yPos -= randy;
-                    }
-                    else
-                    {
-                        xPos = -fontSize * 0.5;
-                        yPos = fontSize * 0.5;
-                    }
-
-                    QPointF position = QPointF(xPos, yPos);
-                    painter.drawText(position, attrib->getSymbol());
-                    painter.restore();
-                }
-            }
-            else
-            {
-                QVector<double> *values = attrib->getNumericValues();
-
-                for (int pos = 0; pos < values->size(); pos++)
-                {
-                    const double & v = values->at(pos);
-
-                    // Corrige o bug gerando quando um agente morre
-                    if (attrib->getXsValue()->isEmpty() || attrib->getXsValue()->size() == pos)
-                        break;
-
-                    x = attrib->getXsValue()->at(pos) * SIZE_CELL;
-                    y = attrib->getYsValue()->at(pos) * SIZE_CELL;
-
-                    rec = QRectF(x * orig2destW , y * orig2destH, sizeCellPropW, sizeCellPropH);
-
-                    painter.save();
-
-                    for (int j = 0; j < vecLegend->size(); j++)
-                    {
-                        const ObsLegend &leg = vecLegend->at(j);
-                        if (v == leg.getFromNumber())
-                        {
-                            painter.setPen(leg.getColor());
-                            break;
-                        }
-                    }
-                    painter.setFont(attrib->getFont());
-                    painter.translate(rec.center());
-
-                    // painter.rotate(attrib->getDirection(pos, x, y)); // future use issue #411
-
-                    double xPos = recCell.x();
-                    double yPos = -recCell.y();
-
-                    int fontSize = attrib->getFont().pointSize();
-
-                    if (fontSize == 1)
-                    {
-                        QFont font = attrib->getFont();
-                        font.setPointSize((int)floor(recCell.width()));
-                        painter.setFont(font);
-                    }
-                    else if (fontSize < recCell.height())
-                    {
-                        double range = floor(recCell.height() - fontSize);
-                        double rand =((double)qrand() / RAND_MAX) * range;
-                        xPos += rand;
-                        yPos -= rand;
-                    }
-                    else
-                    {
-                        xPos = -fontSize * 0.5;
-                        yPos = fontSize * 0.5;
-                    }
-
-                    QPointF position = QPointF(xPos, yPos);
-                    painter.drawText(position, attrib->getSymbol());
-                    painter.restore();
-                }
-            }
-        }
-    }
-    painter.end();
-}
-
 int PainterWidget::close()
 {
     // QWidget::close();
-    painterThread.exit(0);
+    renderer.close();
     return 0;
 }
 
 void PainterWidget::setExistAgent(bool exist)
 {
-    existAgent = exist;
+    renderer.setExistAgent(exist);
 }
@@ -33,7 +33,7 @@ of this software and its documentation.
 #include <QPaintEvent>
 #include <iostream>
 
-#include "painterThread.h"
+#include "mapRenderer.h"
 
 namespace TerraMEObserver {
 
@@ -75,6 +75,13 @@ public:
      */
     void plotMap(Attributes *attrib);
 
+    /**
+     * Plots a list of attributes and composes the result image once
+     * \param attribs a list of attributes
+     * \see Attributes
+     */
+    void plotMap(const QList<Attributes *> &attribs);
+
     /**
      * Re-paints all attributes under observation
      */
@@ -201,36 +208,19 @@ protected:
     //void wheelEvent(QWheelEvent *);
 
 private:
-    /**
-     * Draws the grid
-     */
-    void drawGrid();
-
-    /**
-     * Draws the Subject Agent
-     */
-    void drawAgent();
-
-
     int countSave;
     double pixmapScale, curScale, scaleFactor;
-    double heightProportion, widthProportion;
     QPainter::CompositionMode operatorMode;
 
-    // atributos em observa??o
-    QImage resultImage;
-    QImage resultImageBkp;
-
     // objetos do ObserverMap
     QHash<QString, Attributes*> *mapAttributes;
     QScrollArea *mParentScroll;
 
-    PainterThread painterThread;
+    // imagens dos atributos em observacao
+    MapRenderer renderer;
 
     QPoint lastDragPos, imageOffset;
     bool showRectZoom, zoomWindow, handTool;
-    bool gridEnabled;
-    bool existAgent;
 
     QCursor zoomWindowCursor;
     QCursor zoomInCursor, zoomOutCursor;
@@ -29,10 +29,19 @@ of this software and its documentation.
 #include <QHostAddress>
 #include <QThread>
 #include <QDebug>
+#include <QtEndian>
 
 // Observers
 #include "../../types/agentObserverMap.h"
 
+// Numero maximo de estados incompletos aguardando fragmentos
+static const int MAX_PENDING_STATES = 8;
+
+// Tamanho maximo de um estado e numero maximo de fragmentos aceitos, para que um
+// cabecalho invalido nao aloque memoria demais
+static const quint32 MAX_STATE_SIZE = 1 << 28;
+static const quint32 MAX_FRAGMENTS = 1 << 20;
+
 //class ObserverThread : public QThread
 //{
 //    // Q_OBJECT
@@ -56,6 +65,8 @@ Receiver::Receiver(QWidget *parent) :
     msgReceiver = 0;
     statesReceiver = 0;
     obsMap = 0;
+    lastSequence = 0;
+    hasLastSequence = false;
 
     connect(ui->closeButton, SIGNAL(clicked()), this, SLOT(closeButtonClicked()));
     connect(ui->bindButton, SIGNAL(clicked()), this, SLOT(blindButtonClicked()));
@@ -121,73 +132,136 @@ void Receiver::blindButtonClicked()
     ui->lblReceiverStatus->setText(QString("Socket state: \"%1\", Port: %2").arg(state).arg(port));
 }
 
-// TENTATIVA 3
 void Receiver::processPendingDatagrams()
 {
-    // int totalDatagrams = 0;
-    bool compressDatagram = false;
-    qint64 dataSize = -1.0, pos = 0;
-    qint64 datagramSize = -1; // , dataRemainder = -1.0;
-
     QHostAddress host;
     quint16 port;
 
     QByteArray datagram;
-    do
+    while (udpSocket->hasPendingDatagrams())
     {
         datagram.resize(udpSocket->pendingDatagramSize());
         udpSocket->readDatagram(datagram.data(), datagram.size(), &host, &port);
-    } while (udpSocket->hasPendingDatagrams());
 
+        if (datagram.size() < UDP_HEADER_SIZE)
+            continue;
 
-    QByteArray data, auxData;
-    QDataStream in(&datagram, QIODevice::ReadOnly);
-    // in.setVersion(QDataStream::Qt_4_6);
+        const uchar *header = (const uchar *) datagram.constData();
+        quint32 magic = qFromBigEndian<quint32>(header);
+        quint32 version = qFromBigEndian<quint32>(header + 4);
+        quint32 sequence = qFromBigEndian<quint32>(header + 8);
+        quint32 fragment = qFromBigEndian<quint32>(header + 12);
+        quint32 fragments = qFromBigEndian<quint32>(header + 16);
+        quint32 pos = qFromBigEndian<quint32>(header + 20);
+        quint32 dataSize = qFromBigEndian<quint32>(header + 24);
+        int length = datagram.size() - UDP_HEADER_SIZE;
 
-    // Reserva o espa?o necess?rio para o stream transmitido
-    in >> dataSize;         // tamanho total do stream enviado
-    in >> datagramSize;     // tamanho do datagrama enviado
+        if ((magic != (quint32) UDP_PROTOCOL_MAGIC)
+            || ((version & 0xFFFF) != (quint32) UDP_PROTOCOL_VERSION))
+            continue;
 
-    in >> pos;  // indice do dado recebido
-    in >> compressDatagram; // flag formato do datagrama transmitido
-    in >> auxData; // dado recebido
+        msgReceiver++;
+        ui->lblMessageStatus->setText("Datagrams received: " + QString::number(msgReceiver));
 
-    // totalDatagrams = dataSize / datagramSize;
+        if (fragments == 0)
+        {
+            // mensagem de controle
+            if (datagram.mid(UDP_HEADER_SIZE) == COMPLETE_SIMULATION.toLatin1())
+            {
+                if (obsMap)
+                {
+                    obsMap->close();
+                    delete obsMap;
+                    obsMap = 0;
+                }
 
-    if ((completeData.isEmpty()))
-          completeData = QByteArray('\0', dataSize);
+                msgReceiver = 0;
+                statesReceiver = 0;
+                pendingStates.clear();
+                hasLastSequence = false;
 
+                ui->logEdit->appendPlainText("Simulation fineshed!\n");
+            }
+            continue;
+        }
 
-    if (compressDatagram)
-    {
-        data = qUncompress(auxData);
-    }
-    else
-    {
-        data = auxData;
-    }
+        // descarta fragmentos de estados mais antigos que o ultimo processado
+        if (hasLastSequence && (qint32) (sequence - lastSequence) <= 0)
+            continue;
 
-    msgReceiver++;
-    ui->lblMessageStatus->setText("Datagrams received: " + QString::number(msgReceiver));
+        if ((fragment >= fragments) || (fragments > MAX_FRAGMENTS) || (dataSize > MAX_STATE_SIZE)
+            || (fragments > qMax(dataSize, (quint32) 1)))
+            continue;
 
-    if ((pos > -1)) // && (data != COMPLETE_STATE.toLatin1()))
-    {
-        // redimensiona o objeto e insere lixo
-        // msg.insert((int)pos, data);
-        completeData.replace((int)pos, data.size(), data);
+        bool compressed = (version & UDP_COMPRESSED_FLAG) != 0;
+
+        // um fragmento de um estado ja pendente deve ter o mesmo cabecalho dos anteriores
+        QHash<quint32, PendingState>::iterator pending = pendingStates.find(sequence);
+        if ((pending != pendingStates.end())
+            && ((pending->data.size() != (int) dataSize)
+                || (pending->received.size() != (int) fragments)
+                || (pending->compressed != compressed)))
+            continue;
+
+        if ((qint64) pos + length > (qint64) dataSize)
+            continue;
+
+        if ((pending == pendingStates.end()) && (pendingStates.size() >= MAX_PENDING_STATES))
+        {
+            // descarta o estado incompleto mais antigo
+            QHash<quint32, PendingState>::iterator oldest = pendingStates.begin();
+            for (QHash<quint32, PendingState>::iterator it = pendingStates.begin();
+                 it != pendingStates.end(); ++it)
+            {
+                if ((qint32) (it.key() - oldest.key()) < 0)
+                    oldest = it;
+            }
+            pendingStates.erase(oldest);
+        }
+
+        PendingState &state = pendingStates[sequence];
+        if (state.received.isEmpty())
+        {
+            state.data.resize(dataSize);
+            state.received.resize(fragments);
+            state.missing = fragments;
+            state.compressed = compressed;
+        }
+
+        if ((state.received.size() != (int) fragments) || state.received.testBit(fragment)
+            || ((qint64) pos + length > (qint64) state.data.size()))
+            continue;
+
+        memcpy(state.data.data() + pos, datagram.constData() + UDP_HEADER_SIZE, length);
+        state.received.setBit(fragment);
+        state.missing--;
 
         message = tr("Messages received: %1. From: %2, Port: %3")
             .arg(msgReceiver).arg(host.toString()).arg(port);
 
         ui->logEdit->appendPlainText(
             QDateTime::currentDateTime().toString("MM/dd/yyyy, hh:mm:ss: ") + message);
-    }
-    else
-    {
-        if (data == COMPLETE_STATE.toLatin1())
+
+        if (state.missing == 0)
         {
-            processDatagram(completeData);
-            completeData.clear();
+            if (state.compressed)
+                processDatagram(qUncompress(state.data));
+            else
+                processDatagram(state.data);
+
+            lastSequence = sequence;
+            hasLastSequence = true;
+
+            // os estados anteriores incompletos nao serao mais exibidos
+            QHash<quint32, PendingState>::iterator it = pendingStates.begin();
+            while (it != pendingStates.end())
+            {
+                if ((qint32) (it.key() - lastSequence) <= 0)
+                    it = pendingStates.erase(it);
+                else
+                    ++it;
+            }
+
             statesReceiver++;
 
             ui->lblStatesStatus->setText("States received: " +  QString::number(statesReceiver));
@@ -198,20 +272,6 @@ void Receiver::processPendingDatagrams()
             ui->logEdit->appendPlainText(
                 QDateTime::currentDateTime().toString("MM/dd/yyyy, hh:mm:ss: ") + message);
         }
-        else
-        {
-            if (data == COMPLETE_SIMULATION.toLatin1())
-            {
-                obsMap->close();
-                delete obsMap;
-                obsMap = 0;
-
-                msgReceiver = 0;
-                statesReceiver = 0;
-
-                 ui->logEdit->appendPlainText("Simulation fineshed!\n");
-            }
-        }
     }
 }
 
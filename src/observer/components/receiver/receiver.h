@@ -26,6 +26,8 @@ of this software and its documentation.
 
 #include <QDialog>
 #include <QUdpSocket>
+#include <QBitArray>
+#include <QHash>
 
 namespace TerraMEObserver {
 class AgentObserverMap;
@@ -90,8 +92,21 @@ private:
     void processDatagram(QByteArray datagram);
 
 
+    /**
+     * A state whose fragments are still being received
+     */
+    struct PendingState
+    {
+        QByteArray data;
+        QBitArray received;
+        int missing;
+        bool compressed;
+    };
+
     int msgReceiver, statesReceiver;
-    QByteArray completeData;
+    QHash<quint32, PendingState> pendingStates;
+    quint32 lastSequence;
+    bool hasLastSequence;
     QString message;
 
     Ui::receiverGUI *ui;
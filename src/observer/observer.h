@@ -196,6 +196,31 @@ public:
      * Sets the \a dirty-bit for the Observer internal state
      */
     virtual void setDirtyBit() = 0;
+
+    /**
+     * Sets the format used by the Subject to serialize its state to this Observer
+     * \param format the protocol format
+     * \see ProtocolFormats
+     */
+    virtual void setProtocolFormat(ProtocolFormats format) = 0;
+
+    /**
+     * Gets the format used by the Subject to serialize its state to this Observer
+     * \see ProtocolFormats
+     */
+    virtual ProtocolFormats getProtocolFormat() = 0;
+
+    /**
+     * Asks the Subject to send a complete state in the next notification,
+     * as when a delta state could not be applied
+     */
+    virtual void requestFullState() = 0;
+
+    /**
+     * Checks whether the Observer asked for a complete state, clearing the request
+     * \return boolean, \a true if the next state must be complete
+     */
+    virtual bool takeFullStateRequest() = 0;
 };
 
 /**
@@ -58,6 +58,16 @@ static const QString EVENT_KEY = "@event";
 static const QString DEFAULT_NAME = "result_";
 
 static const QString PROTOCOL_SEPARATOR = "$";
+static const int BINARY_PROTOCOL_MAGIC = 0x42454D54; // "TMEB" in little-endian
+static const int BINARY_PROTOCOL_VERSION = 1;
+
+// Cabecalho de cada datagrama UDP: magic, versao e flags, sequencia do estado,
+// indice do fragmento, numero de fragmentos, posicao e tamanho total do estado,
+// todos quint32 big-endian. Fragmentos de controle (fim da simulacao) tem zero fragmentos.
+static const int UDP_PROTOCOL_MAGIC = 0x44554D54; // "TMUD" in little-endian
+static const int UDP_PROTOCOL_VERSION = 1;
+static const int UDP_COMPRESSED_FLAG = 0x10000;
+static const int UDP_HEADER_SIZE = 7 * 4;
 
 static const QString COMP_COLOR_SEP = ",";
 static const QString ITEM_SEP = ";";
@@ -159,6 +169,17 @@ enum TypesOfData
     TObsUnknownData     = 100   //!< Unknown type
 };
 
+/**
+* \enum TerraMEObserver::ProtocolFormats
+* \brief Format used to serialize the state of a Subject to an Observer.
+*
+*/
+enum ProtocolFormats
+{
+    TObsTextProtocol    = 0,    //!< Tokens separated by PROTOCOL_SEPARATOR
+    TObsBinaryProtocol  = 1     //!< Columnar binary state, see BinaryStateWriter
+};
+
 /**
 * \enum TerraMEObserver::GroupingMode
 * \brief TerraME Grouping Mode.
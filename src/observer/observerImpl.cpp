@@ -133,7 +133,7 @@ void restartObserverCounter()
 }
 
 //////////////////////////////////////////////////////////// Observer
-ObserverImpl::ObserverImpl() : visible(true)
+ObserverImpl::ObserverImpl() : visible(true), protocolFormat(TObsTextProtocol), fullState(false)
 {
     numObserverCreated++;
     observerID = numObserverCreated;
@@ -145,6 +145,8 @@ ObserverImpl::ObserverImpl(const ObserverImpl &other)
     {
         observerID = other.observerID;
         visible = other.visible;
+        protocolFormat = other.protocolFormat;
+        fullState = other.fullState;
 
         delete subject_;
         delete obsHandle_;
@@ -161,6 +163,8 @@ ObserverImpl & ObserverImpl::operator=(ObserverImpl &other)
 
     observerID = other.observerID;
     visible = other.visible;
+    protocolFormat = other.protocolFormat;
+    fullState = other.fullState;
 
     delete subject_;
     delete obsHandle_;
@@ -271,6 +275,28 @@ void ObserverImpl::setDirtyBit()
     // obsHandle_->setDirtyBit();
 }
 
+void ObserverImpl::setProtocolFormat(ProtocolFormats format)
+{
+    protocolFormat = format;
+}
+
+ProtocolFormats ObserverImpl::getProtocolFormat()
+{
+    return protocolFormat;
+}
+
+void ObserverImpl::requestFullState()
+{
+    fullState = true;
+}
+
+bool ObserverImpl::takeFullStateRequest()
+{
+    bool requested = fullState;
+    fullState = false;
+    return requested;
+}
+
 
 ////////////////////////////////////////////////////////////  Subject
 SubjectImpl::SubjectImpl()
@@ -119,6 +119,26 @@ public:
      */
     void setDirtyBit();
 
+    /**
+     * \copydoc TerraMEObserver::Observer::setProtocolFormat
+     */
+    void setProtocolFormat(ProtocolFormats format);
+
+    /**
+     * \copydoc TerraMEObserver::Observer::getProtocolFormat
+     */
+    ProtocolFormats getProtocolFormat();
+
+    /**
+     * \copydoc TerraMEObserver::Observer::requestFullState
+     */
+    void requestFullState();
+
+    /**
+     * \copydoc TerraMEObserver::Observer::takeFullStateRequest
+     */
+    bool takeFullStateRequest();
+
 private:
     /**
      * Copy constructor
@@ -132,6 +152,8 @@ private:
 
     bool visible;
     int observerID;
+    ProtocolFormats protocolFormat;
+    bool fullState;
     TerraMEObserver::Subject* subject_;
     Observer* obsHandle_;
 };
@@ -79,6 +79,26 @@ void ObserverInterf::setDirtyBit()
     Interface<ObserverImpl>::pImpl_->setDirtyBit();
 }
 
+void ObserverInterf::setProtocolFormat(ProtocolFormats format)
+{
+    Interface<ObserverImpl>::pImpl_->setProtocolFormat(format);
+}
+
+ProtocolFormats ObserverInterf::getProtocolFormat()
+{
+    return Interface<ObserverImpl>::pImpl_->getProtocolFormat();
+}
+
+void ObserverInterf::requestFullState()
+{
+    Interface<ObserverImpl>::pImpl_->requestFullState();
+}
+
+bool ObserverInterf::takeFullStateRequest()
+{
+    return Interface<ObserverImpl>::pImpl_->takeFullStateRequest();
+}
+
 
 
 ////////////////////////////////////////////////////////////  Subject
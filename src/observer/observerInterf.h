@@ -120,6 +120,26 @@ public:
      * \copydoc TerraMEObserver::Observer::setDirtyBit
      */
     void setDirtyBit();
+
+    /**
+     * \copydoc TerraMEObserver::Observer::setProtocolFormat
+     */
+    void setProtocolFormat(ProtocolFormats format);
+
+    /**
+     * \copydoc TerraMEObserver::Observer::getProtocolFormat
+     */
+    ProtocolFormats getProtocolFormat();
+
+    /**
+     * \copydoc TerraMEObserver::Observer::requestFullState
+     */
+    void requestFullState();
+
+    /**
+     * \copydoc TerraMEObserver::Observer::takeFullStateRequest
+     */
+    bool takeFullStateRequest();
 };
 
 
@@ -72,6 +72,12 @@ BlackBoard::~BlackBoard()
 {
     foreach(PrivateCache *c, cache)
         delete c;
+
+    foreach(const QHash<int, PrivateCache *> &observers, binaryCache)
+    {
+        foreach(PrivateCache *c, observers)
+            delete c;
+    }
 }
 
 BlackBoard & BlackBoard::getInstance()
@@ -86,6 +92,27 @@ void BlackBoard::setDirtyBit(int subjectId)
         cache.value(subjectId)->dirtyBit = true;
     else
         cache.insert(subjectId, new PrivateCache());
+
+    if (binaryCache.contains(subjectId))
+    {
+        foreach(PrivateCache *c, binaryCache[subjectId])
+            c->dirtyBit = true;
+    }
+}
+
+PrivateCache * BlackBoard::getCache(int subjectId, int observerId, ProtocolFormats format)
+{
+    if (format == TObsTextProtocol)
+        return cache.value(subjectId);
+
+    QHash<int, PrivateCache *> &observers = binaryCache[subjectId];
+    PrivateCache *state = observers.value(observerId);
+    if (!state)
+    {
+        state = new PrivateCache();
+        observers.insert(observerId, state);
+    }
+    return state;
 }
 
 bool BlackBoard::getDirtyBit(int subjectId) const
@@ -95,7 +122,10 @@ bool BlackBoard::getDirtyBit(int subjectId) const
 
 QDataStream & BlackBoard::getState(Subject *subj, int observerId, QStringList &attribs)
 {
-    PrivateCache *state = cache.value(subj->getId());
+    Observer *obs = subj->getObserverById(observerId);
+    ProtocolFormats format = obs ? obs->getProtocolFormat() : TObsTextProtocol;
+
+    PrivateCache *state = getCache(subj->getId(), observerId, format);
 
     if (!state->dirtyBit)
     {
@@ -27,6 +27,8 @@ of this software and its documentation.
 #include <QHash>
 #include <QStringList>
 
+#include "../../observerGlobals.h"
+
 class QBuffer;
 class QDataStream;
 class QByteArray;
@@ -73,7 +75,10 @@ public:
     bool getDirtyBit(int subjectID) const;
 
     /**
-     * Gets the subject state
+     * Gets the subject state. The text state is cached once for each
+     * subject and shared by its observers. The binary state is cached for
+     * each observer, because after the first notification it contains only
+     * what changed since the last state sent to that observer.
      * \param subj a pointer to a subject object
      * \param observerID the unique identifier for a observer
      * \param attribs the list of attributes under observation
@@ -96,7 +101,13 @@ private:
      */
     BlackBoard();
 
+    /**
+     * Gets the cache of a subject state for an observer
+     */
+    PrivateCache * getCache(int subjectID, int observerID, ProtocolFormats format);
+
     QHash<int, PrivateCache *> cache;
+    QHash<int, QHash<int, PrivateCache *> > binaryCache;
 };
 
 } // namespace TerraMEObserver
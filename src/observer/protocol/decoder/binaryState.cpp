@@ -0,0 +1,491 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "binaryState.h"
+
+#include <QtEndian>
+#include <cstring>
+
+using namespace TerraMEObserver;
+
+static const int HEADER_SIZE = 24;
+
+BinaryColumn::BinaryColumn() : type(TObsUnknownData) {}
+
+int BinaryColumn::size() const
+{
+    switch (type)
+    {
+        case TObsNumber:
+            return numbers.size();
+
+        case TObsText:
+            return texts.size();
+
+        case TObsBool:
+            return bools.size();
+
+        default:
+            return 0;
+    }
+}
+
+bool BinaryColumn::equals(const BinaryColumn &other, int i) const
+{
+    switch (type)
+    {
+        case TObsNumber:
+        {
+            double a = numbers.at(i), b = other.numbers.at(i);
+            return (a == b) || ((a != a) && (b != b)); // NaN is not informed
+        }
+
+        case TObsText:
+            return texts.at(i) == other.texts.at(i);
+
+        case TObsBool:
+            return bools.at(i) == other.bools.at(i);
+
+        default:
+            return true;
+    }
+}
+
+BinaryStateWriter::BinaryStateWriter(int subjectId, TypesOfSubjects type, int elems)
+    : elements(elems), columns(0)
+{
+    data.reserve(HEADER_SIZE);
+
+    writeInt(BINARY_PROTOCOL_MAGIC);
+    writeInt(BINARY_PROTOCOL_VERSION); // version(u16) and flags(u16)
+    writeInt(subjectId);
+    writeInt(type);
+    writeInt(elements);
+    writeInt(0); // columns, updated at each addColumn
+}
+
+void BinaryStateWriter::writeInt(qint32 value)
+{
+    qint32 le = qToLittleEndian(value);
+    data.append((const char *) &le, sizeof(qint32));
+}
+
+void BinaryStateWriter::beginColumn(const QString &key, TypesOfData type, int payloadSize)
+{
+    QByteArray k = key.toUtf8();
+
+    writeInt(k.size());
+    data.append(k);
+    writeInt(type);
+    writeInt(payloadSize);
+
+    columns++;
+    qint32 le = qToLittleEndian((qint32) columns);
+    memcpy(data.data() + HEADER_SIZE - sizeof(qint32), &le, sizeof(qint32));
+}
+
+void BinaryStateWriter::addColumn(const QString &key, const QVector<double> &values)
+{
+    int payloadSize = values.size() * sizeof(double);
+    beginColumn(key, TObsNumber, payloadSize);
+
+    int begin = data.size();
+    data.resize(begin + payloadSize);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(data.data() + begin, values.constData(), payloadSize);
+#else
+    uchar *out = (uchar *) data.data() + begin;
+    for (int i = 0; i < values.size(); i++, out += sizeof(double))
+    {
+        quint64 bits;
+        memcpy(&bits, &values.at(i), sizeof(double));
+        qToLittleEndian(bits, out);
+    }
+#endif
+}
+
+void BinaryStateWriter::addColumn(const QString &key, const QVector<QString> &values)
+{
+    QByteArray payload;
+    for (int i = 0; i < values.size(); i++)
+    {
+        QByteArray v = values.at(i).toUtf8();
+        qint32 le = qToLittleEndian((qint32) v.size());
+        payload.append((const char *) &le, sizeof(qint32));
+        payload.append(v);
+    }
+
+    beginColumn(key, TObsText, payload.size());
+    data.append(payload);
+}
+
+void BinaryStateWriter::setIndexes(int totalElements, const QVector<int> &indexes)
+{
+    qint32 le = qToLittleEndian((qint32) (BINARY_PROTOCOL_VERSION | (BINARY_STATE_DELTA << 16)));
+    memcpy(data.data() + sizeof(qint32), &le, sizeof(qint32));
+
+    elements = indexes.size();
+    le = qToLittleEndian((qint32) elements);
+    memcpy(data.data() + 4 * sizeof(qint32), &le, sizeof(qint32));
+
+    writeInt(totalElements);
+    for (int i = 0; i < indexes.size(); i++)
+        writeInt(indexes.at(i));
+}
+
+void BinaryStateWriter::addColumn(const BinaryColumn &column, const QVector<int> *indexes)
+{
+    if (!indexes)
+    {
+        switch (column.type)
+        {
+            case TObsNumber:
+                addColumn(column.key, column.numbers);
+                break;
+
+            case TObsText:
+                addColumn(column.key, column.texts);
+                break;
+
+            case TObsBool:
+                addColumn(column.key, column.bools);
+                break;
+
+            default:
+                break;
+        }
+        return;
+    }
+
+    switch (column.type)
+    {
+        case TObsNumber:
+        {
+            QVector<double> values(indexes->size());
+            for (int i = 0; i < indexes->size(); i++)
+                values[i] = column.numbers.at(indexes->at(i));
+            addColumn(column.key, values);
+            break;
+        }
+
+        case TObsText:
+        {
+            QVector<QString> values(indexes->size());
+            for (int i = 0; i < indexes->size(); i++)
+                values[i] = column.texts.at(indexes->at(i));
+            addColumn(column.key, values);
+            break;
+        }
+
+        case TObsBool:
+        {
+            QVector<bool> values(indexes->size());
+            for (int i = 0; i < indexes->size(); i++)
+                values[i] = column.bools.at(indexes->at(i));
+            addColumn(column.key, values);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void BinaryStateWriter::addColumn(const QString &key, const QVector<bool> &values)
+{
+    beginColumn(key, TObsBool, values.size());
+
+    for (int i = 0; i < values.size(); i++)
+        data.append(values.at(i) ? '\1' : '\0');
+}
+
+const QByteArray & BinaryStateWriter::getData() const
+{
+    return data;
+}
+
+
+BinaryStateReader::BinaryStateReader(const QByteArray &d)
+    : data(d), valid(false), subjectId(-1), subjectType(TObsUnknown),
+    elements(0), columns(0), flags(0), totalElements(0), pos(HEADER_SIZE),
+    dataType(TObsUnknownData),
+    payloadPos(0), payloadSize(0)
+{
+    if (data.size() < HEADER_SIZE)
+        return;
+
+    int p = 0;
+    qint32 magic, version, id, type, elems, cols;
+
+    readInt(p, magic);
+    readInt(p, version);
+    readInt(p, id);
+    readInt(p, type);
+    readInt(p, elems);
+    readInt(p, cols);
+
+    if ((magic != BINARY_PROTOCOL_MAGIC) || ((version & 0xFFFF) != BINARY_PROTOCOL_VERSION)
+        || (elems < 0) || (cols < 0))
+        return;
+
+    subjectId = id;
+    subjectType = (TypesOfSubjects) type;
+    elements = elems;
+    columns = cols;
+    flags = (version >> 16) & 0xFFFF;
+    totalElements = elems;
+
+    if (flags & BINARY_STATE_DELTA)
+    {
+        qint32 total, idx;
+
+        if (!readInt(pos, total) || (total < elems))
+            return;
+
+        indexes.resize(elems);
+        for (int i = 0; i < elems; i++)
+        {
+            if (!readInt(pos, idx) || (idx < 0) || (idx >= total))
+                return;
+            indexes[i] = idx;
+        }
+        totalElements = total;
+    }
+
+    valid = true;
+}
+
+bool BinaryStateReader::readInt(int &p, qint32 &value) const
+{
+    if (p + (int) sizeof(qint32) > data.size())
+        return false;
+
+    value = qFromLittleEndian<qint32>((const uchar *) data.constData() + p);
+    p += sizeof(qint32);
+    return true;
+}
+
+bool BinaryStateReader::isValid() const
+{
+    return valid;
+}
+
+int BinaryStateReader::getSubjectId() const
+{
+    return subjectId;
+}
+
+TypesOfSubjects BinaryStateReader::getSubjectType() const
+{
+    return subjectType;
+}
+
+int BinaryStateReader::getElements() const
+{
+    return elements;
+}
+
+int BinaryStateReader::getColumns() const
+{
+    return columns;
+}
+
+bool BinaryStateReader::isDelta() const
+{
+    return (flags & BINARY_STATE_DELTA) != 0;
+}
+
+int BinaryStateReader::getTotalElements() const
+{
+    return totalElements;
+}
+
+const QVector<int> & BinaryStateReader::getIndexes() const
+{
+    return indexes;
+}
+
+bool BinaryStateReader::next()
+{
+    if (!valid)
+        return false;
+
+    if (payloadPos > 0)
+        pos = payloadPos + payloadSize;
+
+    qint32 keySize, type, size;
+
+    if (!readInt(pos, keySize) || (keySize < 0) || (pos + keySize > data.size()))
+        return false;
+
+    key = QString::fromUtf8(data.constData() + pos, keySize);
+    pos += keySize;
+
+    if (!readInt(pos, type) || !readInt(pos, size)
+        || (size < 0) || (pos + size > data.size()))
+        return false;
+
+    dataType = (TypesOfData) type;
+    payloadPos = pos;
+    payloadSize = size;
+    return true;
+}
+
+const QString & BinaryStateReader::getKey() const
+{
+    return key;
+}
+
+TypesOfData BinaryStateReader::getDataType() const
+{
+    return dataType;
+}
+
+bool BinaryStateReader::readNumbers(QVector<double> &values) const
+{
+    if ((dataType != TObsNumber) || (payloadSize != elements * (int) sizeof(double)))
+        return false;
+
+    values.resize(elements);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(values.data(), data.constData() + payloadPos, payloadSize);
+#else
+    const uchar *in = (const uchar *) data.constData() + payloadPos;
+    for (int i = 0; i < elements; i++, in += sizeof(double))
+    {
+        quint64 bits = qFromLittleEndian<quint64>(in);
+        memcpy(&values[i], &bits, sizeof(double));
+    }
+#endif
+    return true;
+}
+
+bool BinaryStateReader::readTexts(QVector<QString> &values) const
+{
+    if (dataType != TObsText)
+        return false;
+
+    int p = payloadPos;
+    int end = payloadPos + payloadSize;
+    qint32 size;
+
+    values.clear();
+    values.reserve(elements);
+    for (int i = 0; i < elements; i++)
+    {
+        if (!readInt(p, size) || (size < 0) || (p + size > end))
+            return false;
+
+        values.append(QString::fromUtf8(data.constData() + p, size));
+        p += size;
+    }
+    return true;
+}
+
+bool BinaryStateReader::readBools(QVector<bool> &values) const
+{
+    if ((dataType != TObsBool) || (payloadSize != elements))
+        return false;
+
+    const char *in = data.constData() + payloadPos;
+
+    values.clear();
+    values.reserve(elements);
+    for (int i = 0; i < elements; i++)
+        values.append(in[i] != 0);
+    return true;
+}
+
+
+BinaryStateBaseline::BinaryStateBaseline() : empty(true) {}
+
+void BinaryStateBaseline::clear()
+{
+    last.clear();
+    empty = true;
+}
+
+bool BinaryStateBaseline::sameLayout(const QVector<BinaryColumn> &columns) const
+{
+    if (empty || (columns.size() != last.size()))
+        return false;
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        if ((columns.at(i).key != last.at(i).key)
+            || (columns.at(i).type != last.at(i).type)
+            || (columns.at(i).size() != last.at(i).size()))
+            return false;
+    }
+    return true;
+}
+
+QByteArray BinaryStateBaseline::serialize(int subjectId, TypesOfSubjects type,
+                                          const QVector<BinaryColumn> &columns)
+{
+    int elements = columns.isEmpty() ? 0 : columns.first().size();
+
+    if (!sameLayout(columns))
+    {
+        BinaryStateWriter writer(subjectId, type, elements);
+        for (int i = 0; i < columns.size(); i++)
+            writer.addColumn(columns.at(i));
+
+        last = columns;
+        empty = false;
+        return writer.getData();
+    }
+
+    QVector<int> indexes;
+    QVector<bool> changedColumns(columns.size(), false);
+
+    for (int e = 0; e < elements; e++)
+    {
+        bool changed = false;
+        for (int i = 0; i < columns.size(); i++)
+        {
+            if (!columns.at(i).equals(last.at(i), e))
+            {
+                changedColumns[i] = true;
+                changed = true;
+            }
+        }
+
+        if (changed)
+            indexes.append(e);
+    }
+
+    BinaryStateWriter writer(subjectId, type, indexes.size());
+    writer.setIndexes(elements, indexes);
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        if (changedColumns.at(i))
+            writer.addColumn(columns.at(i), &indexes);
+    }
+
+    last = columns;
+    return writer.getData();
+}
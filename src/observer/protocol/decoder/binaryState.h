@@ -0,0 +1,285 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef BINARY_STATE_H
+#define BINARY_STATE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "../../observer.h"
+
+namespace TerraMEObserver {
+
+/// Flag of a state that contains only the elements that changed
+static const int BINARY_STATE_DELTA = 0x1;
+
+/**
+ * \brief Values of an attribute for all the elements of a subject
+ * \file binaryState.h
+ */
+class BinaryColumn
+{
+public:
+    /**
+     * Constructor
+     */
+    BinaryColumn();
+
+    /**
+     * Gets the number of values
+     */
+    int size() const;
+
+    /**
+     * Checks if the value of the element \a i is equal in both columns
+     * \param other a column with the same key and type
+     * \param i the position of the element
+     */
+    bool equals(const BinaryColumn &other, int i) const;
+
+    QString key;
+    TypesOfData type;
+    QVector<double> numbers;
+    QVector<QString> texts;
+    QVector<bool> bools;
+};
+
+/**
+ * \brief Writer for the columnar binary state of a subject
+ *
+ * The binary state is an alternative to the PROTOCOL_SEPARATOR text
+ * protocol. It stores a header followed by one column per attribute, and
+ * each column keeps the values of all the elements of the subject
+ * contiguously. All integers and doubles are little-endian.
+ *
+ * header: magic(u32) version(u16) flags(u16) id(i32) subjectType(i32)
+ *         elements(i32) columns(i32)
+ * delta:  totalElements(i32) indexes(i32 * elements), only if flags has
+ *         BINARY_STATE_DELTA
+ * column: keySize(i32) key(utf-8) dataType(i32) payloadSize(i32) payload
+ *
+ * The payload of a TObsNumber column is an array of doubles, of a TObsBool
+ * column an array of bytes, and of a TObsText column a sequence of
+ * size-prefixed utf-8 strings. In a delta state, the columns store only the
+ * elements listed in the indexes.
+ * \see BinaryStateReader
+ * \file binaryState.h
+ */
+class BinaryStateWriter
+{
+public:
+    /**
+     * Constructor
+     * \param subjectId the unique identifier of the subject
+     * \param type the type of the subject
+     * \param elements the number of elements of each column
+     */
+    BinaryStateWriter(int subjectId, TypesOfSubjects type, int elements);
+
+    /**
+     * Appends a numeric column
+     * \param key the attribute name
+     * \param values the values of the attribute, one per element
+     */
+    void addColumn(const QString &key, const QVector<double> &values);
+
+    /**
+     * Appends a textual column
+     * \param key the attribute name
+     * \param values the values of the attribute, one per element
+     */
+    void addColumn(const QString &key, const QVector<QString> &values);
+
+    /**
+     * Appends a boolean column
+     * \param key the attribute name
+     * \param values the values of the attribute, one per element
+     */
+    void addColumn(const QString &key, const QVector<bool> &values);
+
+    /**
+     * Appends a column, keeping only the elements in \a indexes
+     * \param column the values of the attribute for all the elements
+     * \param indexes the elements to be written, or all if null
+     */
+    void addColumn(const BinaryColumn &column, const QVector<int> *indexes = 0);
+
+    /**
+     * Turns the state into a delta state. It must be called before
+     * adding any column.
+     * \param totalElements the number of elements of the subject
+     * \param indexes the positions of the elements of the columns
+     */
+    void setIndexes(int totalElements, const QVector<int> &indexes);
+
+    /**
+     * Gets the serialized state
+     */
+    const QByteArray & getData() const;
+
+private:
+    void beginColumn(const QString &key, TypesOfData type, int payloadSize);
+    void writeInt(qint32 value);
+
+    QByteArray data;
+    int elements;
+    int columns;
+};
+
+/**
+ * \brief Reader for the columnar binary state of a subject
+ *
+ * The reader does not copy the state. Columns are visited in the order they
+ * were written and numeric columns can be copied directly into a vector.
+ * \see BinaryStateWriter
+ * \file binaryState.h
+ */
+class BinaryStateReader
+{
+public:
+    /**
+     * Constructor
+     * \param data the serialized state
+     */
+    BinaryStateReader(const QByteArray &data);
+
+    /**
+     * Checks if the header of the state is valid
+     */
+    bool isValid() const;
+
+    /// Gets the unique identifier of the subject
+    int getSubjectId() const;
+
+    /// Gets the type of the subject
+    TypesOfSubjects getSubjectType() const;
+
+    /// Gets the number of elements of each column
+    int getElements() const;
+
+    /// Gets the number of columns
+    int getColumns() const;
+
+    /// Checks if the state contains only the elements that changed
+    bool isDelta() const;
+
+    /// Gets the number of elements of the subject in a delta state
+    int getTotalElements() const;
+
+    /// Gets the positions of the elements of a delta state
+    const QVector<int> & getIndexes() const;
+
+    /**
+     * Moves to the next column
+     * \return \a false if there is no more columns or the state is truncated
+     */
+    bool next();
+
+    /// Gets the attribute name of the current column
+    const QString & getKey() const;
+
+    /// Gets the data type of the current column
+    TypesOfData getDataType() const;
+
+    /**
+     * Reads the current column as numbers
+     * \param values a vector that will be resized to the number of elements
+     */
+    bool readNumbers(QVector<double> &values) const;
+
+    /**
+     * Reads the current column as texts
+     * \param values a vector that will be filled with the texts
+     */
+    bool readTexts(QVector<QString> &values) const;
+
+    /**
+     * Reads the current column as booleans
+     * \param values a vector that will be filled with the booleans
+     */
+    bool readBools(QVector<bool> &values) const;
+
+private:
+    bool readInt(int &pos, qint32 &value) const;
+
+    const QByteArray &data;
+    bool valid;
+    int subjectId;
+    TypesOfSubjects subjectType;
+    int elements;
+    int columns;
+    int flags;
+    int totalElements;
+    QVector<int> indexes;
+
+    int pos;
+    QString key;
+    TypesOfData dataType;
+    int payloadPos;
+    int payloadSize;
+};
+
+/**
+ * \brief Last state sent by a subject to an observer
+ *
+ * Keeps the columns sent to an observer, so that the next state contains
+ * only the elements and the columns that changed since then.
+ * \file binaryState.h
+ */
+class BinaryStateBaseline
+{
+public:
+    /**
+     * Constructor
+     */
+    BinaryStateBaseline();
+
+    /**
+     * Serializes the columns and stores them as the new baseline. The first
+     * state, or a state whose elements or columns differ from the baseline,
+     * is complete. The other ones are delta states.
+     * \param subjectId the unique identifier of the subject
+     * \param type the type of the subject
+     * \param columns the current values of the attributes
+     * \see BinaryStateWriter
+     */
+    QByteArray serialize(int subjectId, TypesOfSubjects type,
+                         const QVector<BinaryColumn> &columns);
+
+    /**
+     * Discards the baseline, the next state will be complete
+     */
+    void clear();
+
+private:
+    bool sameLayout(const QVector<BinaryColumn> &columns) const;
+
+    QVector<BinaryColumn> last;
+    bool empty;
+};
+
+} // namespace TerraMEObserver
+
+#endif // BINARY_STATE_H
@@ -22,6 +22,7 @@ of this software and its documentation.
 *************************************************************************************/
 
 #include "decoder.h"
+#include "binaryState.h"
 
 #include <QStringList>
 
@@ -55,6 +56,151 @@ bool Decoder::decode(const QString &protocol,
     return ret;
 }
 
+bool Decoder::decode(const QString &protocol, const QList<Attributes *> &layers)
+{
+    QVector<double> xs, ys;
+
+    foreach(Attributes *attrib, layers)
+        attrib->clear();
+
+    if (!decode(protocol, xs, ys))
+        return false;
+
+    // QVector is implicitly shared, the positions are not copied for each layer
+    foreach(Attributes *attrib, layers)
+    {
+        *attrib->getXsValue() = xs;
+        *attrib->getYsValue() = ys;
+    }
+    return true;
+}
+
+bool Decoder::decodeBinary(const QByteArray &state, QList<Attributes *> &decoded)
+{
+    BinaryStateReader reader(state);
+
+    if (!reader.isValid())
+        return false;
+
+    bool delta = reader.isDelta();
+    bool applied = true;
+    QVector<double> xs, ys;
+    QList<Attributes *> complete;
+    Attributes *attrib = 0;
+
+    while (reader.next())
+    {
+        const QString &key = reader.getKey();
+
+        if (!delta && (key == "x"))
+        {
+            reader.readNumbers(xs);
+            continue;
+        }
+
+        if (!delta && (key == "y"))
+        {
+            reader.readNumbers(ys);
+            continue;
+        }
+
+        attrib = mapAttributes->value(key);
+        if (!attrib || (attrib->getType() != TObsCell))
+            continue;
+
+        if (delta)
+        {
+            // as in a complete state, only numbers and texts are drawn and the
+            // other types do not make the delta fail
+            if ((reader.getDataType() != TObsNumber) && (reader.getDataType() != TObsText))
+                continue;
+
+            if (applyDelta(reader, attrib))
+                decoded.append(attrib);
+            else
+                applied = false;
+            continue;
+        }
+
+        switch (reader.getDataType())
+        {
+            case TObsNumber:
+                if (attrib->getDataType() == TObsUnknownData)
+                    attrib->setDataType(TObsNumber);
+
+                attrib->clear();
+                if (reader.readNumbers(*attrib->getNumericValues()))
+                    complete.append(attrib);
+                break;
+
+            case TObsText:
+                if (attrib->getDataType() == TObsUnknownData)
+                    attrib->setDataType(TObsText);
+
+                attrib->clear();
+                if (reader.readTexts(*attrib->getTextValues()))
+                    complete.append(attrib);
+                break;
+
+            case TObsBool:
+            case TObsDateTime:
+            default:
+                break;
+        }
+    }
+
+    // QVector is implicitly shared, the positions are not copied for each attribute
+    foreach(Attributes *a, complete)
+    {
+        *a->getXsValue() = xs;
+        *a->getYsValue() = ys;
+    }
+    decoded << complete;
+
+    // a delta that could not be applied leaves stale values, the caller must
+    // ask the subject for a complete state
+    return applied;
+}
+
+bool Decoder::applyDelta(const BinaryStateReader &reader, Attributes *attrib)
+{
+    const QVector<int> &indexes = reader.getIndexes();
+
+    switch (reader.getDataType())
+    {
+        case TObsNumber:
+        {
+            QVector<double> *values = attrib->getNumericValues();
+            QVector<double> changes;
+
+            if ((values->size() != reader.getTotalElements()) || !reader.readNumbers(changes))
+                return false;
+
+            for (int i = 0; i < indexes.size(); i++)
+                (*values)[indexes.at(i)] = changes.at(i);
+            return true;
+        }
+
+        case TObsText:
+        {
+            QVector<QString> *values = attrib->getTextValues();
+            QVector<QString> changes;
+
+            if ((values->size() != reader.getTotalElements()) || !reader.readTexts(changes))
+                return false;
+
+            for (int i = 0; i < indexes.size(); i++)
+                (*values)[indexes.at(i)] = changes.at(i);
+            return true;
+        }
+
+        case TObsBool:
+        case TObsDateTime:
+        default:
+            return false;
+    }
+}
+
 bool Decoder::interpret(QStringList &tokens, int &idx,
                         QVector<double> &xs, QVector<double> &ys)
 {
@@ -198,7 +344,7 @@ bool Decoder::consumeTriple(QStringList &tokens, int &idx,
             if ((parentSubjectType == TObsTrajectory) && (mapAttributes->contains("trajectory")))
             {
                 attrib = mapAttributes->value("trajectory");
-                attrib->addValue((double) attrib->getXsValue()->size());
+                attrib->addValue((double) xs.size());
             }
         }
         else
@@ -33,6 +33,8 @@ of this software and its documentation.
 
 namespace TerraMEObserver {
 
+class BinaryStateReader;
+
 /**
  * \brief Decoder class for comunication protocol
  * \author Antonio Jos? da Cunha Rodrigues
@@ -63,6 +65,30 @@ public:
      */
     bool decode(const QString &protocol, QVector<double> &xs, QVector<double> &ys);
 
+    /**
+     * Decodes the state once for all the layers. The values of each
+     * attribute are fanned out while the state is interpreted, and the
+     * positions of the cells are shared by every layer.
+     * \param protocol the state in QString format
+     * \param layers the attributes that receive the state, they are
+     * cleared before decoding
+     * \see Attributes, \see QString
+     */
+    bool decode(const QString &protocol, const QList<Attributes *> &layers);
+
+    /**
+     * Decodes a state in the columnar binary format. The values of every
+     * cell attribute under observation are copied straight into their
+     * Attributes, without intermediate strings. A delta state updates only
+     * the cells it contains and keeps the other values.
+     * \param state the state in the binary format
+     * \param decoded a list where the attributes that changed are appended
+     * \return boolean, \a false if the state is invalid or a delta could not
+     * be applied over the values the attributes hold
+     * \see BinaryStateReader, \see QByteArray
+     */
+    bool decodeBinary(const QByteArray &state, QList<Attributes *> &decoded);
+
 private:
     /**
      * Copy constructor
@@ -140,6 +166,13 @@ private:
     inline bool consumeTriple(QStringList &tokens, int &idx, QVector<double> &xs,
                               QVector<double> &ys);
 
+    /**
+     * Applies a column of a delta state to the values of an attribute
+     * \param reader a reader positioned at the column
+     * \param attrib the attribute that receives the values
+     */
+    bool applyDelta(const BinaryStateReader &reader, Attributes *attrib);
+
 	//@RAIAN: Decodifica a vizinhanca
 		/// \author Raian Vargas Maretto
                 inline void consumeNeighborhood(QStringList &tokens, int &idx, QString neighborhoodID, int &numElem, QMap<QString, QList<double> > &neighborhood);
@@ -37,6 +37,7 @@ of this software and its documentation.
 #endif
 
 extern ExecutionModes execModes;
+extern bool HEADLESS;
 
 using namespace TerraMEObserver;
 
@@ -329,7 +330,8 @@ bool AgentObserverMap::decode(QDataStream &in, TypesOfSubjects subject)
         ret = getProtocolDecoder().decode(msg, *attrib->getXsValue(), *attrib->getYsValue());
         // getPainterWidget()->plotMap(attrib);
     }
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
     return ret;
 }
 
@@ -338,6 +340,8 @@ bool AgentObserverMap::draw()
     QList<Attributes *> attribList = getMapAttributes()->values();
     Attributes *attrib = 0;
 
+    QList<Attributes *> layers;
+
     qStableSort(attribList.begin(), attribList.end(), sortAttribByType);
 
     for (int i = 0; i < attribList.size(); i++)
@@ -345,8 +349,9 @@ bool AgentObserverMap::draw()
         attrib = attribList.at(i);
         if ((attrib->getType() != TObsCell)
               && (attrib->getType() != TObsAgent))
-            getPainterWidget()->plotMap(attrib);
+            layers.append(attrib);
     }
+    getPainterWidget()->plotMap(layers);
 
     //static int ss = 1;
     //for (int i = 0; i < attribList.size(); i++)
@@ -37,6 +37,13 @@ class InternalCurve : public QwtPlotCurve
 {
 private:
 	QVector < QPair<int, int>> gaps;
+	QVector < QPair<int, int>> plotGaps; // gaps in the samples sent to the plot
+
+	void appendSample(QVector<double> &xs, QVector<double> &ys, const QVector<double> &axis, int i)
+	{
+		xs.push_back(axis.at(i));
+		ys.push_back(values->at(i));
+	}
 
 public:
     InternalCurve(const QString &name, QwtPlot *plotter)
@@ -60,6 +67,94 @@ public:
 	{
 		values->clear();
 		gaps.clear();
+		plotGaps.clear();
+	}
+
+	// Removes the count oldest values, moving the gaps accordingly
+	void removeFirst(int count)
+	{
+		values->remove(0, qMin(count, values->size()));
+
+		QVector < QPair<int, int>> moved;
+		for (int i = 0; i < gaps.size(); i++)
+		{
+			if (gaps.at(i).second - count >= 0)
+				moved.push_back(QPair<int, int>(qMax(gaps.at(i).first - count, 0), gaps.at(i).second - count));
+		}
+		gaps = moved;
+	}
+
+	// Sends to the plot the values from position from onwards, with their x values
+	// taken from axis. When resolution is positive and there are more values than
+	// resolution, each segment between gaps is split into buckets and only the
+	// minimum and the maximum values of each bucket are sent, keeping the peaks
+	// of the curve with at most resolution points.
+	void updateSamples(const QVector<double> &axis, int from, int resolution)
+	{
+		int size = qMin(axis.size(), values->size());
+		QVector < QPair<int, int>> segments;
+		int start = from;
+
+		for (int i = 0; i < gaps.size(); i++)
+		{
+			if (gaps.at(i).second < from || gaps.at(i).second >= size)
+				continue;
+
+			segments.push_back(QPair<int, int>(qMax(gaps.at(i).first, from), gaps.at(i).second));
+			start = gaps.at(i).second + 1;
+		}
+
+		int closed = segments.size();
+		if (start < size)
+			segments.push_back(QPair<int, int>(start, size - 1));
+
+		int total = size - from;
+		QVector<double> xs, ys;
+		plotGaps.clear();
+
+		for (int s = 0; s < segments.size(); s++)
+		{
+			int a = segments.at(s).first;
+			int length = segments.at(s).second - a + 1;
+			int first = xs.size();
+
+			if (length <= 0)
+				continue;
+			int buckets = length;
+
+			if (resolution > 0 && total > resolution)
+				buckets = qMax(1, (int) ((qint64) resolution / 2 * length / total));
+
+			if (buckets >= length)
+			{
+				for (int i = a; i < a + length; i++)
+					appendSample(xs, ys, axis, i);
+			}
+			else
+			{
+				for (int k = 0; k < buckets; k++)
+				{
+					int low = a + (int) ((qint64) length * k / buckets);
+					int high = a + (int) ((qint64) length * (k + 1) / buckets) - 1;
+					int min = low, max = low;
+
+					for (int i = low + 1; i <= high; i++)
+					{
+						if (values->at(i) < values->at(min)) min = i;
+						if (values->at(i) > values->at(max)) max = i;
+					}
+
+					appendSample(xs, ys, axis, qMin(min, max));
+					if (min != max)
+						appendSample(xs, ys, axis, qMax(min, max));
+				}
+			}
+
+			if (s < closed)
+				plotGaps.push_back(QPair<int, int>(first, xs.size() - 1));
+		}
+
+		setSamples(xs, ys);
 	}
 
 	void insertGap()
@@ -88,7 +183,7 @@ protected:
 		const QwtScaleMap &xMap, const QwtScaleMap &yMap,
 		const QRectF &canvasRect, int from, int to) const
 	{
-		if (gaps.isEmpty())
+		if (plotGaps.isEmpty())
 		{
 			QwtPlotCurve::drawCurve(p, style, xMap, yMap, canvasRect, from, to);
 		}
@@ -96,10 +191,10 @@ protected:
 		{
 			int f, t;
 
-			for (int i = 0; i < gaps.size(); i++)
+			for (int i = 0; i < plotGaps.size(); i++)
 			{
-				f = gaps.at(i).first;
-				t = gaps.at(i).second;
+				f = plotGaps.at(i).first;
+				t = plotGaps.at(i).second;
 				QwtPlotCurve::drawCurve(p, style, xMap, yMap, canvasRect, f, t);
 			}
 
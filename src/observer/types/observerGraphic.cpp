@@ -43,6 +43,7 @@ using namespace std;
 #include "visualArrangement.h"
 
 extern ExecutionModes execModes;
+extern bool HEADLESS;
 
 using namespace TerraMEObserver;
 
@@ -65,6 +66,8 @@ ObserverGraphic::ObserverGraphic(Subject *sub, QWidget *parent)
     paused = false;
     legend = 0;
     xAxisValues = new QVector<double>();
+    capacity = 0;
+    resolution = 0;
     internalCurves = new QMap<QString, InternalCurve*>();
 
     plotter = new ChartPlot(parent);
@@ -171,7 +174,6 @@ bool ObserverGraphic::draw(QDataStream &state)
                     if (observerType == TObsDynamicGraphic)
                     {
                         ord = internalCurves->value(key)->values;
-                        internalCurves->value(key)->setSamples(*abs, *ord);
                     }
                     else
                     {
@@ -202,7 +204,6 @@ bool ObserverGraphic::draw(QDataStream &state)
                     {
                         ord = internalCurves->value(key)->values;
                         abs = xAxisValues;
-                        internalCurves->value(key)->setSamples(*abs, *ord);
                     }
                     else
                     {
@@ -224,19 +225,11 @@ bool ObserverGraphic::draw(QDataStream &state)
         j++;
     }
 
-    if (observerType == TObsGraphic)
-    {
-        InternalCurve *curve = 0;
-
-        for (int i = 0; i < internalCurves->keys().size(); i++)
-        {
-            curve = internalCurves->value(internalCurves->keys().at(i));
-            curve->setSamples(*abs, *internalCurves->value(internalCurves->keys().at(i))->values);
-        }
-    }
+    updateCurves();
     plotter->repaint();
 
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
     return true;
 }
 
@@ -439,6 +432,35 @@ void ObserverGraphic::setModelTime(double time)
         xAxisValues->push_back(time);
 }
 
+void ObserverGraphic::setBuffer(int capacity, int resolution)
+{
+    this->capacity = capacity > 0 ? capacity : 0;
+    this->resolution = resolution > 0 ? resolution : 0;
+}
+
+void ObserverGraphic::updateCurves()
+{
+    // compacta o buffer so' quando ele dobra de tamanho (custo amortizado constante)
+    if (capacity > 0 && xAxisValues->size() > 2 * capacity)
+    {
+        int count = xAxisValues->size() - capacity;
+        xAxisValues->remove(0, count);
+
+        foreach(InternalCurve *curve, internalCurves->values())
+            curve->removeFirst(count);
+    }
+
+    int from = 0;
+    if (capacity > 0 && xAxisValues->size() > capacity)
+        from = xAxisValues->size() - capacity;
+
+    // graficos X vs Y nao sao series temporais e nao sao reduzidos
+    int points = (observerType == TObsDynamicGraphic) ? resolution : 0;
+
+    foreach(InternalCurve *curve, internalCurves->values())
+        curve->updateSamples(*xAxisValues, from, points);
+}
+
 void ObserverGraphic::setCurveStyle()
 {
     foreach(InternalCurve *curve, internalCurves->values())
@@ -460,7 +482,7 @@ void ObserverGraphic::clear()
 	{
 		QString k(internalCurves->keys().at(i));
 		internalCurves->value(k)->clear();
-		internalCurves->value(k)->setSamples(*xAxisValues, *internalCurves->value(k)->values);
+		internalCurves->value(k)->updateSamples(*xAxisValues, 0, 0);
 	}
 }
 
@@ -133,6 +133,16 @@ public:
      */
     void setCurveStyle();
 
+    /**
+     * Bounds the memory and the number of points plotted by the curves
+     * \param capacity maximum number of values kept by each curve, the oldest
+     * values are discarded (zero keeps all the values)
+     * \param resolution maximum number of points sent to the plot by each curve
+     * of a dynamic chart, using the minimum and maximum values of consecutive
+     * intervals (zero sends all the values)
+     */
+    void setBuffer(int capacity, int resolution);
+
     /**
      * Pauses the thread execution
      */
@@ -163,6 +173,12 @@ protected:
     void run();
 
 private:
+    /**
+     * Discards the oldest values when the curves hold twice their capacity
+     * and sends the samples of the curves to the plot
+     */
+    void updateCurves();
+
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
     // double modelTime, lastModelTime;
@@ -175,6 +191,7 @@ private:
     QMap<QString, InternalCurve *> *internalCurves;
 
     QVector<double> *xAxisValues;
+    int capacity, resolution;
 
     bool paused;
 };
@@ -0,0 +1,246 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#include "observerImage.h"
+
+#include <QImage>
+
+#include "observerMap.h"
+#include "../protocol/decoder/decoder.h"
+#include "../components/painter/frameWriter.h"
+
+using namespace TerraMEObserver;
+
+ObserverImage::ObserverImage(Subject *subj) : ObserverInterf(subj)
+{
+    mapAttributes = new QHash<QString, Attributes*>();
+    protocolDecoder = new Decoder(mapAttributes);
+    renderer = new MapRenderer(mapAttributes);
+    legend.setValues(mapAttributes);
+
+    builtLegend = 0;
+
+    width = 0;
+    height = 0;
+    newWidthCellSpace = 0.;
+    newHeightCellSpace = 0.;
+}
+
+ObserverImage::~ObserverImage()
+{
+    delete renderer;
+    delete protocolDecoder;
+
+    foreach(Attributes *attrib, mapAttributes->values())
+        delete attrib;
+    delete mapAttributes;
+}
+
+const TypesOfObservers ObserverImage::getType()
+{
+    return TObsImage;
+}
+
+QStringList ObserverImage::getAttributes()
+{
+    return itemList;
+}
+
+bool ObserverImage::draw(QDataStream &state)
+{
+    bool decoded = false;
+
+    if (getProtocolFormat() == TObsBinaryProtocol)
+    {
+        QByteArray data;
+        state >> data;
+
+        // only the attributes that changed since the last state are plotted
+        QList<Attributes *> changed;
+        decoded = protocolDecoder->decodeBinary(data, changed);
+
+        // the values are out of sync with the subject until it sends a complete state
+        if (!decoded)
+            requestFullState();
+
+        renderer->plotMap(changed);
+    }
+    else
+    {
+        QString msg;
+        state >> msg;
+
+        QList<Attributes *> layers;
+        foreach(Attributes *attrib, mapAttributes->values())
+        {
+            if (attrib->getType() == TObsCell)
+                layers.append(attrib);
+        }
+
+        // the state is tokenized once for all the layers
+        decoded = !layers.isEmpty() && protocolDecoder->decode(msg, layers);
+        if (decoded)
+            renderer->plotMap(layers);
+    }
+
+    // as camadas so sao compostas quando a imagem e salva
+    if (builtLegend < mapAttributes->size())
+    {
+        legend.makeLegend();
+        renderer->replotMap();
+        builtLegend++;
+    }
+
+    return decoded;
+}
+
+void ObserverImage::setAttributes(QStringList &attribs, QStringList legKeys,
+                                  QStringList legAttribs)
+{
+    foreach(const QString & str, attribs)
+    {
+        if (!itemList.contains(str))
+            itemList.append(str);
+    }
+
+    for (int j = 0; (legKeys.size() > 0 && j < LEGEND_KEYS.size()); j++)
+    {
+        if (legKeys.indexOf(LEGEND_KEYS.at(j)) < 0)
+        {
+            qFatal("Error: Parameter legend \"%s\" not found. Please check it in the model.",
+                qPrintable(LEGEND_KEYS.at(j)));
+        }
+    }
+
+    for (int i = 0; i < itemList.size(); i++)
+    {
+        if ((mapAttributes->contains(itemList.at(i)))
+            || (itemList.at(i) == "x") || (itemList.at(i) == "y"))
+            continue;
+
+        Attributes *attrib = new Attributes(itemList.at(i), width * height,
+            newWidthCellSpace, newHeightCellSpace);
+        attrib->setVisible(true);
+
+        if (!legKeys.isEmpty())
+        {
+            int type = legKeys.indexOf(TYPE);
+            int mode = legKeys.indexOf(GROUP_MODE);
+            int slices = legKeys.indexOf(SLICES);
+            int precision = legKeys.indexOf(PRECISION);
+            int stdDeviation = legKeys.indexOf(STD_DEV);
+            int max = legKeys.indexOf(MAX);
+            int min = legKeys.indexOf(MIN);
+            int colorBar = legKeys.indexOf(COLOR_BAR);
+            int font = legKeys.indexOf(FONT_FAMILY);
+            int fontSize = legKeys.indexOf(FONT_SIZE);
+            int symbol = legKeys.indexOf(SYMBOL);
+            int lineWidth = legKeys.indexOf(WIDTH);
+
+            attrib->setDataType((TypesOfData) legAttribs.at(type).toInt());
+            attrib->setGroupMode((GroupingMode) legAttribs.at(mode).toInt());
+            attrib->setSlices(legAttribs.at(slices).toInt() - 1);				// conta com o zero
+            attrib->setPrecisionNumber(legAttribs.at(precision).toInt() - 1);	// conta com o zero
+            attrib->setStdDeviation((StdDev) legAttribs.at(stdDeviation).toInt());
+            attrib->setMaxValue(legAttribs.at(max).toDouble());
+            attrib->setMinValue(legAttribs.at(min).toDouble());
+
+            attrib->setFontFamily(legAttribs.at(font));
+            attrib->setFontSize(legAttribs.at(fontSize).toInt());
+
+            bool ok = false;
+            int asciiCode = legAttribs.at(symbol).toInt(&ok, 10);
+            if (ok)
+                attrib->setSymbol(QString(QChar(asciiCode)));
+            else
+                attrib->setSymbol(legAttribs.at(symbol));
+
+            attrib->setWidth(legAttribs.at(lineWidth).toDouble());
+
+            std::vector<ColorBar> colorBarVec;
+            std::vector<ColorBar> stdColorBarVec;
+            QStringList labelList, valueList;
+
+            ObserverMap::createColorsBar(legAttribs.at(colorBar),
+                colorBarVec, stdColorBarVec, valueList, labelList);
+
+            attrib->setColorBar(colorBarVec);
+            attrib->setStdColorBar(stdColorBarVec);
+            attrib->setValueList(valueList);
+            attrib->setLabelList(labelList);
+
+            for (int j = 0; j < LEGEND_ITENS; j++)
+            {
+                legKeys.removeFirst();
+                legAttribs.removeFirst();
+            }
+        }
+        mapAttributes->insert(itemList.at(i), attrib);
+    }
+}
+
+void ObserverImage::setCellSpaceSize(int w, int h)
+{
+    width = w;
+    height = h;
+    newWidthCellSpace = width * SIZE_CELL;
+    newHeightCellSpace = height * SIZE_CELL;
+
+    renderer->resizeImage(QSize(newWidthCellSpace, newHeightCellSpace));
+}
+
+QSize ObserverImage::frameSize() const
+{
+    QSize size = renderer->getResultSize();
+
+    if ((size.width() > IMAGE_SIZE.width()) || (size.height() > IMAGE_SIZE.height()))
+        size.scale(IMAGE_SIZE, Qt::KeepAspectRatio);
+
+    return size;
+}
+
+void ObserverImage::save(std::string f, std::string e)
+{
+    QString file = QString::fromLocal8Bit(f.c_str());
+    QString format(e.c_str());
+
+    renderer->calculateResult(frameSize());
+
+    // a imagem e' escrita em segundo plano, quem for le-la deve chamar FrameWriter::flush
+    FrameWriter::getInstance().write(renderer->getImage(), file, format);
+}
+
+void ObserverImage::setGridVisible(bool visible)
+{
+    renderer->setGridEnabled(visible);
+}
+
+void ObserverImage::setTitle(const std::string& /*title*/)
+{
+}
+
+int ObserverImage::close()
+{
+    renderer->close();
+    return 0;
+}
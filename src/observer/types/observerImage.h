@@ -0,0 +1,148 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2017 INPE and TerraLAB/UFOP -- www.terrame.org
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this software and its documentation.
+*************************************************************************************/
+
+#ifndef OBSERVER_IMAGE_H
+#define OBSERVER_IMAGE_H
+
+#include "../observerInterf.h"
+
+#include <QHash>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include <string>
+
+#include "../components/legend/legendAttributes.h"
+#include "../components/legend/legendModel.h"
+#include "../components/painter/mapRenderer.h"
+
+namespace TerraMEObserver {
+
+class Decoder;
+
+/**
+ * \brief Draws the attributes of the cells into images, without any widget
+ * It is the Map used when TerraME runs with -headless. It has the same
+ * legend and drawing of the ObserverMap, but it does not have a window,
+ * a layers tree or zoom tools, and it does not draw agents.
+ * \see ObserverInterf, \see ObserverMap
+ * \see MapRenderer, \see LegendModel
+ * \file observerImage.h
+*/
+class ObserverImage : public ObserverInterf
+{
+public:
+    /**
+     * Constructor
+     * \param subj a pointer to a Subject
+     * \see Subject
+     */
+    ObserverImage(Subject *subj);
+
+    /**
+     * Destructor
+     */
+    virtual ~ObserverImage();
+
+    /**
+     * \copydoc Observer::draw
+     */
+    bool draw(QDataStream &state);
+
+    /**
+     * Sets the attributes for observation in the observer
+     * \param attribs a list of attributes under observation
+     * \param legKeys a list of legend keys
+     * \param legAttribs a list of legend attributes
+     * \see QStringList
+     */
+    void setAttributes(QStringList &attribs, QStringList legKeys,
+                       QStringList legAttribs);
+
+    /**
+     * \copydoc Observer::getAttributes
+     */
+    QStringList getAttributes();
+
+    /**
+     * \copydoc Observer::getType
+     */
+    const TypesOfObservers getType();
+
+    /**
+     * Sets the cellular space size
+     * \param width the width of cellular space
+     * \param height the height of cellular space
+     */
+    void setCellSpaceSize(int width, int height);
+
+    /**
+     * Saves the image in a file. The MJPEG format is appended to a video
+     * asynchronously by the FrameWriter, the other formats are written
+     * before returning
+     * \param file the name of the file
+     * \param extension the format of the image in upper case
+     * \see FrameWriter
+     */
+    void save(std::string file, std::string extension);
+
+    /**
+     * Activates the grid draw
+     * \param visible if \a true the grid will be draw. Otherwise, will not draw.
+     */
+    void setGridVisible(bool visible);
+
+    /**
+     * Sets the title of the map. The images do not show it.
+     */
+    void setTitle(const std::string& title);
+
+    /**
+     * Stops the drawing
+     */
+    int close();
+
+private:
+    /**
+     * Gets the size of the saved images: the cellular space size,
+     * reduced to fit in IMAGE_SIZE
+     * \see QSize
+     */
+    QSize frameSize() const;
+
+    QStringList itemList; /// lista de todas as chaves
+    QHash<QString, Attributes*> *mapAttributes;	/// map de todas as chaves
+
+    MapRenderer *renderer;
+    LegendModel legend;
+    Decoder *protocolDecoder;
+    int builtLegend;
+
+    double newWidthCellSpace, newHeightCellSpace;
+    int width, height;
+};
+
+} // namespace TerraMEObserver
+
+#endif // OBSERVER_IMAGE_H
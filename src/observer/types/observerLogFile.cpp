@@ -27,6 +27,26 @@ of this software and its documentation.
 #include <QMessageBox>
 #include <QTextStream>
 
+#include <cstdlib>
+
+extern bool HEADLESS;
+
+// tamanho maximo do buffer de linhas (em bytes) antes de escrever no arquivo
+static const int BUFFER_SIZE = 1 << 20;
+
+// tempo (em milisegundos) depois da ultima escrita a partir do qual uma nova linha
+// descarrega o buffer; nao ha' timer, pois no modo headless os eventos nao sao processados
+static const int FLUSH_INTERVAL = 1000;
+
+// arquivos de log abertos, descarregados no fim do processo
+static QList<ObserverLogFile *> openLogFiles;
+
+static void flushOpenLogFiles()
+{
+    for (int i = 0; i < openLogFiles.size(); i++)
+        openLogFiles.at(i)->flush();
+}
+
 ObserverLogFile::ObserverLogFile() : QObject()
 {
     init();
@@ -41,6 +61,7 @@ ObserverLogFile::ObserverLogFile(Subject *subj)
 ObserverLogFile::~ObserverLogFile()
 {
     // wait();
+    close();
 }
 
 void ObserverLogFile::init()
@@ -51,6 +72,9 @@ void ObserverLogFile::init()
     paused = false;
     header = false;
 
+    flushRows = 1;
+    bufferedRows = 0;
+
     fileName = DEFAULT_NAME + ".csv";
     separator = ";";
 
@@ -113,7 +137,8 @@ bool ObserverLogFile::draw(QDataStream &state)
         j++;
     }
 
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
     return write();
 }
 
@@ -140,13 +165,15 @@ bool ObserverLogFile::headerDefined()
     return header;
 }
 
-bool ObserverLogFile::write()
+bool ObserverLogFile::open()
 {
-    QFile file(fileName);
+    static bool atExitRegistered = false;
+
+    file.setFileName(fileName);
 
     if (mode == QString("w"))
     {
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Unbuffered))
         {
             QMessageBox::information(0, QObject::tr("Erro ao abrir arquivo"),
                                      QObject::tr("N?o foi poss?vel abrir o arquivo de log \"%1\".\n%2")
@@ -164,13 +191,13 @@ bool ObserverLogFile::write()
         }
         header = false;
         headers += "\n";
-        file.write(headers.toLatin1().data(),  qstrlen(headers.toLatin1().data()));
+        buffer.append(headers.toLatin1());
 
         mode = "w+";
     }
     else
     {
-        if (!file.open(QIODevice::Append | QIODevice::Text))
+        if (!file.open(QIODevice::Append | QIODevice::Text | QIODevice::Unbuffered))
         {
             QMessageBox::information(0, QObject::tr("Erro ao abrir arquivo"),
                                      QObject::tr("N?o foi poss?vel abrir o arquivo de log \"%1\".\n%2")
@@ -179,6 +206,22 @@ bool ObserverLogFile::write()
         }
     }
 
+    if (!atExitRegistered)
+    {
+        atexit(flushOpenLogFiles);
+        atExitRegistered = true;
+    }
+    openLogFiles.append(this);
+
+    lastFlush.start();
+    return true;
+}
+
+bool ObserverLogFile::write()
+{
+    if (!file.isOpen() && !open())
+        return false;
+
     QString text;
     for (int i = 0; i < valuesList.size(); ++i)
     {
@@ -188,11 +231,42 @@ bool ObserverLogFile::write()
     }
 
     text.append("\n");
-    file.write(text.toLatin1().data(), qstrlen(text.toLatin1().data()));
-    file.close();
+    buffer.append(text.toLatin1());
+    bufferedRows++;
+
+    if (bufferedRows >= flushRows || buffer.size() >= BUFFER_SIZE
+            || lastFlush.elapsed() >= FLUSH_INTERVAL)
+        flush();
     return true;
 }
 
+void ObserverLogFile::flush()
+{
+    if (!file.isOpen())
+        return;
+
+    if (!buffer.isEmpty())
+    {
+        file.write(buffer);
+        buffer.clear();
+    }
+    bufferedRows = 0;
+    lastFlush.restart();
+
+    // sem buffer o arquivo e' fechado a cada linha, para que possa ser
+    // removido ou movido enquanto o observer existe (Windows)
+    if (flushRows == 1)
+    {
+        file.close();
+        openLogFiles.removeAll(this);
+    }
+}
+
+void ObserverLogFile::setFlushRows(int rows)
+{
+    flushRows = rows > 1 ? rows : 1;
+}
+
 void ObserverLogFile::setWriteMode(QString mode)
 {
     this->mode = mode;
@@ -225,6 +299,12 @@ QStringList ObserverLogFile::getAttributes()
 int ObserverLogFile::close()
 {
     // QThread::exit(0);
+    if (file.isOpen())
+    {
+        flush();
+        file.close();
+        openLogFiles.removeAll(this);
+    }
     return 0;
 }
 
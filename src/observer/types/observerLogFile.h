@@ -30,6 +30,8 @@ of this software and its documentation.
 #include <QString>
 #include <QStringList>
 #include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QThread>
 #include <QCloseEvent>
 
@@ -127,6 +129,23 @@ public:
      */
     QString getWriteMode();
 
+    /**
+     * Sets the number of lines kept in memory before writing them
+     * into the file. Lines are also written when the buffer becomes
+     * large, when a line is added FLUSH_INTERVAL milliseconds after
+     * the last write, and when the observer is closed. With one line
+     * the file is closed after each write; otherwise it stays open
+     * until the observer is closed and cannot be removed or moved
+     * in Windows before that.
+     * \param rows number of lines, values smaller than one are taken as one
+     */
+    void setFlushRows(int rows = 1);
+
+    /**
+     * Writes the lines kept in memory into the file
+     */
+    void flush();
+
     /**
      * Gets the type of observer
      * \see TypesOfObservers
@@ -166,6 +185,12 @@ private:
      */
     bool write();
 
+    /**
+     * Opens the file according to the write mode, writing the header
+     * when the file is created
+     */
+    bool open();
+
 
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
@@ -177,6 +202,11 @@ private:
     //WriteMode mode;
     QString mode;
 
+    QFile file;
+    QByteArray buffer;
+    int flushRows, bufferedRows;
+    QElapsedTimer lastFlush;
+
     bool paused;
 };
 
@@ -37,10 +37,12 @@ of this software and its documentation.
 
 #include "../protocol/decoder/decoder.h"
 #include "visualArrangement.h"
+#include "../components/painter/frameWriter.h"
 #include "core/LuaSystem.h"
 
 ///< Gobal variabel: Lua stack used for comunication with C++ modules.
 extern lua_State * L;
+extern bool HEADLESS;
 
 using namespace TerraMEObserver;
 
@@ -117,33 +119,57 @@ const TypesOfObservers ObserverMap::getType()
 
 void ObserverMap::save(string f, string e)
 {
-	QPixmap pixmap = painterWidget->grab();
-	pixmap.save(QString::fromLocal8Bit(f.c_str()), e.c_str());
+	QString file = QString::fromLocal8Bit(f.c_str());
+	QString format(e.c_str());
+
+	// a imagem e' escrita em segundo plano, quem for le-la deve chamar FrameWriter::flush
+	FrameWriter::getInstance().write(painterWidget->grab().toImage(), file, format);
 }
 
 bool ObserverMap::draw(QDataStream &state)
 {
     bool decoded = false;
-    QString msg;
-    state >> msg;
 
     QList<Attributes *> listAttribs = mapAttributes->values();
     Attributes * attrib = 0;
 
     connectTreeLayerSlot(false);
-    for (int i = 0; i < listAttribs.size(); i++)
+
+    if (getProtocolFormat() == TObsBinaryProtocol)
     {
-        attrib = listAttribs.at(i);
-        if (attrib->getType() == TObsCell)
-        {
-            attrib->clear();
+        QByteArray data;
+        state >> data;
+
+        // only the attributes that changed since the last state are plotted
+        QList<Attributes *> changed;
+        decoded = protocolDecoder->decodeBinary(data, changed);
 
-            decoded = protocolDecoder->decode(msg, *attrib->getXsValue(), *attrib->getYsValue());
-            if (decoded)
-                painterWidget->plotMap(attrib);
+        // the values are out of sync with the subject until it sends a complete state
+        if (!decoded)
+            requestFullState();
+
+        painterWidget->plotMap(changed);
+    }
+    else
+    {
+        QString msg;
+        state >> msg;
+
+        QList<Attributes *> layers;
+        for (int i = 0; i < listAttribs.size(); i++)
+        {
+            attrib = listAttribs.at(i);
+            if (attrib->getType() == TObsCell)
+                layers.append(attrib);
         }
-        qApp->processEvents();
+
+        // the state is tokenized once for all the layers
+        decoded = !layers.isEmpty() && protocolDecoder->decode(msg, layers);
+        if (decoded)
+            painterWidget->plotMap(layers);
     }
+    if (!HEADLESS)
+        qApp->processEvents();
 
     connectTreeLayerSlot(true);
 
@@ -123,7 +123,15 @@ public:
      */
     const QSize getCellSpaceSize();
 
-	void save(string, string);
+    /**
+     * Saves the map in a file. The MJPEG format is appended to a video
+     * asynchronously by the FrameWriter, the other formats are written
+     * before returning
+     * \param file the name of the file
+     * \param extension the format of the image in upper case
+     * \see FrameWriter
+     */
+	void save(string file, string extension);
 
     /**
      * Creates a color bar
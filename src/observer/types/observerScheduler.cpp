@@ -34,6 +34,8 @@ of this software and its documentation.
 
 #include "visualArrangement.h"
 
+extern bool HEADLESS;
+
 using namespace TerraMEObserver;
 
 ObserverScheduler::ObserverScheduler(Subject *s, QWidget *parent)
@@ -203,7 +205,8 @@ bool ObserverScheduler::draw(QDataStream & state)
 
     setTimer(timer);
 
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
 
     return true;
 }
@@ -57,6 +57,8 @@ static const int DIMENSION = 77;
 #include <QGraphicsRectItem>
 #include <QGraphicsSceneDragDropEvent>
 
+extern bool HEADLESS;
+
 //#include <QApplication>
 //#include <time.h>
 //
@@ -200,7 +202,8 @@ bool ObserverStateMachine::draw(QDataStream &state)
     }
 
     scene->update(scene->sceneRect());
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
 
     return true;
 }
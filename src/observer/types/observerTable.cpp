@@ -33,6 +33,8 @@ of this software and its documentation.
 
 #include "visualArrangement.h"
 
+extern bool HEADLESS;
+
 ObserverTable::ObserverTable(Subject *subj, QWidget *parent)
     : QDialog(parent), ObserverInterf(subj), QThread()
 {
@@ -155,7 +157,8 @@ bool ObserverTable::draw(QDataStream &state)
 
     // redimensiona o tamanho da coluna
     tableWidget->resizeColumnToContents(1);
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
     return true;
 }
 
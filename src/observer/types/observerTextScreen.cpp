@@ -28,6 +28,8 @@ of this software and its documentation.
 
 #include "visualArrangement.h"
 
+extern bool HEADLESS;
+
 ObserverTextScreen::ObserverTextScreen(Subject *subj, QWidget *parent)
     : QDialog(parent), ObserverInterf(subj), QThread()
 {
@@ -108,7 +110,8 @@ bool ObserverTextScreen::draw(QDataStream &state)
         j++;
     }
 
-    qApp->processEvents();
+    if (!HEADLESS)
+        qApp->processEvents();
     return write();
 }
 
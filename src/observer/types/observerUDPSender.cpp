@@ -28,12 +28,14 @@ of this software and its documentation.
 #include <QApplication>
 #include <QLabel>
 #include <QList>
+#include <QtEndian>
 #include "terrameGlobals.h"
 
 ///< Gobal variabel: Lua stack used for comunication with C++ modules.
 extern lua_State * L;
 
 extern ExecutionModes execModes;
+extern bool HEADLESS;
 
 // Debug method for check state data
 void saveInFile(QString & msg);
@@ -41,6 +43,8 @@ void saveInFile(QString & msg);
 // Datagram default size
 static const int MINIMUM_DATAGRAM_SIZE = 1024;
 static const int COMPRESS_RATIO = 6;
+// Taxa de envio padrao: 100 Mbit/s
+static const int DEFAULT_SEND_RATE = 100 * 1024 * 1024 / 8;
 
 ObserverUDPSender::ObserverUDPSender()
     : QThread()
@@ -86,6 +90,9 @@ void ObserverUDPSender::init()
     datagramSize = MINIMUM_DATAGRAM_SIZE * datagramRatio;
     stateCount = 0;
     msgCount = 0;
+    sequence = 0;
+    sendRate = DEFAULT_SEND_RATE;
+    pacedBytes = 0;
 
     udpSocket = new QUdpSocket();
     hosts = new QList<QHostAddress>();
@@ -132,7 +139,8 @@ bool ObserverUDPSender::draw(QDataStream &state)
 			terrame::lua::LuaSystem::getInstance().getLuaApi()->callWarning(L, str.toLatin1().constData());
 		}
 	}
-	qApp->processEvents();
+	if (!HEADLESS)
+		qApp->processEvents();
 	return true;
 }
 
@@ -166,96 +174,108 @@ void ObserverUDPSender::setAttributes(QStringList& attribs)
 
 bool ObserverUDPSender::sendDatagram(QString& msg)
 {
-    QByteArray data(msg.toLatin1().constData(), msg.size());
+    // serializa o estado uma unica vez em um buffer reutilizado
+    int size = msg.size();
+    stateBuffer.resize(size);
+    const QChar *chars = msg.constData();
+    char *out = stateBuffer.data();
+    for (int i = 0; i < size; i++)
+        out[i] = chars[i].toLatin1();
+
+    // o estado e comprimido inteiro, e nao cada fragmento
+    const QByteArray *data = &stateBuffer;
+    if (compressDatagram)
+    {
+        compressedBuffer = qCompress(stateBuffer, COMPRESS_RATIO);
+        data = &compressedBuffer;
+    }
+
+    quint32 fragments = qMax(1, (data->size() + datagramSize - 1) / datagramSize);
 
-    qint64 bytesWritten = 0, bytesRead = data.size();
-    int pos = 0;
+    pacedBytes = 0;
+    pacingTimer.restart();
 
-    while (bytesRead > 0)
+    for (quint32 fragment = 0; fragment < fragments; fragment++)
     {
-        QByteArray datagram;
+        int pos = fragment * datagramSize;
+        int length = qMin(datagramSize, data->size() - pos);
 
-        QDataStream out(&datagram, QIODevice::WriteOnly);
-        out.setVersion(QDataStream::Qt_4_6);
+        datagram.resize(UDP_HEADER_SIZE + length);
+        writeHeader(fragment, fragments, pos, data->size(), compressDatagram);
+        memcpy(datagram.data() + UDP_HEADER_SIZE, data->constData() + pos, length);
 
-        out <<(qint64) data.size();
-        out <<(qint64) datagramSize;
-        out <<(qint64) pos;
-        out << compressDatagram; // flag formato do datagrama transmitido
+        if (!writeToHosts())
+            return false;
 
-        if (compressDatagram)
-        {
-            out << qCompress(data.mid(pos, datagramSize), COMPRESS_RATIO);
-        }
-        else
-        {
-            out << data.mid(pos, datagramSize);
-        }
+        msgCount++;
+    }
 
-        for (int i = 0; i < hosts->size(); i++)
-        {
-            bytesWritten = udpSocket->writeDatagram(datagram, hosts->at(i), port);
+    sequence++;
+    stateCount++;
 
-            udpSocket->flush();
+    udpGUI->setMessagesSent(msgCount);
+    udpGUI->setStateSent(stateCount);
 
-            udpGUI->appendMessage(QLabel::tr("Datagram sent for %1").arg(hosts->at(i).toString()));
+    udpGUI->appendMessage(tr("State %1 sent in %2 datagrams of %3 bytes.\n")
+        .arg(stateCount).arg(fragments).arg(datagramSize));
 
-            if (bytesWritten == -1)
-            {
-                QString error;
-                error = tr("Warning: Failed on send message. Socket Error: %1")
-                    .arg(udpSocket->errorString());
-                udpGUI->appendMessage(error);
+    return true;
+}
+
+void ObserverUDPSender::writeHeader(quint32 fragment, quint32 fragments, quint32 pos,
+                                    quint32 size, bool compressed)
+{
+    uchar *header = (uchar *) datagram.data();
+    quint32 version = UDP_PROTOCOL_VERSION;
+    if (compressed)
+        version |= UDP_COMPRESSED_FLAG;
+
+    qToBigEndian<quint32>(UDP_PROTOCOL_MAGIC, header);
+    qToBigEndian<quint32>(version, header + 4);
+    qToBigEndian<quint32>(sequence, header + 8);
+    qToBigEndian<quint32>(fragment, header + 12);
+    qToBigEndian<quint32>(fragments, header + 16);
+    qToBigEndian<quint32>(pos, header + 20);
+    qToBigEndian<quint32>(size, header + 24);
+}
+
+bool ObserverUDPSender::writeToHosts()
+{
+    // enderecos multicast ou broadcast recebem uma unica escrita
+    for (int i = 0; i < hosts->size(); i++)
+    {
+        if (udpSocket->writeDatagram(datagram, hosts->at(i), port) == -1)
+        {
+            QString error;
+            error = tr("Warning: Failed on send message. Socket Error: %1")
+                .arg(udpSocket->errorString());
+            udpGUI->appendMessage(error);
 
 #ifdef TME_LUA_5_2
-                if (execModes != Quiet)
-				{
-					terrame::lua::LuaSystem::getInstance().getLuaApi()->callWarning(L, error.toLatin1().constData());
-                }
+            if (execModes != Quiet)
+			{
+				terrame::lua::LuaSystem::getInstance().getLuaApi()->callWarning(L, error.toLatin1().constData());
+            }
 #else
 
-                if (execModes != Quiet){
-                    qWarning("%s", qPrintable(error));
-                }
+            if (execModes != Quiet){
+                qWarning("%s", qPrintable(error));
+            }
 #endif
 
-                return false;
-            }
+            return false;
         }
 
-        if (compressDatagram)
+        // controla a taxa de envio no lugar do processEvents a cada fragmento
+        pacedBytes += datagram.size();
+        if (sendRate > 0)
         {
-            bytesRead -= datagramSize;
-            pos += datagramSize;
+            qint64 due = pacedBytes * 1000000 / sendRate;
+            qint64 elapsed = pacingTimer.nsecsElapsed() / 1000;
+            if (due > elapsed)
+                QThread::usleep(due - elapsed);
         }
-        else
-        {
-            bytesRead -= bytesWritten;
-            pos += bytesWritten;
-        }
-        msgCount++;
-
-        // faz um pausa antes de continuar a enviar
-        // delay((float) 0.01); // 0.0125);
-        // delay((float) 0.0125);
-        qApp->processEvents();
     }
-
-    completeState(COMPLETE_STATE.toLatin1());
-
-    msgCount++;
-    stateCount++;
-
-    udpGUI->setMessagesSent(msgCount);
-    udpGUI->setStateSent(stateCount);
-
-    //udpGUI->appendMessage(tr("compressionSum: %1 / %2 = %3")
-    //    .arg(compressionSum).arg(compressionCount).arg(compressionSum / compressionCount));
-    //udpGUI->appendMessage(tr("renderingSum: %1 / %2 = %3")
-    //    .arg(renderingSum).arg(renderingCount).arg(renderingSum / renderingCount));
-
-    udpGUI->appendMessage(tr("States sent: %1.\n").arg(stateCount));
-
     return true;
 }
 
@@ -294,34 +314,23 @@ bool ObserverUDPSender::getCompressDatagram()
     return compressDatagram;
 }
 
-bool ObserverUDPSender::completeState(const QByteArray & flag)
+void ObserverUDPSender::setSendRate(int bytesPerSecond)
 {
-    qint64 bytesWritten = 0;
-    QByteArray datagram, data;
-    data = QByteArray(flag);
-
-    QDataStream out(&datagram, QIODevice::WriteOnly);
-    // out.setVersion(QDataStream::Qt_4_6);
-
-    out <<(qint64) data.size();
-    out <<(qint64) datagramSize;
-    out <<(qint64) -1;
-    out << compressDatagram;
+    sendRate = bytesPerSecond > 0 ? bytesPerSecond : 0;
+}
 
-    if (compressDatagram)
-       out << qCompress(data, 1);
-    else
-        out << data;
+int ObserverUDPSender::getSendRate()
+{
+    return sendRate;
+}
 
-    for (int i = 0; i < hosts->size(); i++)
-    {
-        bytesWritten = udpSocket->writeDatagram(datagram, hosts->at(i), port);
-        udpSocket->flush();
+bool ObserverUDPSender::completeState(const QByteArray & flag)
+{
+    datagram.resize(UDP_HEADER_SIZE + flag.size());
+    writeHeader(0, 0, 0, flag.size(), false);
+    memcpy(datagram.data() + UDP_HEADER_SIZE, flag.constData(), flag.size());
 
-        if (bytesWritten == -1)
-            return false;
-    }
-    return true;
+    return writeToHosts();
 }
 
 void ObserverUDPSender::setModelTime(double time)
@@ -36,6 +36,7 @@ extern "C"
 #include <QDialog>
 #include <QThread>
 #include <QHostAddress>
+#include <QElapsedTimer>
 
 class QUdpSocket;
 
@@ -137,6 +138,20 @@ public:
      */
     void addHost(const QString & host);
 
+    /**
+     * Sets the maximum rate used to send the datagrams. The sender
+     * sleeps between datagrams instead of flooding the network
+     * \param bytesPerSecond the rate in bytes per second, zero
+     * sends as fast as possible
+     */
+    void setSendRate(int bytesPerSecond);
+
+    /**
+     * Gets the maximum rate used to send the datagrams
+     * \see setSendRate
+     */
+    int getSendRate();
+
 protected:
     /**
      * Runs the thread
@@ -156,7 +171,9 @@ private:
     void init();
 
     /**
-     * Sends the datagram
+     * Sends the state. It is serialized and compressed once and then
+     * split in fragments with a header that allows the receiver to
+     * reassemble it even when the datagrams arrive out of order
      * \param msg a reference to the datagram composes of the subject internal state
      * \return boolean, \a true if the datagram could be sent.
      * Otherwise, returns \a false.
@@ -164,7 +181,7 @@ private:
     bool sendDatagram(QString & msg);
 
     /**
-     *  Sends the informations that indicates that complete state was sent
+     *  Sends a control message, without fragments, such as the end of the simulation
      * \param flag a reference to the QByteArray \a flag
      * \return boolean, \a true if the complete state could be sent.
      * Otherwise, returns \a false.
@@ -172,6 +189,23 @@ private:
      */
     bool completeState(const QByteArray &flag);
 
+    /**
+     * Writes the header in the beginning of the datagram buffer
+     * \param fragment the index of the fragment
+     * \param fragments the number of fragments of the state
+     * \param pos the position of the fragment in the state
+     * \param size the size of the state
+     * \param compressed whether the state is compressed
+     */
+    void writeHeader(quint32 fragment, quint32 fragments, quint32 pos, quint32 size, bool compressed);
+
+    /**
+     * Writes the datagram buffer to all the hosts, respecting the send rate
+     * \return boolean, \a true if the datagram could be sent to all hosts.
+     * Otherwise, returns \a false.
+     */
+    bool writeToHosts();
+
     TypesOfObservers observerType;
     TypesOfSubjects subjectType;
 
@@ -182,6 +216,12 @@ private:
 
     QUdpSocket *udpSocket;
 
+    QByteArray stateBuffer, compressedBuffer, datagram;
+    quint32 sequence;
+    int sendRate;
+    qint64 pacedBytes;
+    QElapsedTimer pacingTimer;
+
     QStringList attribList;
 
     UdpSenderGUI *udpGUI;
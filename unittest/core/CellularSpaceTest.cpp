@@ -147,3 +147,142 @@ TEST_F(CellularSpaceTest, SynchronizeWithoutCells)
 {
 	cs->synchronize(sizeof(multimapComposite<CellIndex, Cell* >));
 }
+
+TEST_F(CellularSpaceTest, GetCellFromGrid)
+{
+	cs->setGrid(0, 0, 3, 2);
+
+	Cell *c = new Cell();
+	CellIndex cidx;
+	cidx.first = 2;
+	cidx.second = 1;
+
+	cs->add(cidx, c);
+	addCell(0, 0);
+
+	ASSERT_EQ(cs->size(), 2);
+	ASSERT_EQ(cs->getCell(cidx), c);
+
+	cidx.first = 1;
+	ASSERT_TRUE(cs->getCell(cidx) == NULL);
+}
+
+TEST_F(CellularSpaceTest, GetCellAddedBeforeGrid)
+{
+	Cell *c = new Cell();
+	CellIndex cidx;
+	cidx.first = 1;
+	cidx.second = 1;
+
+	cs->add(cidx, c);
+	cs->setGrid(0, 0, 2, 2);
+
+	ASSERT_EQ(cs->getCell(cidx), c);
+}
+
+TEST_F(CellularSpaceTest, GetCellOutsideGrid)
+{
+	cs->setGrid(0, 0, 2, 2);
+
+	Cell *c = new Cell();
+	CellIndex cidx;
+	cidx.first = 5;
+	cidx.second = -1;
+
+	cs->add(cidx, c);
+
+	ASSERT_EQ(cs->getCell(cidx), c);
+}
+
+TEST_F(CellularSpaceTest, EraseAndClearGrid)
+{
+	cs->setGrid(0, 0, 2, 2);
+	addCell(0, 1);
+	addCell(1, 1);
+
+	CellIndex cidx;
+	cidx.first = 0;
+	cidx.second = 1;
+
+	ASSERT_TRUE(cs->erase(cidx));
+	ASSERT_TRUE(cs->getCell(cidx) == NULL);
+
+	cs->clear();
+	cidx.first = 1;
+
+	ASSERT_EQ(cs->size(), 0);
+	ASSERT_TRUE(cs->getCell(cidx) == NULL);
+}
+
+TEST_F(CellularSpaceTest, EraseFromRegionUpdatesGrid)
+{
+	cs->setGrid(0, 0, 2, 2);
+	addCell(0, 0);
+	addCell(1, 0);
+	addCell(0, 1);
+	addCell(1, 1);
+
+	ASSERT_TRUE(cs->isDense());
+
+	CellIndex cidx;
+	cidx.first = 1;
+	cidx.second = 0;
+
+	Region_<CellIndex>* region = cs;
+	ASSERT_TRUE(region->erase(cidx));
+	ASSERT_TRUE(cs->getCell(cidx) == NULL);
+	ASSERT_TRUE(cs->isDense());
+
+	region->erase(region->begin());
+	cidx.first = 0;
+	ASSERT_TRUE(cs->getCell(cidx) == NULL);
+	ASSERT_EQ(cs->size(), 2);
+	ASSERT_TRUE(cs->isDense());
+}
+
+TEST_F(CellularSpaceTest, BuildStencilNeighborhood)
+{
+	cs->setGrid(0, 0, 3, 3);
+
+	std::vector<int> dxs, dys;
+	dxs.push_back(-1); dys.push_back(0);
+	dxs.push_back(1);  dys.push_back(0);
+	dxs.push_back(0);  dys.push_back(-1);
+	dxs.push_back(0);  dys.push_back(1);
+
+	std::vector<int> first, neighbors;
+	std::vector<double> weights;
+
+	cs->buildStencilNeighborhood(dxs, dys, false, true, first, neighbors, weights);
+
+	ASSERT_EQ(first.size(), 10u);
+	ASSERT_EQ(first[1] - first[0], 2);  //< corner (0, 0)
+	ASSERT_EQ(first[5] - first[4], 4);  //< center (1, 1)
+	ASSERT_EQ(neighbors[first[4]], 1);  //< (0, 1)
+	ASSERT_DOUBLE_EQ(weights[0], 0.5);
+	ASSERT_DOUBLE_EQ(weights[4], 0.25);
+
+	cs->buildStencilNeighborhood(dxs, dys, true, false, first, neighbors, weights);
+
+	ASSERT_EQ(first[9], 36);
+	ASSERT_EQ(neighbors[first[0]], 6);  //< (2, 0)
+	ASSERT_DOUBLE_EQ(weights[0], 1.0);
+}
+
+TEST_F(CellularSpaceTest, BuildStencilNeighborhoodWithRepeatedNeighbors)
+{
+	cs->setGrid(0, 0, 2, 1);
+
+	std::vector<int> dxs, dys;
+	dxs.push_back(-1); dys.push_back(0);
+	dxs.push_back(1);  dys.push_back(0);
+
+	std::vector<int> first, neighbors;
+	std::vector<double> weights;
+
+	cs->buildStencilNeighborhood(dxs, dys, true, true, first, neighbors, weights);
+
+	ASSERT_EQ(first[1] - first[0], 1);
+	ASSERT_EQ(neighbors[first[0]], 1);
+	ASSERT_DOUBLE_EQ(weights[0], 0.5);
+}
@@ -0,0 +1,103 @@
+/************************************************************************************
+TerraME - a software platform for multiple scale spatially-explicit dynamic modeling.
+Copyright (C) 2001-2008 INPE and TerraLAB/UFOP.
+
+This code is part of the TerraME framework.
+This framework is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library.
+
+The authors reassure the license terms regarding the warranties.
+They specifically disclaim any warranties, including, but not limited to,
+the implied warranties of merchantability and fitness for a particular purpose.
+The framework provided hereunder is on an "as is" basis, and the authors have no
+obligation to provide maintenance, support, updates, enhancements, or modifications.
+In no event shall INPE and TerraLAB / UFOP be held liable to any party for direct,
+indirect, special, incidental, or consequential damages arising out of the use
+of this library and its documentation.
+*************************************************************************************/
+
+#include "NeighborhoodTest.h"
+
+#include "core/neighborhood.h"
+
+void NeighborhoodTest::SetUp()
+{
+	n = new CellNeighborhood();
+}
+
+void NeighborhoodTest::TearDown()
+{
+	n->clear();
+	delete n;
+}
+
+TEST_F(NeighborhoodTest, AddAndGetWeight)
+{
+	Cell *c1 = new Cell();
+	Cell *c2 = new Cell();
+	CellIndex cidx1(0, 1);
+	CellIndex cidx2(1, 0);
+
+	n->add(cidx1, c1, 0.25);
+	n->add(cidx2, c2, 0.75);
+
+	ASSERT_EQ(n->size(), 2);
+	ASSERT_EQ(n->getNeighbor(cidx1), c1);
+	ASSERT_EQ((*n)[cidx2], c2);
+	ASSERT_DOUBLE_EQ(n->getWeight(cidx1), 0.25);
+	ASSERT_DOUBLE_EQ(n->getWeight(cidx2), 0.75);
+
+	n->setWeight(cidx1, 0.5);
+	ASSERT_DOUBLE_EQ(n->getWeight(cidx1), 0.5);
+
+	delete c1;
+	delete c2;
+}
+
+TEST_F(NeighborhoodTest, AddSameIndex)
+{
+	Cell *c1 = new Cell();
+	Cell *c2 = new Cell();
+	CellIndex cidx(0, 0);
+
+	n->add(cidx, c1, 0.25);
+	n->add(cidx, c2, 0.75);
+
+	ASSERT_EQ(n->size(), 1);
+	ASSERT_EQ(n->getNeighbor(cidx), c1);
+	ASSERT_DOUBLE_EQ(n->getWeight(cidx), 0.25);
+
+	delete c1;
+	delete c2;
+}
+
+TEST_F(NeighborhoodTest, EraseKeepsOrder)
+{
+	Cell *c = new Cell();
+	CellIndex cidx1(0, 0);
+	CellIndex cidx2(0, 1);
+	CellIndex cidx3(0, 2);
+
+	n->add(cidx1, c, 1);
+	n->add(cidx2, c, 2);
+	n->add(cidx3, c, 3);
+
+	ASSERT_TRUE(n->erase(cidx1));
+	ASSERT_FALSE(n->erase(cidx1));
+	ASSERT_EQ(n->size(), 2);
+
+	CellNeighborhood::iterator it = n->begin();
+	ASSERT_EQ(it->first, cidx2);
+	it++;
+	ASSERT_EQ(it->first, cidx3);
+	ASSERT_TRUE(n->find(cidx1) == n->end());
+	ASSERT_TRUE(n->find(cidx3) == it);
+	ASSERT_DOUBLE_EQ(n->getWeight(cidx3), 3);
+
+	delete c;
+}